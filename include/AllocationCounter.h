@@ -0,0 +1,75 @@
+// The AllocationCounter counts heap allocations, in total and per subsystem, so
+// tests and benchmarks can see what allocates (and check that a steady-state
+// game tick and frame don't allocate at all).
+//
+// It replaces the global operator new & delete (see AllocationCounter.cpp), so
+// every allocation in the program goes through it.  Counting is off until
+// setEnabled(true): while it is off, new only costs a relaxed atomic load more
+// than malloc().
+//
+// Code says which subsystem it is running with an AllocationScope:
+//     AllocationScope scope("render");
+// and the allocations made on that thread until the scope ends are counted
+// against "render" (the innermost scope wins; allocations outside every scope
+// are counted against "other").  For per frame counts, reset() once a frame, or
+// take getCount() before & after.
+// The allocation-free frame is the GameView draw list & the SoftwareRenderer
+// (which testAllocationCounter checks).  The SFML frame (SfmlDrawListRenderer)
+// is allowed to allocate when the score changes: sf::Text::setString() builds
+// a new sf::String & glyph geometry, and new glyphs may grow the font's page.
+// It isn't checked by the tests because they run before there is a window, so
+// without a GL context to draw into.
+// Over-aligned allocations (eg: of an SpscQueue) use the standard library's own
+// aligned operator new, and aren't counted.
+//
+//  [expected .cpp size: ~ 150 lines]
+
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <cstdint>
+
+class AllocationCounter
+{
+public:
+	// STATIC CONSTANTS
+	static const int MAX_SUBSYSTEMS = 16;		// subsystems counted separately (the rest count as "other")
+
+	// MEMBER FUNCTIONS (all static: there is one heap)
+
+	// start/stop counting (the counts are kept)
+	static void setEnabled(bool enabled);
+	static bool isEnabled();
+
+	// allocations counted since the last reset()
+	static std::uint64_t getCount();
+	// allocations counted against a subsystem since the last reset()
+	static std::uint64_t getCount(const char *subsystem);
+
+	// the subsystems counted since the last reset(): up to maxSubsystems names
+	//   & counts.  return how many were written
+	static int getSubsystemCounts(const char **names, std::uint64_t *counts, int maxSubsystems);
+
+	// zero every count (call it while no other thread is allocating)
+	static void reset();
+
+	// count an allocation on the calling thread (called by operator new, when enabled)
+	static void recordAllocation();
+};
+
+// counts the calling thread's allocations against subsystem (a string literal)
+//   until it is destroyed
+class AllocationScope
+{
+public:
+	explicit AllocationScope(const char *subsystem);
+	~AllocationScope();
+
+	AllocationScope(const AllocationScope&) = delete;
+	AllocationScope& operator=(const AllocationScope&) = delete;
+
+private:
+	const char *previous;		// the scope this one is inside (restored when it ends)
+};
+
+#endif /* ALLOCATIONCOUNTER_H */
@@ -0,0 +1,136 @@
+// An AssetArchive is every asset packed into one file (by the assetpack tool:
+// make pack), which the game maps into memory instead of opening and decoding
+// each file in assets/.
+//
+// Images are stored pre-decoded, as RGBA pixels, so startup doesn't decode
+// PNGs; everything else (fonts, sounds, music) is stored as the file's bytes.
+// open() maps the whole archive (mmap, or a file mapping on Windows) and reads
+// its index; find() then returns a view straight into the mapping, which can
+// be handed to SFML (loadFromMemory(), or a texture update()) without another
+// copy.  The views are valid until the archive is closed or destroyed.
+//
+// The file (little endian, written by AssetArchiveWriter):
+//   header: "TETRPAK1", u32 entry count, u32 index size (bytes)
+//   index:  per entry: u32 name length, u32 format, u32 width, u32 height,
+//           u64 data offset, u64 data size, then the name (eg: "assets/images/tiles.png")
+//   data:   each entry's bytes, at DATA_ALIGNMENT aligned offsets
+// open() checks every offset & size against the file, so a truncated or
+// corrupt archive fails to open rather than being read out of bounds.
+//
+//  [expected .cpp size: ~ 250 lines]
+
+#ifndef ASSETARCHIVE_H
+#define ASSETARCHIVE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// how an asset's bytes are stored
+enum AssetFormat : std::uint32_t {
+	ASSET_FILE = 0,		// the file's bytes, as they are on disk
+	ASSET_RGBA = 1		// decoded pixels: width * height * 4 bytes, row by row
+};
+
+// an asset in an archive (data is nullptr if it wasn't found)
+struct AssetView
+{
+	const unsigned char *data = nullptr;
+	std::size_t size = 0;
+	AssetFormat format = ASSET_FILE;
+	unsigned width = 0;			// ASSET_RGBA only
+	unsigned height = 0;
+};
+
+class AssetArchive
+{
+public:
+	// STATIC CONSTANTS
+	static const char MAGIC[9];													// "TETRPAK1" (the first 8 bytes of the file)
+	static const std::size_t HEADER_SIZE = 16;
+	static const std::size_t ENTRY_SIZE = 32;						// an index entry, without its name
+	static const std::size_t DATA_ALIGNMENT = 16;
+
+	// MEMBER FUNCTIONS
+
+	AssetArchive() = default;
+
+	// destructor: close()
+	~AssetArchive();
+
+	AssetArchive(const AssetArchive&) = delete;
+	AssetArchive& operator=(const AssetArchive&) = delete;
+
+	// map the archive at path & read its index (closing any open one)
+	//   return false if it is missing or malformed
+	bool open(const std::string &path);
+
+	// read the index of an archive already in memory (eg: AssetArchiveWriter::
+	//   toBytes(), or one embedded in the executable), closing any open one
+	//   The bytes aren't copied: they must outlive the archive (or its close()).
+	//   return false if it is malformed
+	bool openMemory(const void *data, std::size_t size);
+
+	// unmap the archive (every view from find() becomes invalid)
+	void close();
+
+	bool isOpen() const;
+
+	// the asset called name (eg: "assets/images/tiles.png")
+	//   (data is nullptr if there is none)
+	AssetView find(const std::string &name) const;
+
+	// the names of every asset in the archive
+	std::vector<std::string> getNames() const;
+
+	// the size of the mapped file, in bytes
+	std::size_t getSize() const;
+
+private:
+	// read the index of the mapped file into entries
+	//   return false if it is malformed
+	bool readIndex();
+
+	// MEMBER VARIABLES
+	const unsigned char *mapped = nullptr;			// the whole file (nullptr if not open)
+	std::size_t mappedSize = 0;
+	bool borrowed = false;											// mapped is the caller's memory (openMemory())
+#ifdef _WIN32
+	void *file = nullptr;												// the file & mapping HANDLEs
+	void *mapping = nullptr;
+#endif
+	std::map<std::string, AssetView> entries;		// views into mapped
+};
+
+// builds an archive for AssetArchive::open() (used by the assetpack tool)
+class AssetArchiveWriter
+{
+public:
+	// add an asset (the bytes are copied)
+	void add(const std::string &name, const void *data, std::size_t size, AssetFormat format = ASSET_FILE,
+		unsigned width = 0, unsigned height = 0);
+
+	// the archive's bytes
+	std::vector<unsigned char> toBytes() const;
+
+	// write the archive to path
+	//   return false if it couldn't be written
+	bool write(const std::string &path) const;
+
+private:
+	struct Entry
+	{
+		std::string name;
+		std::vector<unsigned char> data;
+		AssetFormat format;
+		unsigned width;
+		unsigned height;
+	};
+
+	// MEMBER VARIABLES
+	std::vector<Entry> entries;
+};
+
+#endif /* ASSETARCHIVE_H */
@@ -0,0 +1,156 @@
+// An AssetTable loads each asset (of one type) once, by path, and shares it.
+//
+// get() hands out shared_ptrs, so an asset is shared by everything that uses it
+// (every game in the process) and is only loaded the first time it is asked
+// for.  The table keeps its own reference, so an asset stays loaded between
+// users; purge() drops the ones nobody else holds.
+//
+// It is safe to use from several threads: loading happens outside the lock,
+// and a thread that asks for an asset another thread is loading waits for it
+// instead of loading it again.  So a background thread can preload what the
+// main thread will ask for.  Entries are held by shared_ptr, so erase() and
+// purge() may drop an entry that waiting threads still read the result from.
+// A failed load is remembered (get() keeps returning nullptr, without
+// retrying), and listed by getFailures(), so failures aren't silently ignored.
+//
+// The loader is any bool(T&, const std::string &path) (eg: a lambda calling
+// sf::Font::loadFromFile()).
+
+#ifndef ASSETTABLE_H
+#define ASSETTABLE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+template <typename T>
+class AssetTable
+{
+public:
+	typedef std::function<bool(T &asset, const std::string &path)> Loader;
+
+	// MEMBER FUNCTIONS
+
+	explicit AssetTable(Loader loader)
+	:loader(loader)
+	{
+	}
+
+	// the asset at path, loaded on first use (waiting if another thread is loading it)
+	//   nullptr if it failed to load
+	std::shared_ptr<T> get(const std::string &path)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		typename std::map<std::string, std::shared_ptr<Entry>>::iterator found = entries.find(path);
+		if (found != entries.end())
+		{
+			// hold the entry itself: it may be erased (or purged) between the
+			//   load finishing and this thread getting the lock back
+			std::shared_ptr<Entry> entry = found->second;
+			loadDone.wait(lock, [&]() { return !entry->loading; });
+			return entry->asset;
+		}
+
+		// load it ourselves (others asking meanwhile wait for us)
+		std::shared_ptr<Entry> entry = std::make_shared<Entry>();
+		entry->loading = true;
+		entries[path] = entry;
+		loads++;
+		lock.unlock();
+		std::shared_ptr<T> asset = std::make_shared<T>();
+		bool loaded = loader(*asset, path);
+		lock.lock();
+
+		entry->loading = false;
+		entry->asset = loaded ? asset : nullptr;
+		if (!loaded)
+		{
+			failures.push_back(path);
+		}
+		loadDone.notify_all();
+		return entry->asset;
+	}
+
+	// has path been loaded (or failed to)?
+	bool contains(const std::string &path) const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		typename std::map<std::string, std::shared_ptr<Entry>>::const_iterator found = entries.find(path);
+		return found != entries.end() && !found->second->loading;
+	}
+
+	// forget path (users keep their references; the next get() loads it again)
+	void erase(const std::string &path)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		typename std::map<std::string, std::shared_ptr<Entry>>::iterator found = entries.find(path);
+		if (found != entries.end() && !found->second->loading)
+		{
+			entries.erase(found);
+		}
+	}
+
+	// drop the loaded assets that nothing but the table holds
+	//   return how many were dropped
+	int purge()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		int dropped = 0;
+		for (typename std::map<std::string, std::shared_ptr<Entry>>::iterator i = entries.begin(); i != entries.end(); )
+		{
+			if (!i->second->loading && i->second->asset != nullptr && i->second->asset.use_count() == 1)
+			{
+				i = entries.erase(i);
+				dropped++;
+			}
+			else
+			{
+				++i;
+			}
+		}
+		return dropped;
+	}
+
+	// the number of assets held (loaded, loading or failed)
+	std::size_t size() const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return entries.size();
+	}
+
+	// the number of times the loader has run
+	unsigned getLoads() const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return loads;
+	}
+
+	// the paths that failed to load
+	std::vector<std::string> getFailures() const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return failures;
+	}
+
+private:
+	struct Entry
+	{
+		std::shared_ptr<T> asset;		// nullptr while loading, or if it failed
+		bool loading = false;
+	};
+
+	// MEMBER VARIABLES
+	Loader loader;
+	mutable std::mutex mutex;									// guards everything below
+	std::condition_variable loadDone;					// signalled when a load finishes
+	std::map<std::string, std::shared_ptr<Entry>> entries;	// shared with the threads waiting on a load
+	std::vector<std::string> failures;
+	unsigned loads = 0;
+};
+
+#endif /* ASSETTABLE_H */
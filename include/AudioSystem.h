@@ -0,0 +1,126 @@
+// The AudioSystem plays the sound effects & the background music.
+//
+// Everything is loaded once, up front, by load(): each effect (assets/sfx/*.ogg)
+// is decoded into an sf::SoundBuffer (shared through the ResourceCache, so
+// several AudioSystems share one copy), and the music is opened for streaming
+// (sf::Music decodes it a bit at a time on SFML's own thread).  So playing a
+// sound never reads the disk.
+//
+// The game never calls SFML's audio itself: it post()s AudioCommands to a
+// lock-free SpscQueue, and the AudioSystem's own thread carries them out.  So
+// triggering a sound never blocks the game loop (if the queue is ever full, the
+// command is dropped and counted).  Only one thread (the game loop) may post.
+//
+// Effects play on a fixed pool of VOICE_COUNT sf::Sounds.  When every voice is
+// busy, the one that started longest ago is cut off and reused ("voice
+// stealing"), so a burst of effects never needs more voices.
+//
+//  [expected .cpp size: ~ 200 lines]
+
+#ifndef AUDIOSYSTEM_H
+#define AUDIOSYSTEM_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <SFML/Audio.hpp>
+#include "ResourceCache.h"
+#include "SpscQueue.h"
+#include "TetrisEngine.h"
+
+// the sound effects (assets/sfx)
+enum SoundEffect {
+	SOUND_BLOCK_DROP,		// blockDrop.ogg
+	SOUND_BLOCK_ROTATE,	// blockRotate.ogg
+	SOUND_LEVEL_UP,			// levelUp.ogg
+	SOUND_GAME_OVER,		// gameOver.ogg
+	SOUND_COUNT
+};
+
+// something for the audio thread to do
+struct AudioCommand
+{
+	enum Type : std::uint8_t {
+		PLAY_EFFECT,
+		PLAY_MUSIC,					// (from where it was paused)
+		PAUSE_MUSIC,
+		STOP_MUSIC,
+		SET_EFFECTS_VOLUME,
+		SET_MUSIC_VOLUME
+	};
+	Type type = PLAY_EFFECT;
+	SoundEffect effect = SOUND_BLOCK_DROP;	// PLAY_EFFECT
+	float volume = 100;											// SET_*_VOLUME (0 to 100)
+};
+
+class AudioSystem
+{
+public:
+	// STATIC CONSTANTS
+	static const int VOICE_COUNT = 8;		// effects that can play at once
+	typedef SpscQueue<AudioCommand, 64> Queue;
+
+	// MEMBER FUNCTIONS
+
+	AudioSystem() = default;
+
+	// destructor: stop()
+	~AudioSystem();
+
+	AudioSystem(const AudioSystem&) = delete;
+	AudioSystem& operator=(const AudioSystem&) = delete;
+
+	// get every effect from resources & open the music, from the sfx directory
+	//   (eg: "assets/sfx").  Call it before start().
+	//   return false if anything failed to load (what did load still plays)
+	bool load(ResourceCache &resources, const std::string &directory);
+
+	// start/stop the audio thread (stop() stops every sound too)
+	void start();
+	void stop();
+
+	// queue a command for the audio thread (game loop thread only, never blocks)
+	//   return false (and drop it) if the queue is full
+	bool post(const AudioCommand &command);
+
+	// queue commands (see post())
+	void playEffect(SoundEffect effect);
+	void playMusic();
+	void pauseMusic();
+	void stopMusic();
+	void setEffectsVolume(float volume);
+	void setMusicVolume(float volume);
+
+	// play the effects for a set of GameEvents (eg: TetrisEngine::getEvents())
+	void playEventEffects(GameEventMask events);
+
+	// commands dropped because the queue was full
+	std::uint64_t getDroppedCommands() const;
+
+private:
+	// carry out the posted commands until stop()
+	void run();
+
+	// carry out one command (on the audio thread)
+	void execute(const AudioCommand &command);
+
+	// the voice to play the next effect on: an idle one, or the one that
+	//   started longest ago
+	int chooseVoice() const;
+
+	// MEMBER VARIABLES
+	std::shared_ptr<const sf::SoundBuffer> buffers[SOUND_COUNT];	// the decoded effects (nullptr: missing)
+	sf::Sound voices[VOICE_COUNT];					// (after buffers: they must be destroyed first)
+	std::uint64_t voiceStarted[VOICE_COUNT] = {};	// when each voice last started (in effects played)
+	std::uint64_t effectsPlayed = 0;
+	sf::Music music;
+	bool musicLoaded = false;
+
+	Queue queue;
+	std::thread thread;
+	std::atomic<bool> running{ false };
+	std::atomic<std::uint64_t> droppedCommands{ 0 };
+};
+
+#endif /* AUDIOSYSTEM_H */
@@ -0,0 +1,125 @@
+// A BattleRoyale is one big last-player-standing match: a human (optional)
+// against many bots, every board in the same process.
+//
+// The bots' games are headless TetrisEngines played by BotPlayers, and all of
+// them are stepped once per frame on a WorkerPool (each bot only touches its
+// own engine).  The human's game is stepped by its owner (eg: a TetrisGame)
+// before each step(), and joins in through its engine.
+//
+// After the games have stepped, the match is settled on the calling thread,
+// player by player in a fixed order (so a match plays the same however many
+// threads step it):
+//   - a player whose game ended (GAME_EVENT_GAME_OVER) is knocked out: it
+//     finishes in the place of the players left, and whoever sent it garbage
+//     last gets the knockout.
+//   - rows a player cleared become garbage (ATTACK_ROWS) for its target.
+//   - targeting: each player attacks whoever attacked it last (revenge), or
+//     else a random opponent, picked again every RETARGET_FRAMES or when its
+//     target is knocked out.
+// The garbage holes and random targets come from the match's own seeded
+// generator, so a match is reproducible from its seed (and the human's input).
+//
+// While the human's game is paused (eg: time travelling, see TetrisGame) the
+// match must be paused too (setPaused()): a paused engine isn't stepped, so
+// its events & cleared rows are stale, and settling them again every frame
+// would resend its garbage, or knock it out for a game over it only showed.
+//
+//  [expected .cpp size: ~ 200 lines]
+
+#ifndef BATTLEROYALE_H
+#define BATTLEROYALE_H
+
+#include <cstdint>
+#include <vector>
+#include "BotPlayer.h"
+#include "TetrisEngine.h"
+#include "WorkerPool.h"
+
+class BattleRoyale
+{
+public:
+	// STATIC CONSTANTS
+	static const int ATTACK_ROWS[5];					// garbage rows sent for clearing 0-4 rows at once
+	static const int RETARGET_FRAMES = 5 * TetrisEngine::FRAMES_PER_SECOND;	// how long a random target lasts
+	static const int HUMAN = 0;								// the human's player index (when there is one)
+
+	// MEMBER FUNCTIONS
+
+	// constructor
+	//   human: the human's engine (stepped by the caller; nullptr: bots only)
+	//   botCount bots, of mixed strength, seeded from seed
+	//   pool steps the bots (it must outlive the match)
+	BattleRoyale(TetrisEngine *human, int botCount, std::uint32_t seed, WorkerPool &pool);
+
+	BattleRoyale(const BattleRoyale&) = delete;
+	BattleRoyale& operator=(const BattleRoyale&) = delete;
+
+	// step every bot still playing once, then settle knockouts & garbage
+	//   (step the human's engine first)
+	void step();
+
+	// pause the whole match (step() does nothing until it's unpaused)
+	void setPaused(bool paused);
+	bool isPaused() const;
+
+	// players: the human (if there is one) is player HUMAN, then the bots
+	int getPlayerCount() const;
+	bool hasHuman() const;
+	const TetrisEngine& getEngine(int player) const;
+
+	bool isAlive(int player) const;
+	int getAliveCount() const;
+	// the place a player finished in (1 is the winner); 0 while it is playing
+	int getPlacement(int player) const;
+	// the player's target (-1 if there's no one left to attack)
+	int getTarget(int player) const;
+	// the players this one knocked out
+	int getKnockouts(int player) const;
+	// the last player standing (-1 while the match is on)
+	int getWinner() const;
+	bool isOver() const;
+
+	// the garbage rows sent by everyone so far
+	std::uint64_t getGarbageSent() const;
+	// the frames stepped so far
+	std::uint32_t getFrame() const;
+
+private:
+	struct Player
+	{
+		TetrisEngine *engine = nullptr;
+		bool alive = true;
+		int placement = 0;
+		int target = -1;
+		int framesOnTarget = 0;
+		int lastAttacker = -1;			// (gets the knockout)
+		int revengeOn = -1;					// attacked it since its target was picked
+		int knockouts = 0;
+	};
+
+	// knock a player out (it finishes in the place of the players left)
+	void knockOut(int player);
+
+	// pick a player's target if it has none, or it's time for a new one
+	void updateTarget(int player);
+
+	// a random player still playing, other than player (-1 if there is none)
+	int randomOpponent(int player);
+
+	// return the next value of the (xorshift32) generator
+	std::uint32_t nextRandom();
+
+	// MEMBER VARIABLES
+	WorkerPool &pool;
+	std::vector<TetrisEngine> botEngines;			// (sized once: players point into it)
+	std::vector<BotPlayer> bots;
+	int firstBot;															// the player index of bot 0
+	std::vector<Player> players;
+	int aliveCount;
+	std::uint64_t garbageSent = 0;
+	std::uint32_t frame = 0;
+	std::uint32_t rngState;
+	bool paused = false;
+};
+
+#endif /* BATTLEROYALE_H */
@@ -0,0 +1,80 @@
+// A BitBoard is a Gameboard with fast paths: the same cells & the same rules,
+// but each row's occupied cells are also kept as bits (one 16-bit mask a row,
+// bit x set when x,y isn't EMPTY_BLOCK), and the contents are kept a byte a
+// cell.  So:
+//   - areLocsEmpty() / fits() test a bit per block instead of reading the grid,
+//   - a completed row is a mask compare (FULL_ROW), and removeCompletedRows()
+//     moves each kept row once (one memcpy) rather than once per row removed
+//     below it,
+//   - getRowMask() (bots, minimaps) is a load, not a scan,
+// and a whole board is ~210 bytes instead of ~1 KB (cheap for searches to copy).
+//
+// It is a candidate to replace Gameboard in the hot paths, so it has to behave
+// exactly like Gameboard (the reference).  The differential fuzzer in src/fuzz
+// (make fuzz) plays random operations on both and checks they always agree.
+// There is no change journal: it isn't meant for the board renderers read.
+// Contents must fit in a signed byte (EMPTY_BLOCK & the colors do).
+//
+//  [expected .cpp size: ~ 150 lines]
+
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <cstdint>
+#include "BlockLocs.h"
+#include "Gameboard.h"
+
+class BitBoard
+{
+public:
+	// CONSTANTS
+	static const int MAX_X = Gameboard::MAX_X;
+	static const int MAX_Y = Gameboard::MAX_Y;
+	static const int EMPTY_BLOCK = Gameboard::EMPTY_BLOCK;
+	static const std::uint16_t FULL_ROW = (1u << MAX_X) - 1;	// a completed row's mask
+
+	// MEMBER FUNCTIONS
+
+	// constructor - empty() the grid
+	BitBoard();
+
+	// a copy of a Gameboard's cells
+	explicit BitBoard(const Gameboard &board);
+
+	// return the content at an x,y grid loc (assert the point is valid)
+	int getContent(int x, int y) const;
+
+	// set the content at an x,y position (assert the point is valid)
+	void setContent(int x, int y, int content);
+
+	// return true if the content at ALL (valid) points is empty
+	//   (points off the grid are disregarded, as in Gameboard)
+	bool areLocsEmpty(const BlockLocs &locs) const;
+
+	// can a shape's blocks be here?  inside the left, right & bottom borders,
+	//   on empty cells (the engine's rule: the top is open, so shapes can spawn
+	//   above it)
+	bool fits(const BlockLocs &locs) const;
+
+	// removes all completed rows from the board
+	//   return the # of completed rows removed
+	int removeCompletedRows();
+
+	// fill the board with EMPTY_BLOCK
+	void empty();
+
+	// push every row up count rows (the top count rows are lost) and fill the
+	//   bottom count rows with content, except for a hole at holeX (garbage rows)
+	//   return false if a lost row had blocks in it
+	bool raiseRows(int count, int content, int holeX);
+
+	// the occupied cells of row y as bits (bit x is set if x,y isn't EMPTY_BLOCK)
+	std::uint16_t getRowMask(int y) const;
+
+private:
+	// MEMBER VARIABLES
+	std::uint16_t rows[MAX_Y];						// each row's occupied cells
+	std::int8_t contents[MAX_Y][MAX_X];		// each cell's content
+};
+
+#endif /* BITBOARD_H */
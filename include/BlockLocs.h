@@ -0,0 +1,84 @@
+// BlockLocs is a list of up to MAX_BLOCKS Points: the blocks of a tetromino.
+//
+// It stands in for the std::vector<Point> Tetromino used to keep its blocks in,
+// with the part of vector's interface the game uses (push_back(), clear(),
+// size(), [], range-for, and assigning a { ... } list), but the Points are held
+// inside it.  So copying a tetromino (TetrisEngine copies the falling shape to
+// try every move & rotation) or returning its mapped locs never allocates.
+
+#ifndef BLOCKLOCS_H
+#define BLOCKLOCS_H
+
+#include <assert.h>
+#include <cstddef>
+#include <initializer_list>
+#include "Point.h"
+
+class BlockLocs
+{
+public:
+	// STATIC CONSTANTS
+	static const std::size_t MAX_BLOCKS = 4;
+
+	// MEMBER FUNCTIONS
+
+	BlockLocs() = default;
+
+	BlockLocs(std::initializer_list<Point> points)
+	{
+		*this = points;
+	}
+
+	BlockLocs& operator=(std::initializer_list<Point> points)
+	{
+		clear();
+		for (const Point &p : points)
+		{
+			push_back(p);
+		}
+		return *this;
+	}
+
+	void push_back(const Point &p)
+	{
+		assert(count < MAX_BLOCKS && "BlockLocs is full");
+		points[count++] = p;
+	}
+
+	void clear()
+	{
+		count = 0;
+	}
+
+	std::size_t size() const
+	{
+		return count;
+	}
+
+	bool empty() const
+	{
+		return count == 0;
+	}
+
+	Point& operator[](std::size_t index)
+	{
+		return points[index];
+	}
+
+	const Point& operator[](std::size_t index) const
+	{
+		return points[index];
+	}
+
+	Point* begin() { return points; }
+	Point* end() { return points + count; }
+	const Point* begin() const { return points; }
+	const Point* end() const { return points + count; }
+
+private:
+	// MEMBER VARIABLES
+	Point points[MAX_BLOCKS];
+	std::size_t count = 0;
+};
+
+#endif /* BLOCKLOCS_H */
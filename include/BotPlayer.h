@@ -0,0 +1,56 @@
+// A BotPlayer plays a TetrisEngine through its buttons, like a person would.
+//
+// When a new shape spawns (TetrisEngine::getShapeCount() goes up) it plans
+// the best placement for it (see PlacementSearch), then presses one button
+// every framesPerAction frames to get there: the FinesseTable's shortest
+// presses for that placement (a LEFT / RIGHT to the wall is held, letting the
+// engine's auto-repeat carry the shape), then ROTATE / LEFT / RIGHT taps for
+// whatever the stack got in the way of, then DROP.  Buttons are released
+// between presses (the engine acts on a button when it goes down).
+// framesPerAction sets how strong the bot is: a slow bot's shapes fall
+// further while it is still moving them, and it can't keep up with garbage.
+//
+// The bot only reads the engine, and decides from what it sees, so a replay of
+// its buttons plays the same game.
+//
+//  [expected .cpp size: ~ 100 lines]
+
+#ifndef BOTPLAYER_H
+#define BOTPLAYER_H
+
+#include "Finesse.h"
+#include "PlacementSearch.h"
+#include "TetrisEngine.h"
+
+class BotPlayer
+{
+public:
+	// MEMBER FUNCTIONS
+
+	// constructor
+	//   framesPerAction: frames from one button press to the next (at least 2:
+	//   a press, then a release)
+	explicit BotPlayer(int framesPerAction = 4, const PlacementWeights &weights = PlacementWeights());
+
+	// the buttons to hold for the engine's next step()
+	InputMask nextButtons(const TetrisEngine &engine);
+
+	// the placement being played (found is false while there's none)
+	const Placement& getPlan() const;
+
+private:
+	// MEMBER VARIABLES
+	int framesPerAction;
+	PlacementWeights weights;
+	Placement plan;							// where the current shape is going
+	bool planned = false;				// false: plan for the next new shape
+	int targetRotation = 0;			// the shape's rotation (0-3) in the plan
+	FinessePath path;						// the presses to the plan from the spawn (if it spawned there)
+	int nextMove = 0;						// the next of path's moves
+	InputMask holding = 0;			// the LEFT / RIGHT held to the wall (0: none)
+	bool awaitingShape = false;	// dropped: wait for the next shape to spawn
+	std::uint32_t lastShape = 0;	// the shape count last frame
+	int framesToAction = 0;			// frames until the next press
+};
+
+#endif /* BOTPLAYER_H */
@@ -0,0 +1,153 @@
+// A Coach watches a human play and, on its own thread, works out where each
+// shape should have gone: it suggests the best placement for the falling shape
+// (drawn as a ghost, see GameView::addGhost()) and grades each shape the player
+// locks against every placement it could have had.
+//
+// The search is PlacementSearch's, looking one shape ahead: each placement of
+// the falling shape is scored by the best placement of the next shape on the
+// board it leaves.  That takes a millisecond or two, so it never runs on the
+// game loop:
+//   - observe() (on the game loop, after each step) hands the coach a
+//     CoachSnapshot when a shape spawns, and the locked shape when it locks.
+//     A snapshot is the board's row masks and the two shapes (a few hundred
+//     bytes, no allocation).  It goes in a one-request slot (a newer shape's
+//     snapshot replaces one the coach hasn't got to: that shape is gone), and
+//     grade requests go on a lock-free SpscQueue.  The slot's mutex is only
+//     held to copy a snapshot, so the game loop never waits on the search.
+//   - the coach's thread wakes for each request, advises first (the player
+//     needs it now), then grades, and pushes its results on two more
+//     SpscQueues.
+//   - pollAdvice() / pollGrade() (on the game loop) take the newest results
+//     without waiting.  Advice for a shape that has since locked is dropped.
+// One thread calls observe() and the polls; advise() & grade() are the same
+// search, run on the caller (tools & tests).
+//
+//  [expected .cpp size: ~ 250 lines]
+
+#ifndef COACH_H
+#define COACH_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include "PlacementSearch.h"
+#include "SpscQueue.h"
+#include "TetrisEngine.h"
+
+// what the coach sees when a shape spawns
+struct CoachSnapshot
+{
+	std::uint32_t shapeNumber = 0;						// TetrisEngine::getShapeCount() of the falling shape
+	std::uint16_t rows[Gameboard::MAX_Y] = {};	// the board (Gameboard::getRowMask())
+	GridTetromino current;										// the falling shape, where it spawned
+	GridTetromino next;												// the shape after it
+};
+
+// the placement the coach suggests for a shape
+struct CoachAdvice
+{
+	std::uint32_t shapeNumber = 0;
+	bool found = false;						// false: the shape has nowhere to go
+	GridTetromino ghost;					// the shape where it should land
+	double score = 0;							// how good that is (see PlacementSearch)
+};
+
+// how good a locked shape's placement was
+enum CoachGradeLevel {
+	GRADE_BEST,			// the best placement there was
+	GRADE_GOOD,			// close to it
+	GRADE_FAIR,
+	GRADE_POOR
+};
+
+struct CoachGrade
+{
+	std::uint32_t shapeNumber = 0;
+	CoachGradeLevel level = GRADE_BEST;
+	int rank = 1;									// 1 + the placements that were better
+	int placements = 0;						// the placements there were
+	double scoreLost = 0;					// the best placement's score - this one's (0 or more)
+};
+
+class Coach
+{
+public:
+	// STATIC CONSTANTS
+	static const double GOOD_SCORE_LOST;		// the most score lost for each grade
+	static const double FAIR_SCORE_LOST;
+
+	// MEMBER FUNCTIONS
+
+	// constructor
+	//   weights: how placements are scored (see PlacementSearch)
+	explicit Coach(const PlacementWeights &weights = PlacementWeights());
+	// stops the thread
+	~Coach();
+
+	Coach(const Coach&) = delete;
+	Coach& operator=(const Coach&) = delete;
+
+	// start/stop the coach's thread (requests wait in the queue until it starts)
+	//   start() forgets the game it watched before (and any results not polled)
+	void start();
+	void stop();
+
+	// look at the game after a step(): ask for a grade if a shape locked, and
+	//   for advice if a new one spawned (game loop thread only, never waits on
+	//   the search)
+	void observe(const TetrisEngine &engine);
+
+	// take the newest advice / grade since the last poll (false if there's none)
+	//   (game loop thread only, never blocks)
+	bool pollAdvice(CoachAdvice &advice);
+	bool pollGrade(CoachGrade &grade);
+
+	// grade requests dropped because the coach's queue was full
+	std::uint64_t getDroppedRequests() const;
+
+	// the snapshot of an engine's board & shapes
+	static CoachSnapshot takeSnapshot(const TetrisEngine &engine);
+
+	// the best placement for the snapshot's falling shape (on the caller)
+	static CoachAdvice advise(const CoachSnapshot &snapshot, const PlacementWeights &weights = PlacementWeights());
+
+	// grade the snapshot's falling shape locked at locked (on the caller)
+	static CoachGrade grade(const CoachSnapshot &snapshot, const GridTetromino &locked,
+		const PlacementWeights &weights = PlacementWeights());
+
+private:
+	// a shape to grade
+	struct GradeRequest
+	{
+		CoachSnapshot snapshot;			// (when it spawned)
+		GridTetromino locked;				// where it was locked
+	};
+
+	// wake the thread for a new request
+	void wakeUp();
+
+	// the coach's thread: carry out requests until stop()
+	void run();
+
+	// MEMBER VARIABLES
+	PlacementWeights weights;
+	std::mutex slotMutex;										// guards adviceRequest (& waiting for requests)
+	std::condition_variable wake;
+	CoachSnapshot adviceRequest;						// the snapshot to advise on (game loop -> coach thread)
+	bool advicePending = false;
+	SpscQueue<GradeRequest, 16> gradeRequests;	// game loop -> coach thread
+	SpscQueue<CoachAdvice, 8> advice;				// coach thread -> game loop
+	SpscQueue<CoachGrade, 8> grades;				// coach thread -> game loop
+	std::thread thread;
+	std::atomic<bool> stopping{ false };
+	std::atomic<std::uint64_t> droppedRequests{ 0 };
+
+	// the game loop's view of the game (see observe())
+	CoachSnapshot snapshot;									// the falling shape's snapshot
+	bool haveSnapshot = false;
+	std::uint32_t gradedShape = 0;					// the last shape a grade was asked for
+};
+
+#endif /* COACH_H */
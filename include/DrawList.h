@@ -0,0 +1,108 @@
+// A DrawList is a backend-neutral description of one frame (or one layer of a
+// frame): a list of quads and a list of text runs, in drawing order.
+//
+// Game code (GameView) fills a DrawList; a backend turns it into pixels:
+//   - SfmlDrawListRenderer draws it on an sf::RenderTarget (window or texture),
+//     batching runs of quads that use the same texture into one draw call.
+//   - SoftwareRenderer rasterizes it on the CPU into an RGBA buffer that can be
+//     written as a PPM or PNG (no display or GPU needed).
+//
+// The DrawList knows nothing of SFML, so it (and the software backend) can be
+// used by headless tools and tests.  Textures are referred to by DrawTextureId;
+// each backend is told which image each id stands for.
+// Quads are drawn first, in order, then text runs, in order.
+// clear() keeps the lists' storage, so refilling a DrawList every frame doesn't allocate.
+//
+//  [expected .cpp size: ~ 100 lines]
+
+#ifndef DRAWLIST_H
+#define DRAWLIST_H
+
+#include <cstdint>
+#include <vector>
+
+// the textures a quad can be drawn with
+enum DrawTextureId {
+	TEXTURE_NONE,					// a solid color quad
+	TEXTURE_TILES,				// assets/images/tiles.png
+	TEXTURE_BACKGROUND,		// assets/images/background.png
+	TEXTURE_MINIMAPS,			// a MinimapAtlas (updated every frame)
+	TEXTURE_COUNT
+};
+
+struct DrawColor
+{
+	std::uint8_t r = 255;
+	std::uint8_t g = 255;
+	std::uint8_t b = 255;
+	std::uint8_t a = 255;
+};
+
+// a rectangle in pixels
+struct DrawRect
+{
+	float left = 0;
+	float top = 0;
+	float width = 0;
+	float height = 0;
+};
+
+// a rectangle, textured from a rectangle of a texture (in texture pixels)
+//   and tinted (multiplied) by color
+struct DrawQuad
+{
+	DrawRect dest;
+	DrawTextureId texture = TEXTURE_NONE;
+	DrawRect source;
+	DrawColor color;
+};
+
+// a line of text, top left at x,y
+struct DrawText
+{
+	static const int MAX_LENGTH = 47;
+
+	float x = 0;
+	float y = 0;
+	int characterSize = 24;				// pixels
+	DrawColor color;
+	char text[MAX_LENGTH + 1] = {};	// nul terminated (longer strings are cut)
+};
+
+class DrawList
+{
+public:
+	// MEMBER FUNCTIONS
+
+	// remove every quad & text run (keeps the storage)
+	void clear();
+
+	// make room for this many quads & text runs, so filling the list up to
+	//   that never allocates
+	void reserve(std::size_t quadCount, std::size_t textCount);
+
+	// add a quad textured from source (texture pixels), tinted by color
+	//   (white: as the texture is)
+	void addTexturedQuad(DrawTextureId texture, const DrawRect &dest, const DrawRect &source,
+		DrawColor color = DrawColor());
+
+	// add a solid color quad
+	void addRect(const DrawRect &dest, DrawColor color);
+
+	// add a text run (text is copied, up to DrawText::MAX_LENGTH characters)
+	void addText(float x, float y, int characterSize, DrawColor color, const char *text);
+
+	const std::vector<DrawQuad>& getQuads() const;
+	const std::vector<DrawText>& getTexts() const;
+
+	// the number of draw calls a batching backend needs for this list:
+	//   one per run of consecutive quads with the same texture, plus one per text run
+	int countBatches() const;
+
+private:
+	// MEMBER VARIABLES
+	std::vector<DrawQuad> quads;
+	std::vector<DrawText> texts;
+};
+
+#endif /* DRAWLIST_H */
@@ -0,0 +1,117 @@
+// Finesse: placing each shape with as few key presses as it can be.
+//
+// The FinesseTable holds, for every shape, rotation and column a shape can be
+// dropped in, the shortest sequence of presses that gets it there from where
+// it spawns (Gameboard::getSpawnLoc(), unrotated) on an empty-topped board:
+// ROTATE (clockwise, the engine's only rotation), LEFT / RIGHT taps, and
+// LEFT / RIGHT held to the wall (auto-repeat, one press), then DROP.
+// It is worked out once (a breadth-first search over rotation & column, with
+// the engine's rules: inside the side walls, no wall kicks), the first time
+// it's used, and looked up in O(1) after that.  Placements that cover the
+// same cells (eg: an O's rotations, an I's flat ones) share the shortest of
+// their sequences.
+//
+// A FinesseTracker counts the presses a player makes for each shape (LEFT,
+// RIGHT & ROTATE going down; DOWN & DROP don't count) and, when the shape
+// locks, compares them with the table's sequence for where it was locked.
+// The extra presses are finesse errors, reported live (getLastResult()) and
+// totalled.  Bots play the table's sequences (see BotPlayer).
+//
+//  [expected .cpp size: ~ 200 lines]
+
+#ifndef FINESSE_H
+#define FINESSE_H
+
+#include <cstdint>
+#include "Gameboard.h"
+#include "GridTetromino.h"
+#include "TetrisEngine.h"
+
+// one press in a finesse sequence
+enum FinesseMove {
+	FINESSE_ROTATE,			// tap ROTATE
+	FINESSE_LEFT,				// tap LEFT
+	FINESSE_RIGHT,			// tap RIGHT
+	FINESSE_DAS_LEFT,		// hold LEFT until the shape reaches the wall
+	FINESSE_DAS_RIGHT		// hold RIGHT until the shape reaches the wall
+};
+
+// the presses that get a shape from its spawn to a rotation & column (then DROP)
+struct FinessePath
+{
+	static const int MAX_MOVES = 6;
+
+	bool reachable = false;			// false: the shape can't be dropped there
+	int count = 0;							// the presses (not counting DROP)
+	FinesseMove moves[MAX_MOVES] = {};
+};
+
+class FinesseTable
+{
+public:
+	// STATIC CONSTANTS
+	static const int MIN_X = -2;										// the grid loc x range a shape can be at
+	static const int COLUMNS = Gameboard::MAX_X + 4;	//   (its blocks are within 2 of its loc)
+
+	// MEMBER FUNCTIONS
+
+	// the table (worked out on the first call)
+	static const FinesseTable& get();
+
+	// the shortest presses from spawn to a shape's rotation (0-3) & grid loc x
+	//   (unreachable if there's no such placement)
+	const FinessePath& getPath(TetShape shape, int rotation, int x) const;
+
+private:
+	// work the table out (see the top)
+	FinesseTable();
+
+	// work out one shape's paths
+	void build(TetShape shape);
+
+	// MEMBER VARIABLES
+	FinessePath paths[TetShape::COUNT][4][COLUMNS];
+	FinessePath unreachable;
+};
+
+// how a locked shape's presses compared with the table's
+struct FinesseResult
+{
+	std::uint32_t shapeNumber = 0;		// TetrisEngine::getShapeCount() of the shape
+	TetShape shape = TetShape::S;
+	int presses = 0;									// the presses the player made
+	int minimum = 0;									// the table's presses for where it locked
+	int errors = 0;										// the extra presses (0 or more)
+};
+
+class FinesseTracker
+{
+public:
+	// MEMBER FUNCTIONS
+
+	// look at the game after a step() made with heldButtons held
+	void observe(const TetrisEngine &engine, InputMask heldButtons);
+
+	// the last shape locked (false before one has)
+	bool hasResult() const;
+	const FinesseResult& getLastResult() const;
+
+	// totals since the tracker started
+	int getShapes() const;				// the shapes locked
+	int getFaults() const;				// the shapes locked with errors
+	int getErrors() const;				// the extra presses
+
+private:
+	// MEMBER VARIABLES
+	InputMask previousButtons = 0;
+	std::uint32_t shapeNumber = 0;	// the shape presses are counted for
+	bool tracking = false;					// false until the first spawn seen, and once locked
+	int presses = 0;
+	bool haveResult = false;
+	FinesseResult lastResult;
+	int shapes = 0;
+	int faults = 0;
+	int errors = 0;
+};
+
+#endif /* FINESSE_H */
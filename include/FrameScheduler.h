@@ -0,0 +1,77 @@
+// The FrameScheduler decouples the simulation rate from the render rate.
+//
+// The game is simulated in fixed steps (stepSeconds each, 60 per second by
+// default) however fast frames are rendered: each rendered frame calls
+// beginFrame() with the time, and runs as many steps as the elapsed time has
+// paid for (an "accumulator").  The time left over is getAlpha(), the fraction
+// of a step the frame is ahead of the simulation, used to interpolate what is
+// drawn.  So gravity runs at the same speed whether frames render at 30Hz,
+// 60Hz or 144Hz, and fast displays still see smooth motion.
+//
+// If a frame is so late that it would need more than maxStepsPerFrame steps
+// (eg: the window was dragged), the rest is dropped rather than trying to catch
+// up (the "spiral of death").
+//
+// It also measures the frame times: mean, jitter (standard deviation) & max.
+// It takes times as seconds, so it works with any clock (sf::Clock in main.cpp).
+//
+//  [expected .cpp size: ~ 100 lines]
+
+#ifndef FRAMESCHEDULER_H
+#define FRAMESCHEDULER_H
+
+#include <cstdint>
+#include "TetrisEngine.h"
+
+// frame time statistics since the last resetStats()
+struct FrameStats
+{
+	std::uint64_t frames = 0;				// frames rendered
+	std::uint64_t steps = 0;				// fixed steps simulated
+	std::uint64_t droppedSteps = 0;	// steps skipped because a frame was too late
+	double meanFrameSeconds = 0;
+	double jitterSeconds = 0;				// standard deviation of the frame time
+	double maxFrameSeconds = 0;
+};
+
+class FrameScheduler
+{
+public:
+	// MEMBER FUNCTIONS
+
+	// constructor
+	//   stepSeconds: the fixed simulation step
+	//   maxStepsPerFrame: the most steps a single frame may run
+	explicit FrameScheduler(double stepSeconds = TetrisEngine::SECONDS_PER_FRAME, int maxStepsPerFrame = 8);
+
+	// start rendering a frame at time now (seconds, from any steady clock).
+	//   return the number of fixed steps to simulate before drawing it
+	int beginFrame(double now);
+
+	// how far between the last simulated step and the next this frame is (0 to 1)
+	double getAlpha() const;
+
+	// the time (on the beginFrame() clock) the simulation has reached, once
+	//   the steps beginFrame() returned have run.  Step i of those steps
+	//   (0 based, of n) covers the stepSeconds up to
+	//   getSimulatedTime() - (n - 1 - i) * stepSeconds
+	double getSimulatedTime() const;
+
+	double getStepSeconds() const;
+
+	FrameStats getStats() const;
+	void resetStats();
+
+private:
+	// MEMBER VARIABLES
+	double stepSeconds;
+	int maxStepsPerFrame;
+	bool started = false;
+	double lastFrameTime = 0;
+	double accumulator = 0;				// time not yet simulated
+
+	FrameStats stats;
+	double frameSecondsSquaredDeviation = 0;	// Welford's running sum, for the jitter
+};
+
+#endif /* FRAMESCHEDULER_H */
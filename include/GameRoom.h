@@ -0,0 +1,85 @@
+// The GameRoom class is one authoritative match on the game server:
+// a TetrisEngine per player, stepped together at a fixed rate.
+//
+// Clients never tell the server what happened, only which buttons they held on
+// which frame.  submitInput() validates every input against the server's own
+// simulation before it is used:
+//   - the button mask must only contain real buttons,
+//   - frames must increase (no replays/duplicates),
+//   - inputs too far in the future (speed hacks) or too far in the past are rejected.
+// Inputs for frames the server hasn't reached yet are buffered and applied on
+// their frame; slightly late inputs are applied on the next frame.
+//
+// Players can leave (removePlayer(), eg: when they time out): their slot is
+// freed for the next player to join, who takes over that slot's game.
+//
+//  [expected .cpp size: ~ 140 lines]
+
+#ifndef GAMEROOM_H
+#define GAMEROOM_H
+
+#include <cstdint>
+#include "TetrisEngine.h"
+
+class GameRoom
+{
+public:
+	// STATIC CONSTANTS
+	static const int PLAYER_COUNT = 2;
+	static const int INPUT_BUFFER_FRAMES = 16;	// how far ahead of the server a client may send input
+	static const int MAX_INPUT_LAG_FRAMES = 30;	// inputs older than this are rejected as stale
+
+	// the outcome of submitInput()
+	enum InputResult {
+		INPUT_ACCEPTED,
+		INPUT_INVALID_SLOT,
+		INPUT_INVALID_BUTTONS,
+		INPUT_DUPLICATE,
+		INPUT_TOO_EARLY,
+		INPUT_STALE
+	};
+
+	// MEMBER FUNCTIONS
+
+	// constructor
+	//   every player's engine uses the same seed (same piece sequence)
+	GameRoom(std::uint32_t id, std::uint32_t seed);
+
+	std::uint32_t getId() const;
+
+	// add a player to the room, return their slot (or -1 if the room is full)
+	//   (the first free slot)
+	int addPlayer();
+	// free a player's slot (its buffered inputs are dropped; its game goes on)
+	void removePlayer(int slot);
+	bool hasPlayer(int slot) const;
+	int getPlayerCount() const;
+
+	// validate a player's held buttons for a frame, and queue them if legal
+	InputResult submitInput(int slot, std::uint32_t inputFrame, InputMask heldButtons);
+
+	// advance every engine in the room by one frame
+	void step();
+
+	// the frame the room will simulate next
+	std::uint32_t getFrame() const;
+
+	const TetrisEngine& getEngine(int slot) const;
+
+private:
+	// MEMBER VARIABLES
+	std::uint32_t id;
+	int playerCount = 0;
+	std::uint32_t frame = 0;
+
+	TetrisEngine engines[PLAYER_COUNT];
+	bool occupied[PLAYER_COUNT];												// does a player hold the slot?
+	InputMask heldButtons[PLAYER_COUNT];								// buttons applied on the next step()
+	std::int64_t lastInputFrame[PLAYER_COUNT];					// newest frame accepted per player (-1 none)
+
+	// buffered future inputs, indexed by frame % INPUT_BUFFER_FRAMES
+	InputMask bufferedButtons[PLAYER_COUNT][INPUT_BUFFER_FRAMES];
+	std::int64_t bufferedFrame[PLAYER_COUNT][INPUT_BUFFER_FRAMES];	// frame the entry is for (-1 empty)
+};
+
+#endif /* GAMEROOM_H */
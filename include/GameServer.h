@@ -0,0 +1,82 @@
+// The GameServer class hosts many GameRooms (matches) in one process.
+//
+// Work is split across worker threads (one per core by default).  Each worker:
+//   - owns its own UDP socket (basePort + workerIndex) and an sf::SocketSelector,
+//   - owns a shard of the rooms (room R belongs to worker R % workerCount), so
+//     workers never share game state and never lock,
+//   - waits on its selector until the next 60Hz frame is due, drains every
+//     pending datagram, then steps *all* of its rooms in one batch,
+//   - sends each player an authoritative MSG_STATE every STATE_INTERVAL_FRAMES.
+// See ServerProtocol.h for the messages and GameRoom.h for input validation.
+//
+// The capacity target is TARGET_ROOMS_PER_CORE rooms per worker at 60Hz;
+// getStats() reports how busy the workers are so load tests can check it.
+//
+// Anyone can ask for a new room, so a worker's rooms are capped
+// (MAX_ROOMS_PER_WORKER, and so its players: PLAYER_COUNT a room); joins past
+// the cap get REJECT_SERVER_FULL.  Players who stop sending (anything) for
+// PLAYER_TIMEOUT_FRAMES are dropped, and a room is freed (with its tokens &
+// remembered joins) when its last player goes, so a long running server
+// doesn't grow.
+//
+//  [expected .cpp size: ~ 440 lines]
+
+#ifndef GAMESERVER_H
+#define GAMESERVER_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class ServerWorker;
+
+// totals across every worker
+struct ServerStats
+{
+	std::uint64_t rooms = 0;
+	std::uint64_t players = 0;
+	std::uint64_t roomFramesStepped = 0;	// sum over rooms of frames simulated
+	std::uint64_t inputsAccepted = 0;
+	std::uint64_t inputsRejected = 0;
+	std::uint64_t packetsSent = 0;
+	double busySeconds = 0.0;							// time workers spent handling packets & stepping rooms
+	double elapsedSeconds = 0.0;					// wall time since start() (per worker)
+};
+
+class GameServer
+{
+public:
+	// STATIC CONSTANTS
+	static const int TARGET_ROOMS_PER_CORE = 1000;	// rooms one worker must sustain at 60Hz
+	static const int STATE_INTERVAL_FRAMES = 6;		// send MSG_STATE at 10Hz
+	static const int MAX_CATCH_UP_FRAMES = 5;			// frames stepped at once after a stall, before skipping
+	static const int MAX_ROOMS_PER_WORKER = 2 * TARGET_ROOMS_PER_CORE;	// joins for new rooms past this are rejected
+	static const int PLAYER_TIMEOUT_FRAMES = 30 * 60;	// frames (30s) without a packet before a player is dropped
+	static const int EXPIRE_INTERVAL_FRAMES = 60;	// how often a worker looks for timed out players
+
+	// MEMBER FUNCTIONS
+
+	// constructor
+	//   workerCount 0 means one worker per hardware thread
+	GameServer(unsigned short basePort, int workerCount = 0);
+	~GameServer();
+
+	// bind every worker's socket and start the worker threads.
+	//   return false if a port could not be bound.
+	bool start();
+
+	// stop & join every worker thread
+	void stop();
+
+	int getWorkerCount() const;
+	unsigned short getBasePort() const;
+
+	// a snapshot of the totals across every worker (safe to call while running)
+	ServerStats getStats() const;
+
+private:
+	unsigned short basePort;
+	std::vector<std::unique_ptr<ServerWorker>> workers;
+};
+
+#endif /* GAMESERVER_H */
@@ -0,0 +1,92 @@
+// The GameView describes how one game looks, as a DrawList: where the board,
+// the falling shape, the next shape and the score go, and which tile of
+// tiles.png each block uses.
+//
+// It only reads a TetrisEngine, so the same view is used by TetrisGame (drawn
+// with SFML) and by headless tools (drawn with the SoftwareRenderer).
+//
+//  [expected .cpp size: ~ 100 lines]
+
+#ifndef GAMEVIEW_H
+#define GAMEVIEW_H
+
+#include <string>
+#include <vector>
+#include "Coach.h"
+#include "DrawList.h"
+#include "Finesse.h"
+#include "MinimapAtlas.h"
+#include "TetrisEngine.h"
+
+class GameView
+{
+public:
+	// STATIC CONSTANTS
+	static const int BLOCK_WIDTH = 32;	// pixel width of a tetris block (and of a tile in tiles.png)
+	static const int BLOCK_HEIGHT = 32; // pixel height of a tetris block
+	static const int SCORE_CHARACTER_SIZE = 24;
+	static const int OVERLAY_CHARACTER_SIZE = 14;	// debug overlays (statistics)
+	static const int GRADE_CHARACTER_SIZE = 18;		// the coach's grades
+	static const std::uint8_t GHOST_ALPHA = 90;		// how opaque a ghost shape is (0-255)
+	// the most a game adds: every board cell plus the falling, next & ghost shapes' blocks,
+	//   and the score, the coach's grade & the finesse
+	static const int MAX_GAME_QUADS = Gameboard::MAX_X * Gameboard::MAX_Y + 3 * BlockLocs::MAX_BLOCKS;
+	static const int MAX_GAME_TEXTS = 3;
+
+	// MEMBER FUNCTIONS
+
+	// constructor
+	//   the pixel offsets of the top left of the gameboard, the next shape and the score
+	GameView(Point gameboardOffset, Point nextShapeOffset, Point scoreOffset);
+
+	// add the whole game: the board, the falling & next shapes and the score
+	void addGame(DrawList &list, const TetrisEngine &engine) const;
+
+	// add everything but the board's locked blocks
+	//   (for backends that draw the board some other way, eg: a cached layer)
+	//   fallOffset: how far (in blocks) below its grid location to draw the falling shape
+	void addPieces(DrawList &list, const TetrisEngine &engine, double fallOffset = 0) const;
+
+	// the fallOffset that makes the falling shape glide down between ticks
+	//   (instead of jumping a row per tick), secondsAhead after the engine's
+	//   last simulated frame.  0 if the shape can't fall any further.
+	static double getFallOffset(const TetrisEngine &engine, double secondsAhead);
+
+	// add the board's locked blocks, with the board's top left at topLeft
+	void addBoard(DrawList &list, const Gameboard &board, const Point &topLeft) const;
+
+	// add a tetromino's blocks, with the grid's top left at topLeft
+	void addTetromino(DrawList &list, const GridTetromino &tetromino, const Point &topLeft) const;
+
+	// add a ghost of a shape on the board: its blocks, translucent
+	//   (eg: where the coach suggests it goes)
+	void addGhost(DrawList &list, const GridTetromino &ghost) const;
+
+	// add the coach's grade for the last shape locked, under the score
+	void addCoachGrade(DrawList &list, const CoachGrade &grade) const;
+
+	// add the finesse of the last shape locked & the totals, under the grade
+	void addFinesse(DrawList &list, const FinesseTracker &finesse) const;
+
+	// add a block: the tile for color, at block xOffset,yOffset from topLeft (in pixels)
+	//   tinted by tint (white: as the tile is)
+	static void addBlock(DrawList &list, const Point &topLeft, int xOffset, int yOffset, TetColor color,
+		DrawColor tint = DrawColor());
+
+	// add a MinimapAtlas (every minimap, one quad), scaled up to fill dest
+	static void addMinimaps(DrawList &list, const DrawRect &dest, const MinimapAtlas &atlas);
+
+	// add a debug overlay: lines of text on a dark panel, with the panel's top left at topLeft
+	//   (lines longer than DrawText::MAX_LENGTH are cut)
+	static void addOverlay(DrawList &list, const Point &topLeft, const std::vector<std::string> &lines);
+
+	Point getGameboardOffset() const;
+
+private:
+	// MEMBER VARIABLES
+	Point gameboardOffset; // pixel XY offset of the gameboard
+	Point nextShapeOffset; // pixel XY offset of the nextShape
+	Point scoreOffset;		 // pixel XY offset of the score text
+};
+
+#endif /* GAMEVIEW_H */
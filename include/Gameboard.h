@@ -51,8 +51,25 @@
 #ifndef GAMEBOARD_H
 #define GAMEBOARD_H
 
+#include <cstdint>
 #include <vector>
 #include "point.h"
+#include "BlockLocs.h"
+
+// one entry in the Gameboard's change journal (see getChange())
+struct BoardChange
+{
+	enum Type : std::uint8_t {
+		CELL_SET,				// x,y now holds content
+		ROW_REMOVED,		// row y was removed (rows above moved down one)
+		BOARD_EMPTIED		// every cell is now EMPTY_BLOCK
+	};
+
+	Type type;
+	std::int8_t x;
+	std::int8_t y;
+	std::int8_t content;
+};
 
 class Gameboard
 {
@@ -62,6 +79,7 @@ public:
 	static const int MAX_X = 10;		// gameboard x dimension
 	static const int MAX_Y = 19;		// gameboard y dimension
 	static const int EMPTY_BLOCK = -1;	// contents of an empty block
+	static const int MAX_CHANGES = 48;	// changes the journal holds before it overflows
 
 private:
 	// MEMBER VARIABLES -------------------------------------------------
@@ -70,7 +88,14 @@ private:
 	//  ([0][0] is top left, [MAX_Y-1][MAX_X-1] is bottom right) 
 	int grid[MAX_Y][MAX_X];
 	// the gameboard offset to spawn a new tetromino at.
-	const Point spawnLoc{ MAX_X / 2, 0 };
+	//   (not const, so that a Gameboard can be assigned to restore a snapshot)
+	Point spawnLoc{ MAX_X / 2, 0 };
+
+	// the change journal: what changed since the last clearChanges(), in order.
+	//   Lets renderers, encoders, etc. do O(changes) work instead of scanning the grid.
+	BoardChange changes[MAX_CHANGES];
+	int changeCount = 0;
+	bool changesOverflowed = false;	// true if changes were lost (consumers must rescan)
 
 public:
 	// MEMBER FUNCTIONS
@@ -83,7 +108,8 @@ public:
 	// return the content at an x,y grid loc (assert the point is valid)
 	int getContent(int x, int y) const;			
 
-	Point getSpawnLoc();
+	// return the gameboard offset to spawn a new tetromino at
+	Point getSpawnLoc() const;
 
 	// set the content at a given point (only if the point is valid)
 	void setContent(const Point& pt, int content);	
@@ -100,17 +126,47 @@ public:
 	//   Testing invalid points would likely result in an out of bounds
 	//     error or segmentation fault!
 	//   If none of the points are valid, return true
-	bool areLocsEmpty(std::vector<Point> locs) const;
+	bool areLocsEmpty(const std::vector<Point> &locs) const;
+	bool areLocsEmpty(const BlockLocs &locs) const;
 												
 	// removes all completed rows from the board
-	//   use getCompletedRowIndices() and removeRows() 
+	//   (top to bottom, like removeRows(getCompletedRowIndices()), but without
+	//   building the vector: this runs every time a shape locks)
 	//   return the # of completed rows removed
 	int removeCompletedRows();			
 												
 	// fill the board with EMPTY_BLOCK 
 	//   (iterate through each rowIndex and fillRow() with EMPTY_BLOCK))
-	void empty();																					
+	void empty();
+
+	// push every row up count rows (the top count rows are lost) and fill the
+	//   bottom count rows with content, except for a hole at holeX (garbage rows)
+	//   The journal can't describe the shift, so it is marked as overflowed.
+	//   return false if a lost row had blocks in it
+	bool raiseRows(int count, int content, int holeX);
+
+	// the occupied cells of row y as bits (bit x is set if x,y isn't EMPTY_BLOCK)
+	//   (for minimaps & bots, which only need to know what's filled)
+	std::uint16_t getRowMask(int y) const;
 	
+	// Change journal ---------------------------------------------------
+	// setContent(), removeRows() and empty() record what they changed.
+	// Consumers read the journal, and the board's owner clears it once per
+	// tick after they have (TetrisEngine::step() clears it before each tick).
+
+	// the number of changes recorded since the last clearChanges()
+	int getChangeCount() const;
+	// a recorded change (0 is the oldest)
+	const BoardChange& getChange(int index) const;
+	// true if the journal overflowed (or was invalidated) - changes were lost,
+	//   so consumers must rescan the whole board.
+	bool haveChangesOverflowed() const;
+	// forget every recorded change
+	void clearChanges();
+	// forget every recorded change and mark the journal as overflowed
+	//   (eg: after restoring a snapshot, when the journal no longer describes the board)
+	void invalidateChanges();
+
 	// print the grid contents to the console (for debugging purposes)
 	//   use std::setw(2) to space the contents out (#include <iomanip>).
 	void printToConsole() const;				
@@ -154,6 +210,9 @@ private:
 	
 	// return true if the x,y location is on the grid, false otherwise
 	bool isValidPoint(int x, int y) const;
+
+	// append a change to the journal (or flag an overflow if it is full)
+	void recordChange(BoardChange::Type type, int x, int y, int content);
 				
 };
 
@@ -35,12 +35,13 @@ public:
 	//	(0,1) represents a move down (y+1)
 	void move(int xOffset, int yOffset);	
 
-	// build and return a vector of Points to represent our inherited
+	// build and return a list of Points to represent our inherited
 	// blockLocs vector mapped to the gridLoc of this object instance.
 	// You will need to provide this class access to blockLocs (from the Tetromino class).
 	// eg: if we have a Point [x,y] in our vector,
 	// and our gridLoc is [5,6] the mapped Point would be [5+x,6+y].
-	std::vector<Point> getBlockLocsMappedToGrid() const;
+	//   (a BlockLocs, so this doesn't allocate)
+	BlockLocs getBlockLocsMappedToGrid() const;
 
 };
 
@@ -0,0 +1,88 @@
+// The InputThread samples the keyboard on its own thread, about POLL_HZ times a
+// second, and sends every button press & release to the game as a timestamped
+// InputEvent through a lock-free SPSC queue.
+//
+// Polling window events once per rendered frame means a key is only seen at the
+// next frame boundary (up to 33ms late at 30 FPS), and the game can't tell when
+// within the frame it went down.  With the timestamps, the main loop applies
+// each event on the simulation step it happened in (see main.cpp).
+//
+// SFML's window events can only be read on the thread that created the window,
+// so this thread reads the real-time keyboard state (sf::Keyboard::isKeyPressed)
+// instead, and turns changes into events.  The main thread still handles the
+// window events, and tells this thread when the window gains or loses focus
+// (keys aren't read without focus, and held buttons are released when it's lost).
+//
+// Only presses & releases are sent: holding a button down auto-repeats inside
+// the simulation (TetrisEngine::step()), at the same rate whatever the OS does.
+//
+//  [expected .cpp size: ~ 115 lines]
+
+#ifndef INPUTTHREAD_H
+#define INPUTTHREAD_H
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <SFML/System/Clock.hpp>
+#include "SpscQueue.h"
+#include "TetrisEngine.h"
+
+// a button going down or up, at a time on the main clock
+struct InputEvent
+{
+	double time = 0;			// seconds, on the clock given to the InputThread
+	InputButton button = BUTTON_ROTATE;
+	bool pressed = false;	// true: pressed, false: released
+};
+
+class InputThread
+{
+public:
+	// STATIC CONSTANTS
+	static const int POLL_HZ = 1000;		// keyboard samples per second
+	typedef SpscQueue<InputEvent, 256> Queue;
+
+	// MEMBER FUNCTIONS
+
+	// constructor
+	//   clock: the event timestamps are clock.getElapsedTime() (it must outlive the thread)
+	explicit InputThread(const sf::Clock &clock);
+
+	// destructor: stop()
+	~InputThread();
+
+	InputThread(const InputThread&) = delete;
+	InputThread& operator=(const InputThread&) = delete;
+
+	void start();
+	void stop();
+
+	// should the keyboard be read? (only while the game window has focus)
+	void setFocused(bool focused);
+
+	// the events, oldest first (only the main thread may pop them)
+	Queue& getQueue();
+
+	// events dropped because the queue was full
+	std::uint64_t getDroppedEvents() const;
+
+private:
+	// sample the keyboard until stop()
+	void run();
+
+	// the time on the clock, in seconds
+	double now() const;
+
+	void pushEvent(double time, InputButton button, bool pressed);
+
+	// MEMBER VARIABLES
+	const sf::Clock &clock;
+	std::thread thread;
+	std::atomic<bool> running{ false };
+	std::atomic<bool> focused{ true };
+	std::atomic<std::uint64_t> droppedEvents{ 0 };
+	Queue queue;
+};
+
+#endif /* INPUTTHREAD_H */
@@ -0,0 +1,108 @@
+// Input-to-photon latency measurement.
+//
+// A LatencyHistogram counts durations into fixed BUCKET_SECONDS wide buckets
+// (up to MAX_SECONDS, longer ones go in an overflow bucket), so recording is
+// O(1), never allocates and can stay on in normal builds.  Percentiles are read
+// from the buckets (to within a bucket's width), the max is kept exactly.
+//
+// A LatencyTracker splits the latency of each button press into its stages,
+// all measured on the same clock as the InputEvent timestamps:
+//   captured (InputThread) -> applied (TetrisGame::onInputEvent(), before the
+//   step it happened in) -> presented (window.display() returned for the
+//   first frame drawn after it was applied)
+// so a regression shows up in the stage that caused it: input polling & the
+// queue (inputToApply), simulation & rendering (applyToPresent), or both
+// (inputToPresent, the end-to-end latency).
+// window.display() returning is the closest the game can see to the photons:
+// the display's scan-out still comes after it.
+//
+//  [expected .cpp size: ~ 140 lines]
+
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+class LatencyHistogram
+{
+public:
+	// STATIC CONSTANTS
+	static constexpr double BUCKET_SECONDS = 0.00025;		// 0.25ms per bucket
+	static const int BUCKET_COUNT = 1000;							// so the buckets cover 0 to MAX_SECONDS
+	static constexpr double MAX_SECONDS = BUCKET_SECONDS * BUCKET_COUNT;
+
+	// MEMBER FUNCTIONS
+
+	// count one duration (negative durations count as 0)
+	void record(double seconds);
+
+	// forget everything recorded
+	void reset();
+
+	std::uint64_t getCount() const;
+	double getMaxSeconds() const;
+	double getMeanSeconds() const;
+
+	// the duration that fraction (0 to 1) of the recorded durations are at or
+	//   below (the top of its bucket, or the max if it is in the overflow bucket)
+	//   return 0 if nothing has been recorded
+	double getPercentileSeconds(double fraction) const;
+
+	// one line: "name: p50 12.25ms p99 20.50ms max 23.10ms (120 samples)"
+	std::string getSummary(const std::string &name) const;
+
+	// the summary, then "<bucket top in ms> <count>" for each non-empty bucket
+	void writeReport(std::ostream &out, const std::string &name) const;
+
+private:
+	// MEMBER VARIABLES
+	std::uint32_t buckets[BUCKET_COUNT] = {};
+	std::uint32_t overflow = 0;				// durations longer than MAX_SECONDS
+	std::uint64_t count = 0;
+	double totalSeconds = 0;
+	double maxSeconds = 0;
+};
+
+class LatencyTracker
+{
+public:
+	// STATIC CONSTANTS
+	static const int MAX_PENDING = 64;		// applied presses waiting for a frame (more are not timed)
+
+	// MEMBER FUNCTIONS
+
+	// a press captured at capturedTime was applied to the game at appliedTime
+	void onApplied(double capturedTime, double appliedTime);
+
+	// a frame was presented at presentedTime: every press applied before it is shown
+	void onPresented(double presentedTime);
+
+	// forget everything recorded (pending presses are kept)
+	void reset();
+
+	const LatencyHistogram& getInputToApply() const;
+	const LatencyHistogram& getApplyToPresent() const;
+	const LatencyHistogram& getInputToPresent() const;
+
+	// each stage's histogram report (see LatencyHistogram::writeReport())
+	void writeReport(std::ostream &out) const;
+
+private:
+	// a press applied but not shown yet
+	struct PendingPress
+	{
+		double capturedTime;
+		double appliedTime;
+	};
+
+	// MEMBER VARIABLES
+	LatencyHistogram inputToApply;
+	LatencyHistogram applyToPresent;
+	LatencyHistogram inputToPresent;
+	PendingPress pending[MAX_PENDING];
+	int pendingCount = 0;
+};
+
+#endif /* LATENCYHISTOGRAM_H */
@@ -0,0 +1,59 @@
+// The LoopbackChannel class is an in-memory, one-way, unreliable packet link.
+// It stands in for a UDP socket when testing netcode on a single machine:
+//   - every packet is delayed by a base latency plus a random jitter,
+//   - packets may therefore arrive out of order,
+//   - a fraction of packets is lost outright.
+// Time is passed in explicitly (seconds), so a test can simulate minutes of play
+// in milliseconds and always get the same (seeded) network conditions.
+//
+//  [expected .cpp size: ~ 70 lines]
+
+#ifndef LOOPBACKCHANNEL_H
+#define LOOPBACKCHANNEL_H
+
+#include <cstdint>
+#include <vector>
+
+class LoopbackChannel
+{
+public:
+	// MEMBER FUNCTIONS
+
+	// constructor
+	//   latency & jitter in seconds, lossRate in [0,1]
+	LoopbackChannel(double latency, double jitter, double lossRate, std::uint32_t seed = 1);
+
+	// send a packet at time 'now' (it may be dropped)
+	void send(const std::vector<std::uint8_t> &packet, double now);
+
+	// receive the earliest packet that has arrived by time 'now'
+	//   return false if no packet has arrived yet.
+	bool receive(std::vector<std::uint8_t> &packet, double now);
+
+	// counters
+	int getSentCount() const;
+	int getDroppedCount() const;
+
+private:
+	// return a uniform random number in [0,1)
+	double nextUniform();
+
+	// a packet in flight and the time it arrives
+	struct InFlight
+	{
+		double arrivalTime;
+		std::vector<std::uint8_t> data;
+	};
+
+	// MEMBER VARIABLES
+	double latency;
+	double jitter;
+	double lossRate;
+	std::uint32_t rngState;
+
+	std::vector<InFlight> inFlight;	// packets sent but not yet received
+	int sentCount = 0;
+	int droppedCount = 0;
+};
+
+#endif /* LOOPBACKCHANNEL_H */
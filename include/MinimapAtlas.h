@@ -0,0 +1,60 @@
+// A MinimapAtlas is one image holding a tiny picture of many boards: one pixel
+// per cell, each board in its own cell of a grid.
+//
+// update() redraws a board's pixels from its occupancy bitmasks
+// (Gameboard::getRowMask()), so a hundred boards cost a couple of thousand
+// bit tests a frame.  The whole atlas is uploaded as one texture and drawn as
+// one (scaled up) quad: every minimap in a single draw call (see
+// GameView::addMinimaps()).
+//
+// Each board can be marked (eg: as the player's target, or knocked out), which
+// tints its blocks.  Cells are separated by a transparent pixel.
+//
+//  [expected .cpp size: ~ 75 lines]
+
+#ifndef MINIMAPATLAS_H
+#define MINIMAPATLAS_H
+
+#include <cstdint>
+#include <vector>
+#include "Gameboard.h"
+
+// how a minimap's blocks are tinted
+enum MinimapMark {
+	MINIMAP_PLAYING,			// light grey
+	MINIMAP_TARGET,				// red (eg: the player's target)
+	MINIMAP_KNOCKED_OUT		// dark grey
+};
+
+class MinimapAtlas
+{
+public:
+	// STATIC CONSTANTS
+	static const int CELL_WIDTH = Gameboard::MAX_X + 1;		// a board's pixels, and a gap
+	static const int CELL_HEIGHT = Gameboard::MAX_Y + 1;
+
+	// MEMBER FUNCTIONS
+
+	// constructor
+	//   room for count boards, columns to a row (every pixel transparent)
+	MinimapAtlas(int count, int columns);
+
+	// redraw board index's pixels from board
+	void update(int index, const Gameboard &board, MinimapMark mark);
+
+	// the atlas: getWidth() x getHeight() RGBA pixels, row by row
+	const std::uint8_t* getPixels() const;
+	int getWidth() const;
+	int getHeight() const;
+	int getCount() const;
+
+private:
+	// MEMBER VARIABLES
+	int count;
+	int columns;
+	int width;
+	int height;
+	std::vector<std::uint8_t> pixels;
+};
+
+#endif /* MINIMAPATLAS_H */
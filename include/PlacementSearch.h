@@ -0,0 +1,80 @@
+// PlacementSearch finds where a shape could be placed on a board, and how good
+// each placement would be.  Bots play its best placement; a coach can compare
+// a player's placements with it.
+//
+// A placement is reached the simple way a bot plays: from where the shape is,
+// rotate it in place, shift it sideways, then drop it.  Every move is checked
+// with the engine's rules (inside the left, right & bottom borders, on empty
+// cells), so a placement that is found can be played.
+//
+// The board the placement leaves (after locking & clearing rows) is scored
+// with a weighted sum of a few features, in the spirit of the classic
+// hand-tuned Tetris AIs:
+//   + rows cleared, - aggregate column height, - holes (empty cells under a
+//   block), - bumpiness (height differences between neighbouring columns),
+//   and a shape left sticking out of the top costs far more than anything else.
+// Higher is better.  Everything works on copies: nothing here changes a game.
+//
+//  [expected .cpp size: ~ 175 lines]
+
+#ifndef PLACEMENTSEARCH_H
+#define PLACEMENTSEARCH_H
+
+#include <vector>
+#include "Gameboard.h"
+#include "GridTetromino.h"
+
+// where a shape ends up: rotated so many quarter turns clockwise from where
+//   it is, with its grid loc at x (and the y it drops to)
+struct Placement
+{
+	bool found = false;			// false: there's nowhere legal to place it
+	int rotations = 0;			// quarter turns from the shape's current rotation (0-3)
+	int x = 0;							// the shape's grid loc x after the shift
+	int y = 0;							// the shape's grid loc y after the drop
+	int rowsCleared = 0;
+	double score = 0;				// how good the board it leaves is (higher is better)
+};
+
+// how much each board feature counts
+struct PlacementWeights
+{
+	double rowsCleared = 0.76;
+	double aggregateHeight = -0.51;
+	double holes = -0.36;
+	double bumpiness = -0.18;
+	double toppedOut = -1000;		// a shape locked (partly) above the top: all but game over
+};
+
+class PlacementSearch
+{
+public:
+	// MEMBER FUNCTIONS (all static: the search keeps no state)
+
+	// is the shape inside the left, right & bottom borders, on empty cells?
+	//   (the engine's rule: the top is open, so shapes can spawn above it)
+	static bool isLegal(const Gameboard &board, const GridTetromino &shape);
+
+	// rotate the shape in place, shift it to x, then drop it (as a bot would)
+	//   return false (and leave shape part way) if a move on the way is illegal
+	static bool reach(const Gameboard &board, GridTetromino &shape, int rotations, int x);
+
+	// lock shape (at its grid loc) on board & clear the completed rows
+	//   return the number of rows cleared
+	static int place(Gameboard &board, const GridTetromino &shape);
+
+	// score a board (higher is better, see the top)
+	static double evaluate(const Gameboard &board, int rowsCleared, const PlacementWeights &weights = PlacementWeights());
+
+	// every placement reachable from where the shape is (one per distinct
+	//   rotation & column), scored.  placements is cleared first
+	static void findAll(const Gameboard &board, const GridTetromino &shape, std::vector<Placement> &placements,
+		const PlacementWeights &weights = PlacementWeights());
+
+	// the best placement reachable from where the shape is
+	//   (found is false if there is none)
+	static Placement findBest(const Gameboard &board, const GridTetromino &shape,
+		const PlacementWeights &weights = PlacementWeights());
+};
+
+#endif /* PLACEMENTSEARCH_H */
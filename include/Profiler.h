@@ -0,0 +1,163 @@
+// The Profiler times the phases of each frame (polling events, simulating,
+// drawing, displaying) and the engine's hot functions, to see where the frame
+// time goes on slow machines.
+//
+// Code is timed with a scope:
+//     PROFILE_SCOPE("tick");
+// which records how long the rest of the enclosing block took.  The scopes only
+// exist in profiling builds (TETRIS_PROFILE defined, see "make profile"):
+// otherwise PROFILE_SCOPE() expands to nothing and costs nothing.
+//
+// Each thread records its samples into its own lock-free SpscQueue, so timing
+// never takes a lock (only a thread's first sample registers its queue).  Once
+// per frame, one thread (main) collect()s every queue into:
+//   - the trace: every sample, written as Chrome trace_event JSON (open it in
+//     chrome://tracing or https://ui.perfetto.dev) with writeChromeTrace(),
+//   - the phase stats: each name's mean & max milliseconds per frame over the
+//     last STATS_FRAMES frames, for an on-screen overlay (getPhaseLines()).
+// Samples that don't fit (a full queue or trace) are dropped and counted.
+// Scopes nest (a "tick" inside "simulate"): each name is timed inclusively.
+//
+//  [expected .cpp size: ~ 220 lines]
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "SpscQueue.h"
+
+#ifdef TETRIS_PROFILE
+#define PROFILE_CONCATENATE_(a, b) a##b
+#define PROFILE_CONCATENATE(a, b) PROFILE_CONCATENATE_(a, b)
+// time the rest of the enclosing block as name (a string literal)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCATENATE(profileScope, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#endif
+
+// one timed scope
+struct ProfileSample
+{
+	const char *name = nullptr;						// a string literal
+	std::uint64_t startNanoseconds = 0;		// since the profiler was created
+	std::uint64_t durationNanoseconds = 0;
+	std::uint32_t thread = 0;							// the order threads first recorded in
+};
+
+class Profiler
+{
+public:
+	// STATIC CONSTANTS
+	static const std::size_t THREAD_CAPACITY = 4096;				// samples a thread can hold between collect()s
+	static const std::size_t MAX_TRACE_SAMPLES = 1 << 20;	// the trace stops growing here
+	static const int MAX_PHASES = 32;												// names with phase stats
+	static const int STATS_FRAMES = 60;											// frames the phase stats are taken over
+
+	// MEMBER FUNCTIONS
+
+	// the profiler the PROFILE_SCOPE()s record to
+	static Profiler& global();
+
+	Profiler();
+	Profiler(const Profiler&) = delete;
+	Profiler& operator=(const Profiler&) = delete;
+
+	// nanoseconds since this profiler was created (steady clock)
+	std::uint64_t now() const;
+
+	// record a sample on the calling thread's queue (any thread)
+	void record(const char *name, std::uint64_t startNanoseconds, std::uint64_t durationNanoseconds);
+
+	// move every thread's samples into the trace & this frame's phase stats
+	//   (one thread only, eg: main, once per frame)
+	void collect();
+
+	// finish a frame's phase stats (after its collect())
+	void endFrame();
+
+	// one line per phase: "name  mean  max" (milliseconds per frame), slowest first
+	//   (lines is cleared first)
+	void getPhaseLines(std::vector<std::string> &lines) const;
+
+	// write the collected trace as Chrome trace_event JSON
+	void writeChromeTrace(std::ostream &out) const;
+
+	// forget the trace & phase stats (not the samples waiting to be collected)
+	void clear();
+
+	std::size_t getTraceSize() const;
+	std::uint64_t getDroppedSamples() const;
+
+private:
+	typedef SpscQueue<ProfileSample, THREAD_CAPACITY> Queue;
+
+	// a thread's samples, waiting to be collected
+	struct ThreadBuffer
+	{
+		std::uint32_t thread = 0;
+		std::atomic<std::uint64_t> dropped{ 0 };	// samples that didn't fit in the queue
+		Queue queue;
+	};
+
+	// a name's time per frame
+	struct Phase
+	{
+		const char *name = nullptr;
+		std::uint64_t frameNanoseconds = 0;		// this frame so far
+		std::uint64_t totalNanoseconds = 0;		// this stats window so far
+		std::uint64_t maxNanoseconds = 0;
+		double shownMeanMilliseconds = 0;			// the last complete stats window
+		double shownMaxMilliseconds = 0;
+	};
+
+	// the calling thread's buffer (registered on its first call)
+	ThreadBuffer& getThreadBuffer();
+
+	// the phase for name (nullptr if there are MAX_PHASES already)
+	Phase* findPhase(const char *name);
+
+	// MEMBER VARIABLES
+	const std::uint64_t id;											// tells the threads' cached buffers apart
+	const std::uint64_t startNanoseconds;				// steady clock at creation
+
+	mutable std::mutex threadsMutex;						// guards threads (taken to register one, & by collect())
+	std::vector<std::unique_ptr<ThreadBuffer>> threads;
+
+	std::vector<ProfileSample> trace;
+	std::uint64_t traceDropped = 0;							// samples that didn't fit in the trace
+	Phase phases[MAX_PHASES];
+	int phaseCount = 0;
+	int statsFrames = 0;												// frames in this stats window
+};
+
+// times its own lifetime into the global profiler (use PROFILE_SCOPE())
+class ProfileScope
+{
+public:
+	explicit ProfileScope(const char *name)
+	:name(name), start(Profiler::global().now())
+	{
+	}
+
+	~ProfileScope()
+	{
+		Profiler &profiler = Profiler::global();
+		profiler.record(name, start, profiler.now() - start);
+	}
+
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+	const char *name;
+	std::uint64_t start;
+};
+
+#endif /* PROFILER_H */
@@ -0,0 +1,114 @@
+// The ResourceCache loads the game's assets (textures, fonts & sound buffers)
+// once, and shares them between everything that uses them.
+//
+// Each asset is loaded by path the first time it is asked for, and handed out
+// as a reference counted shared_ptr (see AssetTable).  So however many games a
+// process runs, there is one tiles texture, one score font and one buffer per
+// sound effect: startup time and memory don't grow with the number of games.
+//
+// preload() loads a list of assets on a background thread, so main can show a
+// splash screen meanwhile (getPreloadProgress()).  Only the work that needs no
+// OpenGL context happens there: images are decoded, fonts & sounds loaded.
+// The decoded images become textures when getTexture() is first called, on
+// the calling (rendering) thread; that's just an upload.
+//
+// A failed load is reported once on std::cerr, and listed by getFailures();
+// the get functions return nullptr for it.
+//
+// With an AssetArchive (setArchive()), assets are taken from its mapping
+// rather than from assets/: images are already decoded, so a texture is
+// uploaded straight from the mapped pixels, and fonts & sounds are read from
+// memory.  (Assets missing from the archive are still loaded from their files.)
+// An sf::Font reads the memory it was loaded from for as long as it lives, so
+// the fonts mustn't outlive the cache.
+//
+//  [expected .cpp size: ~ 200 lines]
+
+#ifndef RESOURCECACHE_H
+#define RESOURCECACHE_H
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <SFML/Audio.hpp>
+#include <SFML/Graphics.hpp>
+#include "AssetArchive.h"
+#include "AssetTable.h"
+
+class ResourceCache
+{
+public:
+	// MEMBER FUNCTIONS
+
+	// constructor
+	//   set up the loaders (nothing is loaded yet)
+	ResourceCache();
+
+	// destructor: waitForPreload()
+	~ResourceCache();
+
+	ResourceCache(const ResourceCache&) = delete;
+	ResourceCache& operator=(const ResourceCache&) = delete;
+
+	// take the assets from archive (nullptr: from their files).  Call it before
+	//   loading anything
+	void setArchive(std::shared_ptr<const AssetArchive> archive);
+
+	// the archived asset at path (data is nullptr if there is no archive, or
+	//   it isn't in it).  For assets that aren't cached, like streamed music
+	AssetView findPacked(const std::string &path) const;
+
+	// the texture of the image at path (eg: "assets/images/tiles.png")
+	//   call it on the rendering thread.  nullptr if it failed to load
+	std::shared_ptr<const sf::Texture> getTexture(const std::string &path);
+
+	// the font at path (eg: "assets/fonts/RedOctober.ttf")
+	//   nullptr if it failed to load
+	std::shared_ptr<const sf::Font> getFont(const std::string &path);
+
+	// the decoded sound at path (eg: "assets/sfx/blockDrop.ogg")
+	//   nullptr if it failed to load
+	std::shared_ptr<const sf::SoundBuffer> getSoundBuffer(const std::string &path);
+
+	// start loading paths on a background thread (by extension: .png/.jpg/.bmp
+	//   images, .ttf/.otf fonts, .ogg/.wav/.flac sounds; anything else is reported
+	//   & skipped).
+	//   A get() of an asset it is still loading waits for it.
+	//   Waits for an earlier preload() to finish first.
+	void preload(const std::vector<std::string> &paths);
+
+	// is a preload() still running?
+	bool isPreloading() const;
+
+	// the fraction of the last preload() done (0 to 1; 1 if there was none)
+	float getPreloadProgress() const;
+
+	// wait for the preload() (if any) to finish
+	void waitForPreload();
+
+	// the paths that failed to load (each once)
+	std::vector<std::string> getFailures() const;
+
+	// drop the assets nothing outside the cache holds
+	//   return how many were dropped
+	int purge();
+
+private:
+	// load one path on the preload thread (see preload())
+	void preloadOne(const std::string &path);
+
+	// MEMBER VARIABLES
+	std::shared_ptr<const AssetArchive> archive;	// where the assets are packed (nullptr: none)
+	AssetTable<sf::Image> images;							// decoded, waiting to become textures
+	AssetTable<sf::Texture> textures;
+	AssetTable<sf::Font> fonts;
+	AssetTable<sf::SoundBuffer> soundBuffers;
+
+	std::thread preloader;										// the preload() thread
+	std::atomic<int> preloadCount{ 0 };				// paths in the last preload()
+	std::atomic<int> preloadDone{ 0 };				// how many of them are loaded (or failed)
+};
+
+#endif /* RESOURCECACHE_H */
@@ -0,0 +1,111 @@
+// The RollbackSession class runs one peer's side of a 2 player versus match
+// using rollback (GGPO style) netcode instead of lockstep.
+//
+// Both peers simulate both players' engines.  Each frame:
+//   - the local player's input is known immediately,
+//   - the remote player's input is *predicted* (we assume they are still holding
+//     whatever they held in the last frame we heard about),
+//   - the frame is simulated straight away, so a late packet never stalls the game.
+// When the real remote inputs arrive (receiveInputPacket()) and they differ from
+// what was predicted, the engines are restored from the snapshot taken before
+// the first mispredicted frame and every frame since is re-simulated (headless)
+// with the corrected inputs - all inside the current render frame.
+//
+// Only if the remote peer falls more than MAX_PREDICTION_FRAMES behind does
+// advanceFrame() refuse to run (a "stall"), which bounds the rollback depth.
+//
+// Packets are plain bytes so any transport (UDP socket, LoopbackChannel) can carry
+// them.  Each packet re-sends every local input the remote has not acknowledged,
+// so a lost packet is repaired by the next one.
+//
+//  [expected .cpp size: ~ 200 lines]
+
+#ifndef ROLLBACKSESSION_H
+#define ROLLBACKSESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "TetrisEngine.h"
+
+// running totals describing how much rollback work a session has done
+struct RollbackStats
+{
+	std::uint32_t framesSimulated = 0;		// frames advanced by advanceFrame()
+	std::uint32_t stalls = 0;							// advanceFrame() calls refused (remote too far behind)
+	std::uint32_t rollbacks = 0;					// number of mispredictions corrected
+	std::uint32_t framesResimulated = 0;	// frames re-simulated by all rollbacks
+	int maxRollbackDepth = 0;							// the deepest single rollback (in frames)
+	double rollbackSeconds = 0.0;					// CPU (wall) time spent restoring & re-simulating
+};
+
+class RollbackSession
+{
+	friend class TestSuite;
+public:
+	// STATIC CONSTANTS
+	static const int PLAYER_COUNT = 2;
+	static const int MAX_PREDICTION_FRAMES = 12;	// how far past the last confirmed remote input we may simulate
+	static const int HISTORY_SIZE = 32;						// frames of inputs & snapshots kept (> 2 * MAX_PREDICTION_FRAMES)
+	static const std::size_t PACKET_HEADER_SIZE = 9;	// startFrame (4) + ackFrame (4) + count (1)
+
+	// MEMBER FUNCTIONS
+
+	// constructor
+	//   localPlayer is 0 or 1, both peers must use the same seed
+	RollbackSession(int localPlayer, std::uint32_t seed);
+
+	// record the local input for the next frame and simulate that frame.
+	//   return false (and do nothing) if the remote peer is too far behind.
+	bool advanceFrame(InputMask localInput);
+
+	// build the packet to send to the remote peer.
+	//   contains every local input the remote has not acknowledged yet,
+	//   and acknowledges the remote inputs we have received.
+	std::vector<std::uint8_t> buildInputPacket() const;
+
+	// handle a packet from the remote peer.
+	//   confirms remote inputs and rolls back if any prediction was wrong.
+	//   return false if the packet was malformed.
+	bool receiveInputPacket(const std::uint8_t *data, std::size_t size);
+
+	// the engine of a given player (0 or 1)
+	const TetrisEngine& getEngine(int player) const;
+
+	// the number of frames simulated so far (the next frame to simulate)
+	int getFrame() const;
+
+	// the newest frame for which the remote input is known (-1 if none)
+	int getConfirmedFrame() const;
+
+	const RollbackStats& getStats() const;
+
+private:
+	// the remote input to use for a frame: confirmed if we have it,
+	//   otherwise predicted (repeat the newest confirmed input).
+	InputMask getRemoteInput(int frame) const;
+
+	// snapshot the engines, then step both with the local & remote inputs of a frame
+	void simulateFrame(int frame);
+
+	// restore the snapshot taken before a frame, and re-simulate up to currentFrame
+	void rollbackTo(int frame);
+
+	// MEMBER VARIABLES
+	int localPlayer;
+	TetrisEngine engines[PLAYER_COUNT];
+
+	// ring buffers indexed by frame % HISTORY_SIZE
+	TetrisEngine snapshots[HISTORY_SIZE][PLAYER_COUNT];	// engine state *before* a frame ran
+	InputMask localInputs[HISTORY_SIZE];								// local input of a frame
+	InputMask remoteInputs[HISTORY_SIZE];								// confirmed remote input of a frame
+	InputMask usedRemoteInputs[HISTORY_SIZE];						// remote input that frame was simulated with
+
+	int currentFrame = 0;					// the next frame to simulate
+	int confirmedFrame = -1;			// newest contiguous confirmed remote frame
+	int remoteAckFrame = -1;			// newest local frame the remote has confirmed receiving
+
+	RollbackStats stats;
+};
+
+#endif /* ROLLBACKSESSION_H */
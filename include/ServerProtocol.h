@@ -0,0 +1,40 @@
+// The messages exchanged between the GameServer and its clients.
+// Every message is a single UDP datagram built with sf::Packet, starting with
+// a ServerMessage type (sf::Uint8).
+//
+//  client -> server
+//    MSG_JOIN    roomId:Uint32 nonce:Uint32                   join (or create) a room
+//                                                             (re-send with the same nonce if no reply)
+//    MSG_INPUT   token:Uint32 frame:Uint32 buttons:Uint8      buttons held on a frame
+//  server -> client
+//    MSG_JOINED  roomId:Uint32 token:Uint32 slot:Uint8 nonce:Uint32
+//    MSG_STATE   roomId:Uint32 frame:Uint32, then per player:
+//                  score:Int32 shape:Uint8 x:Int8 y:Int8     the authoritative game
+//    MSG_REJECT  reason:Uint8
+//
+// A player who sends nothing for GameServer::PLAYER_TIMEOUT_FRAMES is dropped
+// (its token stops working), and a room is closed when its last player goes.
+//
+// Rooms are sharded across the server's workers: room R lives on the worker
+// listening on port (basePort + R % workerCount).
+
+#ifndef SERVERPROTOCOL_H
+#define SERVERPROTOCOL_H
+
+enum ServerMessage {
+	MSG_JOIN = 1,
+	MSG_JOINED,
+	MSG_INPUT,
+	MSG_STATE,
+	MSG_REJECT
+};
+
+enum RejectReason {
+	REJECT_ROOM_FULL = 1,
+	REJECT_WRONG_SHARD,
+	REJECT_UNKNOWN_PLAYER,
+	REJECT_BAD_INPUT,
+	REJECT_SERVER_FULL		// the worker hosts as many rooms as it may (see GameServer)
+};
+
+#endif /* SERVERPROTOCOL_H */
@@ -0,0 +1,94 @@
+// The SessionHost runs several independent TetrisGames in one process and one
+// window (local multiplayer, a bot exhibition, a kiosk wall of demo games).
+//
+// Each frame, step() steps every game once on a WorkerPool (the games share no
+// gameplay state, so they step in parallel), and draw() draws each game in its
+// own viewport of the window: the games are laid out in a grid of cells, each
+// scaled (keeping the game's 640x800 shape) from the single game's layout.  So
+// the games themselves don't know they share the window.  The grid fills the
+// whole window, or just an area of it (leaving room for eg: a battle royale's
+// minimaps).
+//
+// Games that no one is playing are autoplayed (setAutoplay()): they hold a
+// repeatable pseudo random pattern of buttons, different for each game, which
+// keeps every engine path busy.  (A played game takes its input from the caller
+// as before, through getGame(index).onInputEvent().)
+//
+// Only one game may have an AudioSystem (its queue has one producer); the pool
+// finishes each batch before the next, so posts from different workers don't
+// overlap.
+//
+//  [expected .cpp size: ~ 175 lines]
+
+#ifndef SESSIONHOST_H
+#define SESSIONHOST_H
+
+#include <memory>
+#include <vector>
+#include <SFML/Graphics.hpp>
+#include "ResourceCache.h"
+#include "TetrisGame.h"
+#include "WorkerPool.h"
+
+class SessionHost
+{
+public:
+	// STATIC CONSTANTS
+	static const int GAME_WIDTH = 640;		// the pixel size of one game's layout (see main.cpp)
+	static const int GAME_HEIGHT = 800;
+
+	// MEMBER FUNCTIONS
+
+	// constructor
+	//   set up gameCount games (each seeded by rand()), laid out on window
+	//   the offsets place the board & next shape in a game's layout (see TetrisGame)
+	//   the sprites, resources & pool are shared by every game (and must outlive it)
+	//   area: the part of the window (0 to 1) to lay the games out in
+	SessionHost(sf::RenderWindow &window, sf::Sprite &blockSprite, sf::Sprite &backgroundSprite,
+		Point gameboardOffset, Point nextShapeOffset, ResourceCache &resources, WorkerPool &pool, int gameCount,
+		sf::FloatRect area = sf::FloatRect(0, 0, 1, 1));
+
+	SessionHost(const SessionHost&) = delete;
+	SessionHost& operator=(const SessionHost&) = delete;
+
+	// a window size that fits gameCount games in maxSize (as big as it can, up
+	//   to the games' own size), in a grid as square as it can be
+	static sf::Vector2u getWindowSize(int gameCount, sf::Vector2u maxSize);
+
+	int getGameCount() const;
+	TetrisGame& getGame(int index);
+
+	// autoplay a game (see the top), or hand it back to the caller's input
+	void setAutoplay(int index, bool enabled);
+
+	// step every game once, in parallel (see TetrisGame::step())
+	void step();
+
+	// draw every game (the background too) in its viewport of the window
+	//   (see TetrisGame::draw()), then restore the window's default view
+	void draw(double secondsAhead);
+
+	// the part of the window (0 to 1) a game is drawn in
+	sf::FloatRect getViewport(int index) const;
+
+	// how long the last step() took (all the games), in seconds
+	double getLastStepSeconds() const;
+
+private:
+	// lay the games' viewports out in a grid on the window (on construction)
+	void layOut();
+
+	// MEMBER VARIABLES
+	sf::RenderWindow &window;
+	sf::Sprite &backgroundSprite;
+	WorkerPool &pool;
+	sf::FloatRect area;									// the part of the window the games are laid out in
+	std::vector<std::unique_ptr<TetrisGame>> games;
+	std::vector<sf::View> views;				// each game's layout, mapped onto its viewport
+	std::vector<bool> autoplayed;
+	int frame = 0;											// step()s so far (for the autoplay pattern)
+	sf::Clock stepClock;
+	double lastStepSeconds = 0;
+};
+
+#endif /* SESSIONHOST_H */
@@ -0,0 +1,60 @@
+// The SfmlDrawListRenderer is the DrawList backend used by the game window.
+//
+//  - Consecutive quads with the same texture are built into one sf::VertexArray
+//    and drawn with a single draw call (so a whole board is one call).
+//  - Text runs are drawn with sf::Text objects that are kept between frames and
+//    only re-laid out when their string changes (eg: the score).
+//
+// The renderer doesn't own its textures or font; they must outlive it.
+//
+//  [expected .cpp size: ~ 100 lines]
+
+#ifndef SFMLDRAWLISTRENDERER_H
+#define SFMLDRAWLISTRENDERER_H
+
+#include <cstring>
+#include <vector>
+#include <SFML/Graphics.hpp>
+#include "DrawList.h"
+
+class SfmlDrawListRenderer
+{
+public:
+	// MEMBER FUNCTIONS
+
+	// constructor
+	SfmlDrawListRenderer();
+
+	// the texture to use for a texture id (nullptr to draw those quads untextured)
+	void setTexture(DrawTextureId id, const sf::Texture *texture);
+
+	// the font for text runs (text runs aren't drawn without one)
+	void setFont(const sf::Font *font);
+
+	// make room to batch this many quads, so drawing lists up to that size never allocates
+	void reserve(std::size_t quadCount);
+
+	// draw a draw list (quads, then text runs) on a target.
+	//   return the number of draw calls it took
+	int render(const DrawList &list, sf::RenderTarget &target);
+
+private:
+	// a text run kept between frames
+	struct CachedText
+	{
+		sf::Text text;
+		char string[DrawText::MAX_LENGTH + 1] = {};
+		int characterSize = 0;
+	};
+
+	// draw the quads in batch and clear it
+	void flushBatch(sf::RenderTarget &target, DrawTextureId texture);
+
+	// MEMBER VARIABLES
+	const sf::Texture *textures[TEXTURE_COUNT] = {};
+	const sf::Font *font = nullptr;
+	sf::VertexArray batch;						// the quads of the current run (storage reused)
+	std::vector<CachedText> texts;		// one per text run index
+};
+
+#endif /* SFMLDRAWLISTRENDERER_H */
@@ -0,0 +1,71 @@
+// The ShaderBoardRenderer draws the locked blocks of a Gameboard with ONE quad,
+// however full the board is.
+//
+//  - The board's content is kept in a tiny texture (one texel per cell, red =
+//    content + 1, 0 = empty), sized up to powers of two (CELL_TEXTURE_WIDTH x
+//    CELL_TEXTURE_HEIGHT) with the board in its top left: a driver without
+//    non-power-of-two textures would pad it anyway, and the shader's texture
+//    coordinates must be relative to the size the texture really has.
+//    Only the cells in the board's change
+//    journal are re-uploaded; a full upload happens when the journal overflowed
+//    or rows were removed.
+//  - A fragment shader (GLSL 1.10, so it also runs on Mesa's software
+//    rasterizer) finds the cell each pixel lands in, reads its content from the
+//    cell texture and samples that color's tile from tiles.png.
+//
+// So the CPU cost per frame is one quad plus the changed cells, which suits very
+// large boards and walls of many small boards.  If shaders aren't available,
+// create() fails and the caller should keep using another render path.
+//
+//  [expected .cpp size: ~ 150 lines]
+
+#ifndef SHADERBOARDRENDERER_H
+#define SHADERBOARDRENDERER_H
+
+#include <SFML/Graphics.hpp>
+#include "Gameboard.h"
+
+class ShaderBoardRenderer
+{
+public:
+	// STATIC CONSTANTS
+	static const int CELL_TEXTURE_WIDTH = 16;		// the board's size, up to powers of two
+	static const int CELL_TEXTURE_HEIGHT = 32;
+	static_assert(CELL_TEXTURE_WIDTH >= Gameboard::MAX_X && (CELL_TEXTURE_WIDTH & (CELL_TEXTURE_WIDTH - 1)) == 0 &&
+		CELL_TEXTURE_HEIGHT >= Gameboard::MAX_Y && (CELL_TEXTURE_HEIGHT & (CELL_TEXTURE_HEIGHT - 1)) == 0,
+		"the cell texture must hold the board, in powers of two");
+
+	// MEMBER FUNCTIONS
+
+	// prepare the cell texture and compile the shader.
+	//   tiles: the block tiles, one blockWidth x blockHeight tile per TetColor, left to right
+	//   return false if shaders aren't available or the shader didn't compile
+	bool create(const sf::Texture &tiles, int blockWidth, int blockHeight);
+
+	// bring the cell texture up to date with the board
+	//   (from the board's change journal, or a full upload if that isn't enough)
+	void update(const Gameboard &board);
+
+	// force a full upload on the next update()
+	//   (call when update() didn't see every change, eg: after using another render path)
+	void invalidate();
+
+	// draw the board with its top left at topLeft (in pixels)
+	void draw(sf::RenderTarget &target, const Point &topLeft) const;
+
+	bool isCreated() const;
+
+private:
+	// upload every cell
+	void uploadAll(const Gameboard &board);
+
+	// MEMBER VARIABLES
+	bool created = false;
+	bool fullUploadNeeded = true;
+	sf::Uint8 cellPixels[Gameboard::MAX_X * Gameboard::MAX_Y * 4] = {};	// RGBA, red = content + 1
+	sf::Texture cellTexture;	// CELL_TEXTURE_WIDTH x CELL_TEXTURE_HEIGHT, one texel per cell (from the top left)
+	sf::Shader shader;				// looks up each cell's tile in the tiles texture
+	sf::VertexArray quad;			// the whole board, texture coords in cells
+};
+
+#endif /* SHADERBOARDRENDERER_H */
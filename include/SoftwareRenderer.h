@@ -0,0 +1,81 @@
+// The SoftwareRenderer is a DrawList backend that runs entirely on the CPU.
+// It needs no window, display or GPU, so it can:
+//   - golden-image test rendering (compare pixels, count batches),
+//   - export replays as numbered PPM/PNG frames on headless machines,
+//   - benchmark render cost reproducibly.
+//
+// Quads are drawn with nearest-neighbour sampling and alpha blending (like SFML
+// with smoothing off).  Text runs use a built-in 5x7 pixel font (digits, A-Z,
+// and a little punctuation; lower case is drawn as upper case), scaled to the
+// run's characterSize - it won't match the game's TTF font, but it is legible
+// and deterministic.
+// The PNG writer stores the image uncompressed (no zlib needed).
+//
+//  [expected .cpp size: ~ 300 lines]
+
+#ifndef SOFTWARERENDERER_H
+#define SOFTWARERENDERER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "DrawList.h"
+
+class SoftwareRenderer
+{
+public:
+	// MEMBER FUNCTIONS
+
+	// constructor
+	//   the size of the frame buffer in pixels
+	SoftwareRenderer(int width, int height);
+
+	// give a texture id its image (copied): width x height RGBA pixels, row by row
+	void setTexture(DrawTextureId id, const std::uint8_t *rgba, int width, int height);
+
+	// fill the whole frame with a color
+	void clear(DrawColor color);
+
+	// draw a draw list (quads, then text runs) over the frame
+	void render(const DrawList &list);
+
+	// the RGBA color of a pixel (must be within the frame)
+	DrawColor getPixel(int x, int y) const;
+
+	int getWidth() const;
+	int getHeight() const;
+	const std::vector<std::uint8_t>& getPixels() const;
+
+	// the frame as a binary PPM (P6, RGB) or a PNG (RGBA) file
+	void encodePPM(std::vector<std::uint8_t> &out) const;
+	void encodePNG(std::vector<std::uint8_t> &out) const;
+
+	// write the frame to a file. return false if it couldn't be written
+	bool writePPM(const std::string &path) const;
+	bool writePNG(const std::string &path) const;
+
+private:
+	struct Texture
+	{
+		int width = 0;
+		int height = 0;
+		std::vector<std::uint8_t> rgba;
+	};
+
+	void drawQuad(const DrawQuad &quad);
+	void drawText(const DrawText &text);
+
+	// draw a solid pixel-aligned rectangle, clipped to the frame
+	void fillRect(int left, int top, int right, int bottom, DrawColor color);
+
+	// blend color (straight alpha) over the pixel at x,y (must be within the frame)
+	void blendPixel(int x, int y, DrawColor color);
+
+	// MEMBER VARIABLES
+	int width;
+	int height;
+	std::vector<std::uint8_t> pixels;	// RGBA, row by row
+	Texture textures[TEXTURE_COUNT];
+};
+
+#endif /* SOFTWARERENDERER_H */
@@ -0,0 +1,182 @@
+// The spectator stream lets thousands of viewers watch a board without sending
+// the whole 10x19 Gameboard to every viewer every frame.
+//
+//  - SpectatorEncoder turns a game into a stream of frames.  Most frames are
+//    deltas coded against the previous frame: the cells that changed, the rows
+//    that were cleared, and the active piece's pose (only the parts that moved).
+//    Every keyframeInterval frames it sends a full keyframe instead.
+//    When it is called once per TetrisEngine::step(), the deltas are read straight
+//    from the board's change journal (O(changes)); otherwise the board is diffed.
+//  - SpectatorBroadcaster encodes each frame ONCE and hands the same shared,
+//    immutable buffer to every subscriber (no per-viewer copy).  A late joiner
+//    is queued the latest keyframe plus the deltas since, so it catches up at once.
+//  - SpectatorDecoder rebuilds the game a viewer sees from the frames.
+//
+// Frame layout: [type:u8][frame:u32] then
+//   KEYFRAME: [cells: 95 bytes, 2 cells per byte, value = content + 1 (0 = empty)]
+//             [shape:u8][rotation:u8][x:i8][y:i8][next:u8][score:i32]
+//   DELTA:    a list of ops, each [op:u8] + payload:
+//     OP_ROWS_REMOVED [count:u8][row:u8]...      rows removed (ascending, as Gameboard::removeRows)
+//     OP_CELLS        [count:u8]([index:u8][value:u8])...   index = y * MAX_X + x
+//     OP_PIECE        [flags:u8] then [shape:u8] [rotation:u8] [dx:i8] [dy:i8] as flagged
+//     OP_NEXT         [shape:u8]
+//     OP_SCORE        [score:i32]
+//     OP_EMPTY                                   every cell emptied
+//   Ops are applied in order.
+//
+//  [expected .cpp size: ~ 420 lines]
+
+#ifndef SPECTATORSTREAM_H
+#define SPECTATORSTREAM_H
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "TetrisEngine.h"
+
+// an encoded frame, shared (read only) by every subscriber
+typedef std::vector<std::uint8_t> SpectatorFrame;
+typedef std::shared_ptr<const SpectatorFrame> SpectatorFramePtr;
+
+// what a spectator can see of a game
+struct SpectatorView
+{
+	static constexpr int CELL_COUNT = Gameboard::MAX_X * Gameboard::MAX_Y;
+
+	std::uint32_t frame = 0;
+	std::uint8_t cells[CELL_COUNT] = {};	// content + 1 (0 = empty), index y * MAX_X + x
+	std::uint8_t shape = 0;								// the falling piece
+	std::uint8_t rotation = 0;
+	int x = 0;
+	int y = 0;
+	std::uint8_t nextShape = 0;						// the "on-deck" piece
+	std::int32_t score = 0;
+
+	// capture the visible state of an engine (captureCells() + capturePieces())
+	void capture(const TetrisEngine &engine);
+	// capture every board cell
+	void captureCells(const Gameboard &board);
+	// capture the falling & next pieces, and the score
+	void capturePieces(const TetrisEngine &engine);
+	// apply one change from a Gameboard's change journal to the cells
+	void applyChange(const BoardChange &change);
+
+	// the board content at x,y (Gameboard::EMPTY_BLOCK or a TetColor)
+	int getContent(int x, int y) const;
+
+	// rebuild the falling piece (for drawing)
+	GridTetromino getCurrentShape() const;
+};
+
+class SpectatorEncoder
+{
+	friend class TestSuite;
+public:
+	// frame types
+	static constexpr std::uint8_t KEYFRAME = 1;
+	static constexpr std::uint8_t DELTA = 2;
+
+	// delta ops
+	static constexpr std::uint8_t OP_ROWS_REMOVED = 1;
+	static constexpr std::uint8_t OP_CELLS = 2;
+	static constexpr std::uint8_t OP_PIECE = 3;
+	static constexpr std::uint8_t OP_NEXT = 4;
+	static constexpr std::uint8_t OP_SCORE = 5;
+	static constexpr std::uint8_t OP_EMPTY = 6;
+
+	// OP_PIECE flags
+	static constexpr std::uint8_t PIECE_SHAPE = 1 << 0;
+	static constexpr std::uint8_t PIECE_ROTATION = 1 << 1;
+	static constexpr std::uint8_t PIECE_X = 1 << 2;
+	static constexpr std::uint8_t PIECE_Y = 1 << 3;
+
+	static constexpr int MAX_ROWS_REMOVED = 4;	// a tetromino can complete at most 4 rows
+
+	// MEMBER FUNCTIONS
+
+	// constructor
+	//   keyframeInterval: frames between keyframes (the first frame is always one)
+	explicit SpectatorEncoder(int keyframeInterval = 120);
+
+	// encode the current state of a game as the next frame
+	SpectatorFramePtr encode(const TetrisEngine &engine);
+
+	// make the next encode() a keyframe
+	void requestKeyframe();
+
+private:
+	// write a full keyframe of the current view
+	void writeKeyframe(SpectatorFrame &out) const;
+
+	// write the ops that turn 'previous' into 'current', by diffing the cells.
+	//   return false if a keyframe would be smaller.
+	bool writeDelta(SpectatorFrame &out) const;
+
+	// write the ops that turn 'previous' into 'current', from the board's
+	//   change journal (which must hold exactly the changes since 'previous').
+	//   return false if a keyframe would be smaller.
+	bool writeJournalDelta(const Gameboard &board, SpectatorFrame &out) const;
+
+	// write the OP_PIECE, OP_NEXT & OP_SCORE ops for whatever changed
+	void writePieceOps(SpectatorFrame &out) const;
+
+	// guess which rows of 'previous' were removed to reach 'current'
+	//   (locking only adds cells, clearing removes whole rows)
+	int guessRemovedRows(int removedRows[MAX_ROWS_REMOVED]) const;
+
+	// MEMBER VARIABLES
+	int keyframeInterval;
+	int framesSinceKeyframe = 0;
+	bool keyframeRequested = true;
+	bool haveEncoded = false;				// has a frame been encoded yet?
+	std::uint32_t lastEngineFrame = 0;	// TetrisEngine::getFrame() at the last encode()
+	SpectatorView previous;		// what spectators saw after the last frame
+	SpectatorView current;		// what they should see after this one
+};
+
+class SpectatorDecoder
+{
+public:
+	// apply one frame to the view.
+	//   return false if the frame is malformed, or is a delta and no keyframe
+	//   has been seen yet (the frame is then ignored).
+	bool apply(const SpectatorFrame &frame);
+
+	bool hasKeyframe() const;
+	const SpectatorView& getView() const;
+
+private:
+	bool keyframeSeen = false;
+	SpectatorView view;
+};
+
+class SpectatorBroadcaster
+{
+public:
+	// constructor
+	//   keyframeInterval: frames between keyframes
+	explicit SpectatorBroadcaster(int keyframeInterval = 120);
+
+	// encode this frame of the game once and queue it for every subscriber
+	SpectatorFramePtr publish(const TetrisEngine &engine);
+
+	// add a subscriber, queueing the latest keyframe & the deltas since it.
+	//   return the subscriber's id
+	int subscribe();
+	void unsubscribe(int id);
+
+	// move the frames queued for a subscriber to the end of 'out'
+	void takeFrames(int id, std::vector<SpectatorFramePtr> &out);
+
+	int getSubscriberCount() const;
+
+private:
+	SpectatorEncoder encoder;
+	SpectatorFramePtr lastKeyframe;
+	std::vector<SpectatorFramePtr> deltasSinceKeyframe;
+	std::unordered_map<int, std::vector<SpectatorFramePtr>> queues;	// subscriber id -> frames to send
+	int nextId = 0;
+};
+
+#endif /* SPECTATORSTREAM_H */
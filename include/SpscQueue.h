@@ -0,0 +1,88 @@
+// A fixed-size, lock-free, single-producer single-consumer queue.
+//
+// Exactly one thread may push() and exactly one (other) thread may pop().
+// Neither ever blocks or allocates: push() fails when the queue is full, pop()
+// fails when it is empty.  The producer only writes 'tail' and the consumer only
+// writes 'head' (each on its own cache line), and each publishes its index with
+// a release store that the other side reads with an acquire load, which makes
+// the item written before it visible.
+//
+// Capacity must be a power of two; the queue holds Capacity items.
+
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+template <typename T, std::size_t Capacity>
+class SpscQueue
+{
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+public:
+	// PRODUCER
+
+	// add an item. return false (and drop it) if the queue is full
+	bool push(const T &item)
+	{
+		std::size_t t = tail.load(std::memory_order_relaxed);
+		if(t - head.load(std::memory_order_acquire) == Capacity)
+		{
+			return false;
+		}
+		items[t & (Capacity - 1)] = item;
+		tail.store(t + 1, std::memory_order_release);
+		return true;
+	}
+
+	// CONSUMER
+
+	// take the oldest item. return false if the queue is empty
+	bool pop(T &item)
+	{
+		const T *oldest = front();
+		if(oldest == nullptr)
+		{
+			return false;
+		}
+		item = *oldest;
+		popFront();
+		return true;
+	}
+
+	// the oldest item, without taking it (nullptr if the queue is empty)
+	const T* front() const
+	{
+		std::size_t h = head.load(std::memory_order_relaxed);
+		if(h == tail.load(std::memory_order_acquire))
+		{
+			return nullptr;
+		}
+		return &items[h & (Capacity - 1)];
+	}
+
+	// drop the oldest item (only after front() returned it)
+	void popFront()
+	{
+		head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	// EITHER SIDE (a snapshot: the other side may change it at once)
+
+	std::size_t size() const
+	{
+		return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+	}
+
+	bool empty() const
+	{
+		return size() == 0;
+	}
+
+private:
+	alignas(64) std::atomic<std::size_t> head{ 0 };	// the next item to pop (written by the consumer)
+	alignas(64) std::atomic<std::size_t> tail{ 0 };	// the next slot to push (written by the producer)
+	alignas(64) T items[Capacity];
+};
+
+#endif /* SPSCQUEUE_H */
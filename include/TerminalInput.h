@@ -0,0 +1,74 @@
+// TerminalInput reads the keyboard of a text terminal in raw mode: every key is
+// available as soon as it is pressed (no waiting for Enter) and isn't echoed.
+//
+// On POSIX the terminal is switched with termios and given back (restored) by
+// the destructor; on Windows the console is read with _kbhit()/_getch() and
+// switched to process ANSI escape codes (for the TerminalRenderer).
+//
+// Keys arrive as bytes: arrows are escape sequences (ESC [ A..D on POSIX,
+// 0/224 + a scan code on Windows).  parseKeys() turns bytes into TerminalKeys
+// and holds back an incomplete sequence until the rest of it arrives.
+//
+//  [expected .cpp size: ~ 150 lines]
+
+#ifndef TERMINALINPUT_H
+#define TERMINALINPUT_H
+
+#include <string>
+#ifndef _WIN32
+#include <termios.h>
+#endif
+
+enum TerminalKey {
+	KEY_NONE,
+	KEY_LEFT,
+	KEY_RIGHT,
+	KEY_UP,
+	KEY_DOWN,
+	KEY_SPACE,
+	KEY_ROTATE,		// 'r'
+	KEY_QUIT			// 'q' or Ctrl-C
+};
+
+class TerminalInput
+{
+public:
+	static const int MAX_KEYS = 32;	// keys returned by one readKeys()
+
+	// MEMBER FUNCTIONS
+
+	// constructor: switch the terminal to raw, non-blocking input
+	TerminalInput();
+
+	// destructor: give the terminal back as it was
+	~TerminalInput();
+
+	TerminalInput(const TerminalInput&) = delete;
+	TerminalInput& operator=(const TerminalInput&) = delete;
+
+	// did the terminal switch to raw mode? (false: not a terminal)
+	bool isRaw() const;
+
+	// read the keys pressed since the last call (never blocks)
+	//   return how many were put in keys (at most MAX_KEYS)
+	int readKeys(TerminalKey keys[MAX_KEYS]);
+
+	// turn bytes read from the terminal into keys.
+	//   pending holds bytes of an incomplete escape sequence between calls.
+	//   return how many keys were put in keys (at most maxKeys)
+	static int parseKeys(std::string &pending, const char *bytes, int count, TerminalKey keys[], int maxKeys);
+
+private:
+	// MEMBER VARIABLES
+	bool raw = false;
+	std::string pending;			// an incomplete escape sequence
+	// the terminal's settings before we changed them
+#ifdef _WIN32
+	unsigned long savedInputMode = 0;
+	unsigned long savedOutputMode = 0;
+#else
+	struct termios savedState;
+#endif
+};
+
+#endif /* TERMINALINPUT_H */
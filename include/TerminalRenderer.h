@@ -0,0 +1,81 @@
+// The TerminalRenderer draws a game in a text terminal with ANSI escape codes,
+// for playing over SSH or on a headless box.
+//
+// It keeps two screens of character cells:
+//   - 'shown': what the terminal is displaying now,
+//   - 'next':  what compose() drew for this frame.
+// writeUpdate() only sends the cells that differ: a cursor move where the next
+// changed cell isn't right after the last one written, a color change only when
+// the color differs from the last one written, then the character.  A frame
+// where the piece moves one row costs a few dozen bytes, and a frame where
+// nothing changed costs nothing, so a 60Hz game is fine over a slow link.
+//
+// Each board cell is 2 characters wide (terminal characters are about twice as
+// tall as they are wide), colored with the shape's background color.
+//
+//  [expected .cpp size: ~ 175 lines]
+
+#ifndef TERMINALRENDERER_H
+#define TERMINALRENDERER_H
+
+#include <cstdint>
+#include <string>
+#include "TetrisEngine.h"
+
+class TerminalRenderer
+{
+	friend class TestSuite;
+public:
+	// STATIC CONSTANTS
+	static const int WIDTH = 42;		// the screen size in characters
+	static const int HEIGHT = 23;
+
+	// MEMBER FUNCTIONS
+
+	// constructor
+	TerminalRenderer();
+
+	// draw a game into the next screen: score, board, falling & next shapes
+	void compose(const TetrisEngine &engine);
+
+	// append the escape sequences that turn the shown screen into the next
+	//   screen to out (nothing if they are the same), and remember it as shown
+	void writeUpdate(std::string &out);
+
+	// make the next writeUpdate() clear the terminal & redraw everything
+	//   (eg: after the terminal was resized or written to by something else)
+	void invalidate();
+
+	// the escape sequences that give the terminal back as we found it
+	//   (default colors, cursor shown, below the game)
+	static std::string getRestoreSequence();
+
+private:
+	// colors (indexes into the SGR table in the .cpp)
+	enum CellColor : std::uint8_t {
+		COLOR_DEFAULT,
+		COLOR_BORDER,
+		COLOR_TETROMINO		// + TetColor
+	};
+
+	struct Cell
+	{
+		char character = ' ';
+		std::uint8_t color = COLOR_DEFAULT;
+
+		bool operator!=(const Cell &other) const { return character != other.character || color != other.color; }
+	};
+
+	// draw text into the next screen (default colors, clipped to the screen)
+	void putText(int x, int y, const char *text);
+
+	// draw a board-sized block (2 characters) into the next screen
+	void putBlock(int x, int y, std::uint8_t color);
+
+	// MEMBER VARIABLES
+	Cell shown[HEIGHT][WIDTH];
+	Cell next[HEIGHT][WIDTH];
+	bool shownValid = false;	// false: the terminal's contents are unknown
+};
+
+#endif /* TERMINALRENDERER_H */
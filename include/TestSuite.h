@@ -2,10 +2,46 @@
 #define TESTSUITE_H
 
 #include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <assert.h>
 #include "Point.h"
 #include "Tetromino.h"
 #include "GridTetromino.h"
+#include "TetrisEngine.h"
+#include "RollbackSession.h"
+#include "LoopbackChannel.h"
+#include "GameRoom.h"
+#include "SpectatorStream.h"
+#include "GameView.h"
+#include "SoftwareRenderer.h"
+#include "TerminalInput.h"
+#include "TerminalRenderer.h"
+#include "FrameScheduler.h"
+#include "SpscQueue.h"
+#include "LatencyHistogram.h"
+#include "Profiler.h"
+#include "AllocationCounter.h"
+#include "WorkerPool.h"
+#include "PlacementSearch.h"
+#include "BotPlayer.h"
+#include "BattleRoyale.h"
+#include "MinimapAtlas.h"
+#include "Coach.h"
+#include "Finesse.h"
+#include "TickHistory.h"
+#include "BitBoard.h"
+#include "AssetArchive.h"
+#include "AssetTable.h"
+#include <sstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
 
 
 #ifdef GAMEBOARD_H
@@ -30,6 +66,31 @@ public:
 #ifdef GAMEBOARD_H
 		TestSuite::testGameboardClass();
 #endif
+		TestSuite::testTetrisEngineClass();
+		TestSuite::testRollbackSession();
+		TestSuite::testGameRoomClass();
+		TestSuite::testSpectatorStream();
+		TestSuite::testSoftwareRenderer();
+		TestSuite::testTerminalRenderer();
+		TestSuite::testFrameScheduler();
+		TestSuite::testSpscQueue();
+		TestSuite::testLatencyHistogram();
+		TestSuite::testProfiler();
+		TestSuite::testAllocationCounter();
+		TestSuite::testAssetTable();
+		TestSuite::testAssetArchive();
+		TestSuite::testWorkerPool();
+		TestSuite::testPlacementSearch();
+		TestSuite::testBattleRoyale();
+		TestSuite::testMinimapAtlas();
+		TestSuite::testCoach();
+		TestSuite::testFinesse();
+		TestSuite::testTickHistory();
+		TestSuite::testStateHash();
+		TestSuite::testBitBoard();
+#ifdef SHADERBOARDRENDERER_H
+		TestSuite::testShaderBoardRenderer();
+#endif
 
 		std::cout << "TestSuite complete -----------------------" << "\n";
 		return true;
@@ -61,7 +122,7 @@ public:
 		// test getBlockLocsMappedToGrid()
 		gt.blockLocs = { Point(1,2) };
 		gt.setGridLoc(5, 5);
-		std::vector<Point> locs = gt.getBlockLocsMappedToGrid();
+		BlockLocs locs = gt.getBlockLocsMappedToGrid();
 		assert(locs[0].getX() == 6 && locs[0].getY() == 7);
 
 
@@ -186,6 +247,1457 @@ public:
 	}
 
 
+
+	// return true if two engines hold the same game (board, shapes, score, timing)
+	static bool isSameGame(const TetrisEngine &a, const TetrisEngine &b)
+	{
+		for (int x = 0; x < Gameboard::MAX_X; x++) {
+			for (int y = 0; y < Gameboard::MAX_Y; y++) {
+				if (a.board.getContent(x, y) != b.board.getContent(x, y)) { return false; }
+			}
+		}
+		BlockLocs aLocs = a.currentShape.getBlockLocsMappedToGrid();
+		BlockLocs bLocs = b.currentShape.getBlockLocsMappedToGrid();
+		for (size_t i = 0; i < aLocs.size(); i++) {
+			if (aLocs[i].getX() != bLocs[i].getX() || aLocs[i].getY() != bLocs[i].getY()) { return false; }
+		}
+		return a.score == b.score
+			&& a.currentShape.getShape() == b.currentShape.getShape()
+			&& a.nextShape.getShape() == b.nextShape.getShape()
+			&& a.rngState == b.rngState
+			&& a.secondsSinceLastTick == b.secondsSinceLastTick
+			&& a.frame == b.frame
+			&& a.shapeCount == b.shapeCount
+			&& a.shiftButton == b.shiftButton
+			&& a.shiftHeldFrames == b.shiftHeldFrames
+			&& a.downHeldFrames == b.downHeldFrames
+			&& a.pendingGarbage == b.pendingGarbage
+			&& std::equal(a.garbageHoles, a.garbageHoles + a.pendingGarbage, b.garbageHoles);
+	}
+
+	static bool testTetrisEngineClass()
+	{
+		std::cout << " testTetrisEngineClass...";
+
+		// a fresh engine has an empty board & a spawned shape
+		TetrisEngine e(1234);
+		assert(e.getScore() == 0);
+		assert(e.getCurrentShape().getGridLoc().getX() == e.getBoard().getSpawnLoc().getX());
+		assert(e.getCurrentShape().getGridLoc().getY() == e.getBoard().getSpawnLoc().getY());
+
+		// the same seed & inputs must always produce the same game
+		TetrisEngine a(77), b(77);
+		for (int frame = 0; frame < 2000; frame++) {
+			a.step(TetrisEngine::autoplayButtons(0, frame));
+			b.step(TetrisEngine::autoplayButtons(0, frame));
+		}
+		assert(TestSuite::isSameGame(a, b) && "TetrisEngine::step() is not deterministic");
+		assert(a.getFrame() == 2000);
+
+		// a copy is a snapshot: restoring it and replaying gives the same result
+		TetrisEngine snapshot = a;
+		for (int frame = 2000; frame < 2300; frame++) { a.step(TetrisEngine::autoplayButtons(0, frame)); }
+		TetrisEngine replayed = snapshot;
+		for (int frame = 2000; frame < 2300; frame++) { replayed.step(TetrisEngine::autoplayButtons(0, frame)); }
+		assert(TestSuite::isSameGame(a, replayed) && "restoring a TetrisEngine snapshot failed");
+
+		// a button only acts on the frame it goes down (holding drop doesn't re-drop)
+		TetrisEngine held(5);
+		held.step(BUTTON_LEFT);
+		int xAfterPress = held.getCurrentShape().getGridLoc().getX();
+		held.step(BUTTON_LEFT);
+		assert(held.getCurrentShape().getGridLoc().getX() == xAfterPress && "held button repeated");
+
+		// held LEFT / RIGHT repeat after the delay (DAS), then every repeatFrames (ARR)
+		AutoRepeatSettings settings;
+		settings.delayFrames = 4;
+		settings.repeatFrames = 3;
+		TetrisEngine das(5);
+		das.setAutoRepeat(settings);
+		int spawnX = das.getCurrentShape().getGridLoc().getX();
+		int expectedShift[] = { 0, 0, 0, 0, 1, 1, 1, 2 };	// repeats so far, by frames held
+		for (int frame = 0; frame < 8; frame++) {
+			das.step(BUTTON_LEFT);
+			assert(das.getCurrentShape().getGridLoc().getX() == spawnX - 1 - expectedShift[frame] && "DAS/ARR timing is wrong");
+		}
+
+		// pressing the other direction takes over at once; releasing it hands back (delay recharged)
+		int x = das.getCurrentShape().getGridLoc().getX();
+		das.step(BUTTON_LEFT | BUTTON_RIGHT);
+		assert(das.getCurrentShape().getGridLoc().getX() == x + 1);
+		for (int frame = 0; frame < 4; frame++) { das.step(BUTTON_LEFT); }
+		assert(das.getCurrentShape().getGridLoc().getX() == x + 1 && "the shift handed over without a delay");
+		das.step(BUTTON_LEFT);
+		assert(das.getCurrentShape().getGridLoc().getX() == x);
+
+		// ARR 0 shifts straight to the wall once the delay has charged
+		settings.repeatFrames = 0;
+		TetrisEngine wall(5);
+		wall.setAutoRepeat(settings);
+		for (int frame = 0; frame <= settings.delayFrames; frame++) { wall.step(BUTTON_LEFT); }
+		TetrisEngine leftmost = wall;
+		assert(!leftmost.attemptMove(leftmost.currentShape, -1, 0) && "ARR 0 didn't reach the wall");
+
+		// held DOWN soft drops every softDropFrames
+		TetrisEngine soft(5);
+		int spawnY = soft.getCurrentShape().getGridLoc().getY();
+		int softDropFrames = soft.getAutoRepeat().softDropFrames;
+		for (int frame = 0; frame <= softDropFrames * 3; frame++) { soft.step(BUTTON_DOWN); }
+		assert(soft.getCurrentShape().getGridLoc().getY() == spawnY + 4 && "held DOWN didn't soft drop");
+
+		// events: what happened in the last step()
+		TetrisEngine events(5);
+		events.step(BUTTON_ROTATE);
+		assert(events.getEvents() == GAME_EVENT_ROTATED);
+		events.step(0);
+		assert(events.getEvents() == 0);
+		events.step(BUTTON_DROP);
+		assert(events.getEvents() == GAME_EVENT_LOCKED);
+		GameEventMask later = 0;
+		for (int frame = 0; frame < TetrisEngine::FRAMES_PER_SECOND; frame++) {
+			events.step(0);
+			later |= events.getEvents();
+		}
+		assert(later == 0 && "the tick that spawns after a drop locked again");
+
+		// a completed row is cleared when the next shape spawns
+		events.board.fillRow(Gameboard::MAX_Y - 1, 1);
+		events.step(BUTTON_DROP);
+		later = 0;
+		for (int frame = 0; frame < TetrisEngine::FRAMES_PER_SECOND; frame++) {
+			events.step(0);
+			later |= events.getEvents();
+		}
+		assert(later == GAME_EVENT_ROWS_CLEARED);
+
+		// a shape that can't spawn ends the game
+		for (int y = 1; y < Gameboard::MAX_Y; y++) {
+			events.board.fillRow(y, 1);
+			events.board.setContent(y % Gameboard::MAX_X, y, Gameboard::EMPTY_BLOCK);
+		}
+		later = 0;
+		for (int frame = 0; frame < TetrisEngine::FRAMES_PER_SECOND && !(later & GAME_EVENT_GAME_OVER); frame++) {
+			events.step(0);
+			later |= events.getEvents();
+		}
+		assert((later & GAME_EVENT_GAME_OVER) && events.getScore() == 0);
+
+		// garbage rises when a shape locks without clearing a row
+		TetrisEngine garbage(5);
+		garbage.queueGarbage(2, 3);
+		assert(garbage.getPendingGarbage() == 2);
+		garbage.step(BUTTON_DROP);
+		for (int frame = 0; frame < TetrisEngine::FRAMES_PER_SECOND; frame++) { garbage.step(0); }
+		assert(garbage.getPendingGarbage() == 0);
+		for (int y = Gameboard::MAX_Y - 2; y < Gameboard::MAX_Y; y++) {
+			assert(garbage.getBoard().getRowMask(y) == (0x3FF & ~(1 << 3)));
+		}
+
+		// rows cleared are reported for the step they were cleared in
+		TetrisEngine clearing(5);
+		clearing.board.fillRow(Gameboard::MAX_Y - 1, 1);
+		clearing.step(BUTTON_DROP);
+		int cleared = 0;
+		for (int frame = 0; frame < TetrisEngine::FRAMES_PER_SECOND; frame++) {
+			clearing.step(0);
+			cleared += clearing.getClearedRows();
+		}
+		assert(cleared == 1);
+
+		// garbage that pushes blocks off the top ends the game
+		TetrisEngine toppedOut(5);
+		toppedOut.board.setContent(0, 0, 1);
+		toppedOut.queueGarbage(TetrisEngine::MAX_PENDING_GARBAGE + 5, 0);
+		assert(toppedOut.getPendingGarbage() == TetrisEngine::MAX_PENDING_GARBAGE);
+		toppedOut.step(BUTTON_DROP);
+		later = 0;
+		for (int frame = 0; frame < TetrisEngine::FRAMES_PER_SECOND; frame++) {
+			toppedOut.step(0);
+			later |= toppedOut.getEvents();
+		}
+		assert((later & GAME_EVENT_GAME_OVER) && toppedOut.getPendingGarbage() == 0);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	// Loopback harness: two peers play over lossy, jittery links.
+	// Both peers must end up with identical games, matching a local simulation
+	// fed the true inputs.  Rollback depth & CPU cost are reported.
+	static bool testRollbackSession()
+	{
+		std::cout << " testRollbackSession...";
+
+		const int FRAMES = 600;
+		const double FRAME_SECONDS = TetrisEngine::SECONDS_PER_FRAME;
+		RollbackSession peers[2] = { RollbackSession(0, 99), RollbackSession(1, 99) };
+		// links[i] carries packets from peer i to the other peer (50ms +/- 20ms, 10% loss)
+		LoopbackChannel links[2] = { LoopbackChannel(0.050, 0.020, 0.10, 11), LoopbackChannel(0.050, 0.020, 0.10, 22) };
+
+		std::vector<std::uint8_t> packet;
+		double now = 0.0;
+		for (int loop = 0; loop < FRAMES * 10; loop++, now += FRAME_SECONDS) {
+			bool finished = true;
+			for (int p = 0; p < 2; p++) {
+				while (links[1 - p].receive(packet, now)) {
+					assert(peers[p].receiveInputPacket(packet.data(), packet.size()));
+				}
+				if (peers[p].getFrame() < FRAMES) {
+					peers[p].advanceFrame(TetrisEngine::autoplayButtons(p, peers[p].getFrame()));
+				}
+				links[p].send(peers[p].buildInputPacket(), now);
+				finished = finished && peers[p].getFrame() == FRAMES && peers[p].getConfirmedFrame() == FRAMES - 1;
+			}
+			if (finished) { break; }
+		}
+		assert(peers[0].getFrame() == FRAMES && peers[1].getFrame() == FRAMES && "rollback session never finished");
+		assert(peers[0].getConfirmedFrame() == FRAMES - 1 && peers[1].getConfirmedFrame() == FRAMES - 1);
+
+		// the reference: both players simulated locally with their true inputs
+		TetrisEngine reference[2] = { TetrisEngine(99), TetrisEngine(99) };
+		for (int frame = 0; frame < FRAMES; frame++) {
+			for (int p = 0; p < 2; p++) { reference[p].step(TetrisEngine::autoplayButtons(p, frame)); }
+		}
+		for (int p = 0; p < 2; p++) {
+			assert(TestSuite::isSameGame(peers[0].getEngine(p), reference[p]) && "peer 0 desynced");
+			assert(TestSuite::isSameGame(peers[1].getEngine(p), reference[p]) && "peer 1 desynced");
+		}
+
+		const RollbackStats &stats = peers[0].getStats();
+		assert(stats.rollbacks > 0 && "harness should have forced some rollbacks");
+		assert(stats.maxRollbackDepth <= RollbackSession::MAX_PREDICTION_FRAMES + 1);
+		double usPerFrame = stats.framesResimulated > 0 ? 1e6 * stats.rollbackSeconds / stats.framesResimulated : 0.0;
+		std::cout << "passed! (" << stats.rollbacks << " rollbacks, max depth " << stats.maxRollbackDepth
+			<< ", " << stats.stalls << " stalls, " << usPerFrame << "us per re-simulated frame)" << "\n";
+		return true;
+	}
+
+	static bool testGameRoomClass()
+	{
+		std::cout << " testGameRoomClass...";
+
+		GameRoom room(7, 1234);
+		assert(room.addPlayer() == 0 && room.addPlayer() == 1);
+		assert(room.addPlayer() == -1 && "a room holds 2 players");
+
+		// input validation
+		assert(room.submitInput(2, 0, 0) == GameRoom::INPUT_INVALID_SLOT);
+		assert(room.submitInput(0, 0, 0x80) == GameRoom::INPUT_INVALID_BUTTONS);
+		assert(room.submitInput(0, 0, BUTTON_LEFT) == GameRoom::INPUT_ACCEPTED);
+		assert(room.submitInput(0, 0, BUTTON_LEFT) == GameRoom::INPUT_DUPLICATE);
+		assert(room.submitInput(0, GameRoom::INPUT_BUFFER_FRAMES, 0) == GameRoom::INPUT_TOO_EARLY);
+		for (int i = 0; i < GameRoom::MAX_INPUT_LAG_FRAMES + 5; i++) { room.step(); }
+		assert(room.submitInput(1, 0, 0) == GameRoom::INPUT_STALE);
+
+		// a player leaving frees its slot (for the next to join) & its inputs
+		room.removePlayer(0);
+		assert(!room.hasPlayer(0) && room.hasPlayer(1) && room.getPlayerCount() == 1);
+		assert(room.submitInput(0, room.getFrame(), 0) == GameRoom::INPUT_INVALID_SLOT);
+		room.removePlayer(0);	// (twice is harmless)
+		assert(room.getPlayerCount() == 1);
+		assert(room.addPlayer() == 0 && room.getPlayerCount() == 2);
+		assert(room.submitInput(0, room.getFrame(), BUTTON_LEFT) == GameRoom::INPUT_ACCEPTED);
+		room.removePlayer(0);
+		room.removePlayer(1);
+		assert(room.getPlayerCount() == 0);
+
+		// buffered inputs are applied on their frame: the room matches a local engine
+		GameRoom buffered(8, 99);
+		buffered.addPlayer();
+		TetrisEngine reference(99);
+		for (std::uint32_t frame = 0; frame < 600; frame++) {
+			if (frame % 4 == 0) {	// send 4 frames at once, ahead of the server
+				for (std::uint32_t ahead = 0; ahead < 4; ahead++) {
+					assert(buffered.submitInput(0, frame + ahead, TetrisEngine::autoplayButtons(0, frame + ahead)) == GameRoom::INPUT_ACCEPTED);
+				}
+			}
+			buffered.step();
+			reference.step(TetrisEngine::autoplayButtons(0, frame));
+		}
+		assert(TestSuite::isSameGame(buffered.getEngine(0), reference) && "GameRoom desynced from its inputs");
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	// return true if a spectator sees exactly what the engine holds
+	static bool isSameView(const SpectatorView &view, const TetrisEngine &engine)
+	{
+		SpectatorView expected;
+		expected.capture(engine);
+		for (int i = 0; i < SpectatorView::CELL_COUNT; i++) {
+			if (view.cells[i] != expected.cells[i]) { return false; }
+		}
+		return view.shape == expected.shape && view.rotation == expected.rotation
+			&& view.x == expected.x && view.y == expected.y
+			&& view.nextShape == expected.nextShape && view.score == expected.score;
+	}
+
+	static bool testSpectatorStream()
+	{
+		std::cout << " testSpectatorStream...";
+
+		TetrisEngine engine(4321);
+		SpectatorBroadcaster broadcaster(120);
+		SpectatorDecoder early, late;
+		int earlyId = broadcaster.subscribe();
+		int lateId = -1;
+		std::vector<SpectatorFramePtr> frames;
+		std::size_t deltaBytes = 0, deltaCount = 0, keyframeCount = 0;
+
+		for (int frame = 0; frame < 3000; frame++) {
+			engine.step(TetrisEngine::autoplayButtons(1, frame));
+			SpectatorFramePtr encoded = broadcaster.publish(engine);
+			if ((*encoded)[0] == SpectatorEncoder::DELTA) {
+				deltaBytes += encoded->size();
+				deltaCount++;
+			}
+			else {
+				keyframeCount++;
+			}
+
+			if (frame == 1234) { lateId = broadcaster.subscribe(); }	// joins mid keyframe interval
+
+			frames.clear();
+			broadcaster.takeFrames(earlyId, frames);
+			assert(frames.size() == 1 && frames[0] == encoded && "every subscriber shares the one encoded frame");
+			for (const SpectatorFramePtr &f : frames) { assert(early.apply(*f)); }
+			assert(TestSuite::isSameView(early.getView(), engine) && "spectator view diverged from the game");
+
+			if (lateId >= 0) {
+				frames.clear();
+				broadcaster.takeFrames(lateId, frames);
+				for (const SpectatorFramePtr &f : frames) { assert(late.apply(*f)); }
+				assert(TestSuite::isSameView(late.getView(), engine) && "late joiner did not catch up");
+			}
+		}
+
+		// a row clear is sent as OP_ROWS_REMOVED, not as every shifted cell
+		SpectatorEncoder clearing;
+		clearing.encode(engine);
+		SpectatorDecoder clearingViewer;
+		clearingViewer.apply(*clearing.encode(engine));
+		clearing.previous = clearingViewer.getView();
+		clearing.current = clearing.previous;
+		for (int i = 0; i < SpectatorView::CELL_COUNT; i++) {
+			clearing.previous.cells[i] = (i / Gameboard::MAX_X >= 10) ? 1 + (i % 7) : 0;	// rows 10-18 stacked
+			clearing.current.cells[i] = clearing.previous.cells[i];
+		}
+		std::memcpy(clearing.current.cells + Gameboard::MAX_X, clearing.previous.cells, 18 * Gameboard::MAX_X);	// row 18 removed
+		std::memset(clearing.current.cells, 0, Gameboard::MAX_X);
+		SpectatorFrame rowFrame;
+		assert(clearing.writeDelta(rowFrame) && rowFrame[5] == SpectatorEncoder::OP_ROWS_REMOVED && rowFrame[7] == 18);
+		assert(rowFrame.size() < 20 && "a row clear should be a few bytes");
+
+		// a spectator that skips engine frames is diffed, not fed the (stale) journal
+		TetrisEngine skipped(99);
+		SpectatorEncoder sparse(1000);
+		SpectatorDecoder sparseViewer;
+		for (int frame = 0; frame < 900; frame++) {
+			skipped.step(TetrisEngine::autoplayButtons(0, frame));
+			if (frame % 3 == 0) {
+				assert(sparseViewer.apply(*sparse.encode(skipped)));
+				assert(TestSuite::isSameView(sparseViewer.getView(), skipped));
+			}
+		}
+
+		// deltas without a keyframe are refused
+		SpectatorDecoder fresh;
+		SpectatorEncoder encoder;
+		encoder.encode(engine);
+		SpectatorFramePtr delta = encoder.encode(engine);
+		assert((*delta)[0] == SpectatorEncoder::DELTA && !fresh.apply(*delta));
+
+		std::cout << "passed! (" << keyframeCount << " keyframes, " << deltaCount << " deltas averaging "
+			<< static_cast<double>(deltaBytes) / deltaCount << " bytes)" << "\n";
+		return true;
+	}
+
+	// the color of each tile in the tiles texture used by testSoftwareRenderer()
+	static DrawColor testTileColor(int tile)
+	{
+		DrawColor color;
+		color.r = static_cast<std::uint8_t>(10 + tile * 30);
+		color.g = static_cast<std::uint8_t>(200 - tile * 20);
+		color.b = static_cast<std::uint8_t>(tile * 5);
+		return color;
+	}
+
+	static bool isSameColor(DrawColor a, DrawColor b)
+	{
+		return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+	}
+
+	static bool testSoftwareRenderer()
+	{
+		std::cout << " testSoftwareRenderer...";
+
+		// a tiles texture with one solid color per TetColor
+		const int tilesWidth = GameView::BLOCK_WIDTH * 7;
+		std::vector<std::uint8_t> tiles(tilesWidth * GameView::BLOCK_HEIGHT * 4);
+		for (int i = 0; i < tilesWidth * GameView::BLOCK_HEIGHT; i++) {
+			DrawColor color = TestSuite::testTileColor((i % tilesWidth) / GameView::BLOCK_WIDTH);
+			tiles[i * 4] = color.r;
+			tiles[i * 4 + 1] = color.g;
+			tiles[i * 4 + 2] = color.b;
+			tiles[i * 4 + 3] = color.a;
+		}
+		SoftwareRenderer renderer(640, 800);
+		renderer.setTexture(TEXTURE_TILES, tiles.data(), tilesWidth, GameView::BLOCK_HEIGHT);
+
+		TetrisEngine engine(777);
+		for (int frame = 0; frame < 900; frame++) {
+			engine.step(TetrisEngine::autoplayButtons(0, frame));
+		}
+		const Point boardOffset(54, 125);
+		GameView view(boardOffset, Point(490, 210), Point(54, 54));
+		DrawList list;
+		view.addGame(list, engine);
+		assert(list.countBatches() == 2 && "every block in one batch, plus the score");
+
+		DrawColor black;
+		black.r = black.g = black.b = 0;
+		renderer.clear(black);
+		renderer.render(list);
+
+		// golden check: the center of each cell shows its tile (or the background when empty)
+		int expected[Gameboard::MAX_Y][Gameboard::MAX_X];
+		for (int y = 0; y < Gameboard::MAX_Y; y++) {
+			for (int x = 0; x < Gameboard::MAX_X; x++) {
+				expected[y][x] = engine.getBoard().getContent(x, y);
+			}
+		}
+		for (const Point &p : engine.getCurrentShape().getBlockLocsMappedToGrid()) {
+			if (p.getY() >= 0) { expected[p.getY()][p.getX()] = engine.getCurrentShape().getColor(); }
+		}
+		int filled = 0;
+		for (int y = 0; y < Gameboard::MAX_Y; y++) {
+			for (int x = 0; x < Gameboard::MAX_X; x++) {
+				DrawColor pixel = renderer.getPixel(boardOffset.getX() + x * GameView::BLOCK_WIDTH + 16,
+					boardOffset.getY() + y * GameView::BLOCK_HEIGHT + 16);
+				DrawColor want = expected[y][x] == Gameboard::EMPTY_BLOCK ? black : TestSuite::testTileColor(expected[y][x]);
+				assert(TestSuite::isSameColor(pixel, want) && "board pixel doesn't match the game");
+				filled += expected[y][x] == Gameboard::EMPTY_BLOCK ? 0 : 1;
+			}
+		}
+		assert(filled > 4 && "the scripted game should have locked some blocks");
+
+		// the score text is drawn (white) in its place
+		int textPixels = 0;
+		for (int y = 54; y < 54 + 24; y++) {
+			for (int x = 54; x < 54 + 200; x++) {
+				textPixels += renderer.getPixel(x, y).r == 255 ? 1 : 0;
+			}
+		}
+		assert(textPixels > 50);
+
+		// alpha blending & clipping
+		DrawList overlay;
+		DrawRect corner;
+		corner.left = -2;
+		corner.top = -2;
+		corner.width = 4;
+		corner.height = 4;
+		DrawColor halfRed;
+		halfRed.g = halfRed.b = 0;
+		halfRed.a = 128;
+		overlay.addRect(corner, halfRed);
+		renderer.clear(black);
+		renderer.render(overlay);
+		assert(renderer.getPixel(1, 1).r == 128 && renderer.getPixel(1, 1).g == 0);
+		assert(renderer.getPixel(2, 2).r == 0);
+
+		// image files
+		std::vector<std::uint8_t> ppm, png;
+		renderer.encodePPM(ppm);
+		assert(ppm.size() == std::strlen("P6\n640 800\n255\n") + 640 * 800 * 3);
+		renderer.encodePNG(png);
+		const std::uint8_t iend[12] = { 0, 0, 0, 0, 'I', 'E', 'N', 'D', 0xAE, 0x42, 0x60, 0x82 };
+		assert(png[0] == 0x89 && png[1] == 'P' && std::memcmp(&png[png.size() - 12], iend, 12) == 0);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testTerminalRenderer()
+	{
+		std::cout << " testTerminalRenderer...";
+
+		TetrisEngine engine(2024);
+		TerminalRenderer renderer;
+		std::string update;
+		renderer.compose(engine);
+		renderer.writeUpdate(update);
+		assert(update.find("\x1b[2J") != std::string::npos && "the first frame clears & draws everything");
+		assert(update.find("Score:") != std::string::npos);
+
+		// nothing changed: nothing sent
+		update.clear();
+		renderer.compose(engine);
+		renderer.writeUpdate(update);
+		assert(update.empty());
+
+		// a one row move only sends the cells the piece left & entered
+		engine.tick();
+		update.clear();
+		renderer.compose(engine);
+		renderer.writeUpdate(update);
+		assert(!update.empty() && update.size() < 120 && update.find("\x1b[2J") == std::string::npos);
+
+		// the screen the updates build is the game: every locked cell is colored
+		std::size_t bytes = 0;
+		for (int frame = 0; frame < 600; frame++) {
+			engine.step(TetrisEngine::autoplayButtons(1, frame));
+			update.clear();
+			renderer.compose(engine);
+			renderer.writeUpdate(update);
+			bytes += update.size();
+		}
+		for (int y = 0; y < Gameboard::MAX_Y; y++) {
+			for (int x = 0; x < Gameboard::MAX_X; x++) {
+				const TerminalRenderer::Cell &cell = renderer.shown[3 + y][2 + x * 2];
+				int content = engine.getBoard().getContent(x, y);
+				assert(content == Gameboard::EMPTY_BLOCK || cell.color == TerminalRenderer::COLOR_TETROMINO + content);
+			}
+		}
+		assert(bytes / 600 < 100 && "a 60Hz game should send a few bytes per frame");
+
+		// arrow sequences, split across reads
+		std::string pending;
+		TerminalKey keys[8];
+		assert(TerminalInput::parseKeys(pending, "r\x1b[", 3, keys, 8) == 1 && keys[0] == KEY_ROTATE);
+		assert(TerminalInput::parseKeys(pending, "D q", 3, keys, 8) == 3);
+		assert(keys[0] == KEY_LEFT && keys[1] == KEY_SPACE && keys[2] == KEY_QUIT && pending.empty());
+
+		std::cout << "passed! (" << bytes / 600.0 << " bytes per frame)" << "\n";
+		return true;
+	}
+
+	static bool testFrameScheduler()
+	{
+		std::cout << " testFrameScheduler...";
+
+		// 10 seconds at 30, 60 & 144Hz all simulate the same 600 steps
+		const double rates[] = { 30, 60, 144 };
+		for (double rate : rates) {
+			FrameScheduler scheduler;
+			int steps = 0;
+			for (int frame = 0; frame <= 10 * rate; frame++) {
+				steps += scheduler.beginFrame(frame / rate);
+				assert(scheduler.getAlpha() >= 0 && scheduler.getAlpha() <= 1);
+			}
+			assert(std::abs(steps - 600) <= 1 && "the simulation rate must not depend on the render rate");
+			assert(scheduler.getStats().jitterSeconds < 1e-6 && scheduler.getStats().droppedSteps == 0);
+		}
+
+		// a very late frame runs at most maxStepsPerFrame steps, and the jitter shows it
+		FrameScheduler scheduler(TetrisEngine::SECONDS_PER_FRAME, 8);
+		scheduler.beginFrame(0);
+		scheduler.beginFrame(1.0 / 60);
+		assert(scheduler.beginFrame(1.0 / 60 + 1.0) == 8);
+		FrameStats stats = scheduler.getStats();
+		assert(stats.droppedSteps >= 51 && stats.maxFrameSeconds > 0.99 && stats.jitterSeconds > 0.4);
+
+		// the falling shape glides down between ticks, but not into the stack
+		TetrisEngine engine(5);
+		assert(GameView::getFallOffset(engine, 0) == 0);
+		engine.processGameLoop(TetrisEngine::MAX_SECONDS_PER_TICK / 2);
+		assert(std::abs(GameView::getFallOffset(engine, 0) - 0.5) < 1e-9);
+		assert(GameView::getFallOffset(engine, TetrisEngine::MAX_SECONDS_PER_TICK) == 1);
+		engine.onButtonPressed(BUTTON_DROP);	// locks & spawns the next shape
+		engine.currentShape.setGridLoc(4, Gameboard::MAX_Y - 1);
+		engine.processGameLoop(0.1);
+		assert(!engine.canCurrentShapeFall() && GameView::getFallOffset(engine, 0.1) == 0);
+
+		// step i of a frame's n steps ends at getSimulatedTime() - (n - 1 - i) * stepSeconds
+		FrameScheduler timed(0.01);
+		timed.beginFrame(1.0);
+		assert(timed.beginFrame(1.035) == 3);
+		assert(std::abs(timed.getSimulatedTime() - 1.03) < 1e-9 && std::abs(timed.getAlpha() - 0.5) < 1e-6);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testSpscQueue()
+	{
+		std::cout << " testSpscQueue...";
+
+		SpscQueue<int, 4> small;
+		int value = 0;
+		assert(small.empty() && !small.pop(value) && small.front() == nullptr);
+		for (int i = 0; i < 4; i++) { assert(small.push(i)); }
+		assert(!small.push(4) && small.size() == 4);	// full
+		assert(*small.front() == 0 && small.pop(value) && value == 0);
+		assert(small.push(4));
+		for (int i = 1; i <= 4; i++) { assert(small.pop(value) && value == i); }
+		assert(small.empty());
+
+		// a producer & a consumer thread: every item arrives, once, in order
+		static SpscQueue<int, 256> queue;
+		const int count = 200000;
+		std::thread producer([&]() {
+			for (int i = 0; i < count; i++) {
+				while (!queue.push(i)) { std::this_thread::yield(); }
+			}
+		});
+		int expected = 0;
+		while (expected < count) {
+			if (queue.pop(value)) {
+				assert(value == expected);
+				expected++;
+			}
+			else {
+				std::this_thread::yield();
+			}
+		}
+		producer.join();
+		assert(queue.empty());
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testLatencyHistogram()
+	{
+		std::cout << " testLatencyHistogram...";
+
+		// 1ms to 100ms: the percentiles are right to within a bucket
+		LatencyHistogram h;
+		assert(h.getCount() == 0 && h.getPercentileSeconds(0.5) == 0);
+		for (int ms = 1; ms <= 100; ms++) { h.record(ms / 1000.0); }
+		assert(h.getCount() == 100);
+		assert(std::abs(h.getPercentileSeconds(0.50) - 0.050) <= LatencyHistogram::BUCKET_SECONDS + 1e-9);
+		assert(std::abs(h.getPercentileSeconds(0.99) - 0.099) <= LatencyHistogram::BUCKET_SECONDS + 1e-9);
+		assert(h.getMaxSeconds() == 0.100 && h.getPercentileSeconds(1.0) == 0.100);
+		assert(std::abs(h.getMeanSeconds() - 0.0505) < 1e-9);
+
+		// durations past the last bucket still count (the max is exact)
+		h.record(2.0);
+		assert(h.getMaxSeconds() == 2.0 && h.getPercentileSeconds(1.0) == 2.0);
+		std::ostringstream report;
+		h.writeReport(report, "test");
+		assert(report.str().find("test: p50") == 0 && report.str().find("over ") != std::string::npos);
+
+		// the tracker times each stage of a press: captured, applied, presented
+		LatencyTracker tracker;
+		tracker.onApplied(1.000, 1.004);
+		tracker.onApplied(1.010, 1.012);
+		tracker.onPresented(1.030);
+		tracker.onPresented(1.050);	// nothing new was applied: nothing recorded
+		assert(tracker.getInputToApply().getCount() == 2 && tracker.getInputToPresent().getCount() == 2);
+		assert(std::abs(tracker.getInputToApply().getMaxSeconds() - 0.004) < 1e-9);
+		assert(std::abs(tracker.getApplyToPresent().getMaxSeconds() - 0.026) < 1e-9);
+		assert(std::abs(tracker.getInputToPresent().getMaxSeconds() - 0.030) < 1e-9);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testProfiler()
+	{
+		std::cout << " testProfiler...";
+
+		// samples from two threads all reach the trace, tagged with their thread
+		Profiler profiler;
+		std::thread worker([&]() {
+			for (int i = 0; i < 100; i++) { profiler.record("worker", profiler.now(), 1000); }
+		});
+		worker.join();
+		for (int i = 0; i < 10; i++) { profiler.record("main", profiler.now(), 2000000); }
+		profiler.collect();
+		assert(profiler.getTraceSize() == 110 && profiler.getDroppedSamples() == 0);
+
+		// the phase stats: per frame means & maxes, slowest first
+		profiler.endFrame();
+		for (int frame = 1; frame < Profiler::STATS_FRAMES; frame++) { profiler.collect(); profiler.endFrame(); }
+		std::vector<std::string> lines;
+		profiler.getPhaseLines(lines);
+		assert(lines.size() == 2 && lines[0].find("main") == 0 && lines[1].find("worker") == 0);
+		assert(lines[0].find(" 20.000") != std::string::npos && "the max of the main phase should be 20ms");
+
+		// the Chrome trace: one complete event per sample
+		std::ostringstream json;
+		profiler.writeChromeTrace(json);
+		std::string trace = json.str();
+		assert(trace.find("{\"displayTimeUnit\"") == 0 && trace.find("\"name\":\"worker\"") != std::string::npos);
+		size_t events = 0;
+		for (size_t at = trace.find("\"ph\":\"X\""); at != std::string::npos; at = trace.find("\"ph\":\"X\"", at + 1)) { events++; }
+		assert(events == 110);
+
+		// a thread's queue that isn't collected in time drops (and counts) the rest
+		for (size_t i = 0; i < Profiler::THREAD_CAPACITY + 5; i++) { profiler.record("flood", 0, 1); }
+		assert(profiler.getDroppedSamples() == 5);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testAllocationCounter()
+	{
+		std::cout << " testAllocationCounter...";
+
+		// allocations count against the innermost scope (or "other")
+		AllocationCounter::reset();
+		AllocationCounter::setEnabled(true);
+		{
+			AllocationScope outer("outer");
+			std::vector<int> counted(10);
+			{
+				AllocationScope inner("inner");
+				std::vector<int> first(10), second(10);
+			}
+			std::vector<int> countedToo(10);
+		}
+		std::vector<int> other(10);
+		AllocationCounter::setEnabled(false);
+		std::vector<int> notCounted(10);
+		assert(AllocationCounter::getCount("outer") == 2 && AllocationCounter::getCount("inner") == 2);
+		assert(AllocationCounter::getCount("other") == 1 && AllocationCounter::getCount() == 5);
+
+		// a steady-state game: neither a tick nor a frame (the view's draw list,
+		//   drawn by the software renderer) may allocate
+		TetrisEngine engine(31);
+		GameView view(Point(54, 125), Point(490, 210), Point(54, 54));
+		DrawList list;
+		list.reserve(GameView::MAX_GAME_QUADS, GameView::MAX_GAME_TEXTS);
+		SoftwareRenderer renderer(320, 400);
+		engine.step(0);
+		AllocationCounter::reset();
+		AllocationCounter::setEnabled(true);
+		for (int frame = 0; frame < 3000; frame++) {
+			{
+				AllocationScope scope("tick");
+				engine.step(TetrisEngine::autoplayButtons(0, frame));
+			}
+			AllocationScope scope("frame");
+			list.clear();
+			view.addGame(list, engine);
+			if (frame % 10 == 0) { renderer.render(list); }
+		}
+		AllocationCounter::setEnabled(false);
+		assert(AllocationCounter::getCount("tick") == 0 && "a game tick allocated");
+		assert(AllocationCounter::getCount("frame") == 0 && "a frame allocated");
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testAssetTable()
+	{
+		std::cout << " testAssetTable...";
+
+		// a "loader" that fails for paths starting with "missing", and holds a
+		//   "tiles" load until it's released (no sleeps: this runs at every launch)
+		std::atomic<int> loaderCalls{ 0 };
+		std::mutex latchMutex;
+		std::condition_variable latch;
+		bool released = false;
+		AssetTable<std::string> table([&](std::string &asset, const std::string &path) {
+			loaderCalls++;
+			if (path == "tiles") {
+				std::unique_lock<std::mutex> lock(latchMutex);
+				latch.wait(lock, [&]() { return released; });
+			}
+			asset = "contents of " + path;
+			return path.compare(0, 7, "missing") != 0;
+		});
+
+		// each path loads once, and every user shares it
+		std::shared_ptr<std::string> first = table.get("font");
+		std::shared_ptr<std::string> second = table.get("font");
+		assert(first != nullptr && *first == "contents of font");
+		assert(first == second && table.getLoads() == 1 && table.contains("font"));
+
+		// threads asking for the same path while it loads wait for that one load
+		//   (the load is held until every thread has started & the load is under way)
+		std::vector<std::shared_ptr<std::string>> got(4);
+		std::atomic<int> asking{ 0 };
+		std::vector<std::thread> threads;
+		for (int i = 0; i < 4; i++) {
+			threads.emplace_back([&, i]() { asking++; got[i] = table.get("tiles"); });
+		}
+		while (asking < 4 || loaderCalls < 2) { std::this_thread::yield(); }
+		{
+			std::lock_guard<std::mutex> lock(latchMutex);
+			released = true;
+		}
+		latch.notify_all();
+		for (std::thread &thread : threads) { thread.join(); }
+		assert(table.getLoads() == 2 && loaderCalls == 2);
+		for (int i = 0; i < 4; i++) { assert(got[i] != nullptr && got[i] == got[0]); }
+
+		// a failure is remembered (not retried) and reported
+		assert(table.get("missing.png") == nullptr && table.get("missing.png") == nullptr);
+		assert(table.getLoads() == 3 && table.getFailures() == std::vector<std::string>{ "missing.png" });
+
+		// purge() drops only what nobody else holds
+		got.clear();
+		assert(table.purge() == 1 && !table.contains("tiles") && table.contains("font"));
+		first.reset();
+		second.reset();
+		assert(table.purge() == 1 && table.size() == 1);	// (the failure is kept)
+		table.get("font");
+		assert(table.getLoads() == 4);
+
+		// erase() or purge() right after a load, while other threads still wait
+		//   for it (as ResourceCache's texture loader erases its image), doesn't
+		//   free the entry under the waiters
+		std::atomic<bool> holding{ false };
+		std::atomic<int> holds{ 0 };
+		AssetTable<std::string> held([&](std::string &asset, const std::string &path) {
+			holds++;
+			while (holding) { std::this_thread::yield(); }
+			asset = "contents of " + path;
+			return true;
+		});
+		for (int round = 0; round < 200; round++) {
+			holding = true;
+			int holdsBefore = holds;
+			std::thread owner([&]() {
+				held.get("sprite");
+				if (round % 2 == 0) { held.erase("sprite"); }
+				else { held.purge(); }
+			});
+			while (holds == holdsBefore) { std::this_thread::yield(); }
+			std::vector<std::shared_ptr<std::string>> waited(3);
+			std::atomic<int> waiting{ 0 };
+			std::vector<std::thread> waiters;
+			for (int i = 0; i < 3; i++) {
+				waiters.emplace_back([&, i]() { waiting++; waited[i] = held.get("sprite"); });
+			}
+			while (waiting < 3) { std::this_thread::yield(); }
+			for (int i = 0; i < 100; i++) { std::this_thread::yield(); }	// (let them reach the wait)
+			holding = false;
+			owner.join();
+			for (std::thread &waiter : waiters) { waiter.join(); }
+			for (int i = 0; i < 3; i++) { assert(waited[i] != nullptr && *waited[i] == "contents of sprite"); }
+			held.erase("sprite");
+		}
+		assert(held.size() == 0 && held.getFailures().empty());
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testAssetArchive()
+	{
+		std::cout << " testAssetArchive...";
+
+		// pack a "file" and some "pixels", and read them back
+		//   (in memory: this runs at every launch, maybe from a read only directory)
+		const std::string font = "not really a font";
+		const unsigned char pixels[2 * 3 * 4] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24 };
+		AssetArchiveWriter writer;
+		writer.add("assets/fonts/test.ttf", font.data(), font.size());
+		writer.add("assets/images/test.png", pixels, sizeof(pixels), ASSET_RGBA, 2, 3);
+		const std::vector<unsigned char> bytes = writer.toBytes();
+
+		AssetArchive archive;
+		bool opened = archive.openMemory(bytes.data(), bytes.size());
+		assert(opened && archive.isOpen() && archive.getSize() == bytes.size());
+		assert(archive.getNames().size() == 2 && archive.find("assets/sfx/missing.ogg").data == nullptr);
+		AssetView view = archive.find("assets/fonts/test.ttf");
+		assert(view.format == ASSET_FILE && std::string(reinterpret_cast<const char*>(view.data), view.size) == font);
+		view = archive.find("assets/images/test.png");
+		assert(view.format == ASSET_RGBA && view.width == 2 && view.height == 3);
+		assert(view.size == sizeof(pixels) && std::memcmp(view.data, pixels, sizeof(pixels)) == 0);
+		assert(static_cast<std::size_t>(view.data - bytes.data()) % AssetArchive::DATA_ALIGNMENT == 0);
+		archive.close();
+		assert(!archive.isOpen() && archive.find("assets/fonts/test.ttf").data == nullptr);
+
+		// a truncated or corrupt archive (or a missing one) doesn't open
+		opened = archive.openMemory(bytes.data(), bytes.size() - 1);
+		assert(!opened && !archive.isOpen());
+		std::vector<unsigned char> corrupt = bytes;
+		corrupt[0] = 'X';
+		opened = archive.openMemory(corrupt.data(), corrupt.size());
+		assert(!opened);
+		opened = archive.open("assets/testAssetArchive-missing.pak");
+		assert(!opened);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testWorkerPool()
+	{
+		std::cout << " testWorkerPool...";
+
+		// every task runs exactly once per batch, batch after batch
+		WorkerPool pool(4);
+		assert(pool.getThreadCount() == 4);
+		std::vector<std::atomic<int>> runs(100);
+		for (int batch = 0; batch < 200; batch++) {
+			pool.run(batch % 2 == 0 ? 100 : 3, [&](int i) { runs[i]++; });
+		}
+		for (int i = 0; i < 100; i++) { assert(runs[i] == (i < 3 ? 200 : 100)); }
+		pool.run(0, [](int) { assert(false && "no tasks to run"); });
+
+		// games stepped in parallel play exactly as they do one after another
+		const int GAMES = 16;
+		std::vector<TetrisEngine> parallel, sequential;
+		for (int i = 0; i < GAMES; i++) {
+			parallel.push_back(TetrisEngine(100 + i));
+			sequential.push_back(TetrisEngine(100 + i));
+		}
+		for (int frame = 0; frame < 600; frame++) {
+			pool.run(GAMES, [&](int i) { parallel[i].step(TetrisEngine::autoplayButtons(i, frame)); });
+			for (int i = 0; i < GAMES; i++) { sequential[i].step(TetrisEngine::autoplayButtons(i, frame)); }
+		}
+		for (int i = 0; i < GAMES; i++) { assert(TestSuite::isSameGame(parallel[i], sequential[i])); }
+
+		// a one thread pool runs them on the caller
+		WorkerPool single(1);
+		std::thread::id caller = std::this_thread::get_id();
+		single.run(5, [&](int) { assert(std::this_thread::get_id() == caller); });
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testPlacementSearch()
+	{
+		std::cout << " testPlacementSearch...";
+
+		// an I fills the one gap on an otherwise full bottom row
+		Gameboard board;
+		for (int x = 0; x < Gameboard::MAX_X; x++) {
+			if (x < 3 || x > 6) { board.setContent(x, Gameboard::MAX_Y - 1, 1); }
+		}
+		GridTetromino shape;
+		shape.setShape(TetShape::I);
+		shape.setGridLoc(board.getSpawnLoc());
+		Placement best = PlacementSearch::findBest(board, shape);
+		assert(best.found && best.rowsCleared == 1);
+
+		// every placement found can be reached, and is distinct
+		std::vector<Placement> placements;
+		PlacementSearch::findAll(board, shape, placements);
+		assert(placements.size() == 17);	// 7 flat, 10 upright
+		for (const Placement &placement : placements) {
+			GridTetromino landed = shape;
+			assert(PlacementSearch::reach(board, landed, placement.rotations, placement.x));
+			assert(landed.getGridLoc().getY() == placement.y);
+		}
+
+		// holes & height cost: a flat board scores better than a holed one
+		Gameboard flat, holed;
+		flat.fillRow(Gameboard::MAX_Y - 1, 1);
+		flat.setContent(0, Gameboard::MAX_Y - 1, Gameboard::EMPTY_BLOCK);
+		holed = flat;
+		holed.setContent(0, Gameboard::MAX_Y - 2, 1);
+		assert(PlacementSearch::evaluate(flat, 0) > PlacementSearch::evaluate(holed, 0));
+
+		// a bot plays a long game, clearing rows as it goes
+		TetrisEngine engine(42);
+		BotPlayer bot(3);
+		int cleared = 0;
+		bool gameOver = false;
+		for (int frame = 0; frame < 60 * TetrisEngine::FRAMES_PER_SECOND && !gameOver; frame++) {
+			engine.step(bot.nextButtons(engine));
+			cleared += engine.getClearedRows();
+			gameOver = (engine.getEvents() & GAME_EVENT_GAME_OVER) != 0;
+		}
+		assert(!gameOver && cleared >= 10);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testBattleRoyale()
+	{
+		std::cout << " testBattleRoyale...";
+
+		// a short bots only match plays the same on one thread or many
+		//   (a few bots for 30 seconds: this runs at every launch)
+		WorkerPool single(1), pool(4);
+		BattleRoyale a(nullptr, 6, 1234, single), b(nullptr, 6, 1234, pool);
+		while (!a.isOver() && a.getFrame() < 30 * TetrisEngine::FRAMES_PER_SECOND) {
+			a.step();
+			b.step();
+			for (int player = 0; player < a.getPlayerCount(); player++) {
+				assert(a.getEngine(player).getStateHash() == b.getEngine(player).getStateHash());
+			}
+		}
+		assert(a.getFrame() == b.getFrame() && a.getAliveCount() == b.getAliveCount());
+		assert(a.getGarbageSent() == b.getGarbageSent() && a.getGarbageSent() > 0);
+		std::vector<bool> placed(a.getPlayerCount() + 1, false);
+		for (int player = 0; player < a.getPlayerCount(); player++) {
+			assert(a.getPlacement(player) == b.getPlacement(player) && a.getKnockouts(player) == b.getKnockouts(player));
+			// the players knocked out took the places after the ones left, once each
+			if (!a.isAlive(player)) {
+				assert(a.getPlacement(player) > a.getAliveCount() && !placed[a.getPlacement(player)]);
+				placed[a.getPlacement(player)] = true;
+			}
+			else {
+				assert(a.getPlacement(player) == 0);
+			}
+		}
+		assert(a.getAliveCount() < a.getPlayerCount() && "no one was knocked out");
+
+		// a human joins as player 0, stepped by the caller
+		TetrisEngine human(7);
+		BattleRoyale royale(&human, 5, 99, pool);
+		assert(royale.hasHuman() && royale.getPlayerCount() == 6 && &royale.getEngine(BattleRoyale::HUMAN) == &human);
+		human.step(0);
+		royale.step();
+		assert(royale.getTarget(BattleRoyale::HUMAN) > 0 && royale.getAliveCount() == 6);
+
+		// while the human's game is paused (time travel), its stale events (a
+		//   frame restored with rows cleared & a game over) aren't settled again
+		EngineSnapshot shown = human.saveSnapshot();
+		shown.events |= GAME_EVENT_GAME_OVER;
+		shown.clearedRows = 4;
+		human.restoreSnapshot(shown);
+		std::uint64_t garbageSent = royale.getGarbageSent();
+		std::uint32_t pausedFrame = royale.getFrame();
+		royale.setPaused(true);
+		for (int frame = 0; frame < TetrisEngine::FRAMES_PER_SECOND; frame++) { royale.step(); }
+		assert(royale.isPaused() && royale.getFrame() == pausedFrame);
+		assert(royale.isAlive(BattleRoyale::HUMAN) && royale.getGarbageSent() == garbageSent);
+		royale.setPaused(false);
+		human.step(0);	// (resuming steps the human first, which clears the events)
+		royale.step();
+		assert(royale.isAlive(BattleRoyale::HUMAN) && royale.getFrame() == pausedFrame + 1);
+
+		// the human topping out (dropping shapes on garbage) ends a one bot match
+		TetrisEngine loser(8);
+		BattleRoyale duel(&loser, 1, 5, single);
+		for (int frame = 0; !duel.isOver() && frame < 20 * TetrisEngine::FRAMES_PER_SECOND; frame++) {
+			loser.queueGarbage(1, 0);
+			loser.step(frame % 2 == 0 ? BUTTON_DROP : 0);
+			duel.step();
+		}
+		assert(duel.isOver() && duel.getWinner() == 1 && duel.getPlacement(BattleRoyale::HUMAN) == 2);
+		std::uint32_t endFrame = duel.getFrame();
+		duel.step();	// nothing happens once it's over
+		assert(duel.getFrame() == endFrame && duel.getAliveCount() == 1);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testMinimapAtlas()
+	{
+		std::cout << " testMinimapAtlas...";
+
+		MinimapAtlas atlas(12, 5);
+		assert(atlas.getWidth() == 5 * MinimapAtlas::CELL_WIDTH && atlas.getHeight() == 3 * MinimapAtlas::CELL_HEIGHT);
+		Gameboard board;
+		board.setContent(2, Gameboard::MAX_Y - 1, 1);
+		atlas.update(6, board, MINIMAP_TARGET);	// the 2nd cell of the 2nd row
+
+		// the block is red, the rest of the board is opaque, the gaps are clear
+		const std::uint8_t *pixels = atlas.getPixels();
+		auto pixel = [&](int x, int y) { return pixels + (y * atlas.getWidth() + x) * 4; };
+		int left = MinimapAtlas::CELL_WIDTH, top = MinimapAtlas::CELL_HEIGHT;
+		assert(pixel(left + 2, top + Gameboard::MAX_Y - 1)[0] > 200 && pixel(left + 2, top + Gameboard::MAX_Y - 1)[1] < 100);
+		assert(pixel(left + 3, top + Gameboard::MAX_Y - 1)[3] == 255 && pixel(left + 3, top + Gameboard::MAX_Y - 1)[0] < 100);
+		assert(pixel(left + Gameboard::MAX_X, top)[3] == 0);
+		assert(pixel(0, 0)[3] == 0);	// not updated yet
+		atlas.update(6, board, MINIMAP_KNOCKED_OUT);
+		assert(pixel(left + 2, top + Gameboard::MAX_Y - 1)[0] < 100 && pixel(left + 2, top + Gameboard::MAX_Y - 1)[0] > pixel(left + 3, top + Gameboard::MAX_Y - 1)[0]);
+		atlas.update(12, board, MINIMAP_PLAYING);	// out of range: ignored
+
+		// every minimap is one quad: one draw call
+		SoftwareRenderer renderer(200, 200);
+		renderer.setTexture(TEXTURE_MINIMAPS, atlas.getPixels(), atlas.getWidth(), atlas.getHeight());
+		DrawList list;
+		DrawRect dest;
+		dest.width = static_cast<float>(atlas.getWidth() * 2);
+		dest.height = static_cast<float>(atlas.getHeight() * 2);
+		GameView::addMinimaps(list, dest, atlas);
+		assert(list.countBatches() == 1);
+		renderer.clear(DrawColor{ 0, 0, 0, 255 });
+		renderer.render(list);
+		assert(renderer.getPixel((left + 2) * 2 + 1, (top + Gameboard::MAX_Y - 1) * 2 + 1).g == 70);	// (the knocked out grey)
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testCoach()
+	{
+		std::cout << " testCoach...";
+
+		// a snapshot is the board's cells & the two shapes
+		TetrisEngine engine(42);
+		engine.board.fillRow(Gameboard::MAX_Y - 1, 1);
+		engine.board.setContent(4, Gameboard::MAX_Y - 1, Gameboard::EMPTY_BLOCK);
+		CoachSnapshot snapshot = Coach::takeSnapshot(engine);
+		assert(snapshot.shapeNumber == engine.getShapeCount() && snapshot.rows[Gameboard::MAX_Y - 1] == (0x3FF & ~(1 << 4)));
+		assert(snapshot.current.getShape() == engine.getCurrentShape().getShape());
+		assert(snapshot.next.getShape() == engine.getNextShape().getShape());
+
+		// the advice is graded the best there is; dropping the shape where it spawned isn't better
+		CoachAdvice advice = Coach::advise(snapshot);
+		assert(advice.found && advice.shapeNumber == snapshot.shapeNumber);
+		CoachGrade best = Coach::grade(snapshot, advice.ghost);
+		assert(best.level == GRADE_BEST && best.rank == 1 && best.scoreLost == 0 && best.placements > 1);
+		GridTetromino dropped = snapshot.current;
+		assert(PlacementSearch::reach(engine.getBoard(), dropped, 0, dropped.getGridLoc().getX()));
+		CoachGrade worse = Coach::grade(snapshot, dropped);
+		assert(worse.rank >= 1 && worse.scoreLost >= 0);
+
+		// the advice is drawn as a translucent ghost, in the tiles' batch
+		GameView view(Point(54, 125), Point(490, 210), Point(54, 54));
+		DrawList ghostList;
+		view.addGhost(ghostList, advice.ghost);
+		view.addCoachGrade(ghostList, worse);
+		assert(ghostList.getQuads().size() == 4 && ghostList.getTexts().size() == 1);
+		for (const DrawQuad &quad : ghostList.getQuads()) {
+			assert(quad.texture == TEXTURE_TILES && quad.color.a == GameView::GHOST_ALPHA);
+		}
+
+		// on its thread: a bot plays a few shapes, and the coach advises on each & grades each lock
+		//   (a short game, unthrottled: this runs at every launch)
+		Coach coach;
+		coach.start();
+		TetrisEngine played(7);
+		BotPlayer bot(3);
+		int graded = 0;
+		CoachAdvice latest;
+		CoachGrade grade;
+		for (int frame = 0; frame < 3 * TetrisEngine::FRAMES_PER_SECOND; frame++) {
+			played.step(bot.nextButtons(played));
+			coach.observe(played);
+			if (coach.pollAdvice(latest)) {
+				assert(latest.shapeNumber == played.getShapeCount());	// never advice for an old shape
+			}
+			if (coach.pollGrade(grade)) {
+				assert(grade.shapeNumber <= played.getShapeCount() && grade.rank >= 1);
+				graded++;
+			}
+			if (frame % 4 == 0) { std::this_thread::yield(); }	// (let the coach keep up, now and then)
+		}
+		// the newest shape's advice always comes (however far behind the coach is)
+		for (int wait = 0; wait < 50000 && !(latest.shapeNumber == played.getShapeCount() && latest.found && graded > 0); wait++) {
+			coach.pollAdvice(latest);
+			if (coach.pollGrade(grade)) { graded++; }
+			std::this_thread::sleep_for(std::chrono::microseconds(100));
+		}
+		coach.stop();
+		assert(latest.found && latest.shapeNumber == played.getShapeCount() && graded > 0);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	// the columns & rows up from the bottom block a shape covers (sorted)
+	static std::vector<int> footprint(const GridTetromino &shape)
+	{
+		BlockLocs locs = shape.getBlockLocsMappedToGrid();
+		int bottom = locs[0].getY();
+		for (const Point &p : locs) { bottom = std::max(bottom, p.getY()); }
+		std::vector<int> cells;
+		for (const Point &p : locs) { cells.push_back(p.getX() * 100 + bottom - p.getY()); }
+		std::sort(cells.begin(), cells.end());
+		return cells;
+	}
+
+	static bool testFinesse()
+	{
+		std::cout << " testFinesse...";
+
+		const FinesseTable &table = FinesseTable::get();
+		const int spawnX = Gameboard().getSpawnLoc().getX();
+		const InputMask BUTTONS[] = { BUTTON_ROTATE, BUTTON_LEFT, BUTTON_RIGHT, BUTTON_LEFT, BUTTON_RIGHT };
+		int placements = 0;
+		for (int shape = 0; shape < TetShape::COUNT; shape++) {
+			assert(table.getPath(TetShape(shape), 0, spawnX).reachable && table.getPath(TetShape(shape), 0, spawnX).count == 0);
+			for (int rotation = 0; rotation < 4; rotation++) {
+				for (int x = FinesseTable::MIN_X; x < FinesseTable::MIN_X + FinesseTable::COLUMNS; x++) {
+					const FinessePath &path = table.getPath(TetShape(shape), rotation, x);
+					if (!path.reachable) { continue; }
+					placements++;
+
+					// playing the path in an engine lands the shape on the same cells
+					TetrisEngine engine(1);
+					engine.currentShape.setShape(TetShape(shape));
+					engine.currentShape.setGridLoc(engine.board.getSpawnLoc());
+					for (int move = 0; move < path.count; move++) {
+						bool held = path.moves[move] == FINESSE_DAS_LEFT || path.moves[move] == FINESSE_DAS_RIGHT;
+						for (int frame = 0; frame < (held ? 30 : 1); frame++) { engine.step(BUTTONS[path.moves[move]]); }
+						engine.step(0);
+					}
+					GridTetromino target = engine.currentShape;
+					target.setShape(TetShape(shape));
+					for (int r = 0; r < rotation; r++) { target.rotateClockwise(); }
+					target.setGridLoc(x, 0);
+					assert(TestSuite::footprint(engine.currentShape) == TestSuite::footprint(target));
+				}
+			}
+		}
+		assert(placements > 7 * Gameboard::MAX_X);
+		assert(!table.getPath(TetShape::I, 0, FinesseTable::MIN_X - 1).reachable);
+
+		// to the wall is one held press; an O's rotations don't cost presses
+		const FinessePath &iLeft = table.getPath(TetShape::I, 0, 1);
+		assert(iLeft.count == 1 && iLeft.moves[0] == FINESSE_DAS_LEFT);
+		assert(table.getPath(TetShape::O, 1, spawnX).count == 0);
+		assert(table.getPath(TetShape::T, 2, spawnX).count == 2);
+
+		// the tracker counts the player's presses against the table's
+		FinesseTracker tracker;
+		TetrisEngine engine(3);
+		tracker.observe(engine, 0);
+		const InputMask wasteful[] = { BUTTON_LEFT, 0, BUTTON_RIGHT, 0, BUTTON_DROP, 0 };
+		for (InputMask buttons : wasteful) {
+			engine.step(buttons);
+			tracker.observe(engine, buttons);
+		}
+		assert(tracker.hasResult() && tracker.getLastResult().presses == 2);
+		assert(tracker.getLastResult().minimum == 0 && tracker.getLastResult().errors == 2);
+		for (int frame = 0; frame < TetrisEngine::FRAMES_PER_SECOND; frame++) {	// (the next shape spawns)
+			engine.step(0);
+			tracker.observe(engine, 0);
+		}
+		engine.step(BUTTON_DROP);
+		tracker.observe(engine, BUTTON_DROP);
+		assert(tracker.getLastResult().presses == 0 && tracker.getLastResult().errors == 0);
+		assert(tracker.getShapes() == 2 && tracker.getFaults() == 1 && tracker.getErrors() == 2);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testTickHistory()
+	{
+		std::cout << " testTickHistory...";
+
+		// small enough to keep one for every frame
+		assert(sizeof(EngineSnapshot) <= 256);
+
+		// a restored snapshot is the same game, and plays on the same
+		TetrisEngine a(91);
+		for (int frame = 0; frame < 1500; frame++) {
+			if (frame == 700) { a.queueGarbage(2, 3); }
+			a.step(TetrisEngine::autoplayButtons(1, frame));
+		}
+		EngineSnapshot snapshot = a.saveSnapshot();
+		TetrisEngine b(5);
+		for (int frame = 0; frame < 400; frame++) { b.step(TetrisEngine::autoplayButtons(2, frame)); }
+		b.restoreSnapshot(snapshot);
+		assert(TestSuite::isSameGame(a, b) && "restoring an EngineSnapshot failed");
+		assert(b.getBoard().haveChangesOverflowed());
+		assert(b.getLastLocked().getShape() == a.getLastLocked().getShape());
+		assert(b.getCurrentShape().getRotation() == a.getCurrentShape().getRotation());
+		for (int frame = 1500; frame < 2500; frame++) {
+			a.step(TetrisEngine::autoplayButtons(1, frame));
+			b.step(TetrisEngine::autoplayButtons(1, frame));
+		}
+		assert(TestSuite::isSameGame(a, b) && "a restored EngineSnapshot played differently");
+
+		// the ring keeps the newest capacity snapshots, by age
+		TickHistory history(5);
+		TetrisEngine e(8);
+		for (int frame = 0; frame < 8; frame++) {
+			e.step(TetrisEngine::autoplayButtons(0, frame));
+			history.record(e);
+		}
+		assert(history.size() == 5 && history.getCapacity() == 5);
+		assert(history.get(0).frame == 8 && history.get(4).frame == 4);
+
+		// resuming from an older snapshot forgets the newer ones
+		history.dropNewest(2);
+		assert(history.size() == 3 && history.get(0).frame == 6);
+		e.restoreSnapshot(history.get(0));
+		e.step(0);
+		history.record(e);
+		assert(history.size() == 4 && history.get(0).frame == 7 && history.get(3).frame == 4);
+		history.clear();
+		assert(history.size() == 0);
+		history.record(e);
+		assert(history.size() == 1 && history.get(0).frame == 7);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testStateHash()
+	{
+		std::cout << " testStateHash...";
+
+		// the same game hashes the same every step, on any thread
+		std::vector<std::uint64_t> hashes(1200), threadHashes(1200);
+		std::thread other([&threadHashes]() {
+			TetrisEngine engine(21);
+			for (int frame = 0; frame < 1200; frame++) {
+				engine.step(TetrisEngine::autoplayButtons(0, frame));
+				threadHashes[frame] = engine.getStateHash();
+			}
+		});
+		TetrisEngine a(21);
+		for (int frame = 0; frame < 1200; frame++) {
+			a.step(TetrisEngine::autoplayButtons(0, frame));
+			hashes[frame] = a.getStateHash();
+		}
+		other.join();
+		assert(hashes == threadHashes && "the same game hashed differently");
+		assert(std::count(hashes.begin(), hashes.end(), hashes.back()) == 1);
+
+		// a restored snapshot hashes the same; a different game doesn't
+		TetrisEngine b(3);
+		b.restoreSnapshot(a.saveSnapshot());
+		assert(b.getStateHash() == a.getStateHash());
+		assert(TetrisEngine(21).getStateHash() != TetrisEngine(22).getStateHash());
+		TetrisEngine moved = a;
+		moved.step(BUTTON_LEFT);
+		b.step(0);
+		assert(moved.getStateHash() != b.getStateHash());
+
+		// the board's change journal isn't game state
+		b.clearBoardChanges();
+		TetrisEngine same = b;
+		same.invalidateBoardChanges();
+		assert(same.getStateHash() == b.getStateHash());
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	// every cell & row mask the same?
+	static bool isSameBoard(const Gameboard &reference, const BitBoard &optimized)
+	{
+		for (int y = 0; y < Gameboard::MAX_Y; y++) {
+			if (reference.getRowMask(y) != optimized.getRowMask(y)) { return false; }
+			for (int x = 0; x < Gameboard::MAX_X; x++) {
+				if (reference.getContent(x, y) != optimized.getContent(x, y)) { return false; }
+			}
+		}
+		return true;
+	}
+
+	static bool testBitBoard()
+	{
+		std::cout << " testBitBoard...";
+
+		// the same rows, completed & not, in both: removing them leaves the same board
+		Gameboard reference;
+		BitBoard optimized;
+		assert(TestSuite::isSameBoard(reference, optimized));
+		const int full[] = { Gameboard::MAX_Y - 1, Gameboard::MAX_Y - 3, Gameboard::MAX_Y - 4, 2 };
+		for (int y : full) {
+			for (int x = 0; x < Gameboard::MAX_X; x++) {
+				reference.setContent(x, y, x % 7);
+				optimized.setContent(x, y, x % 7);
+			}
+		}
+		reference.setContent(4, Gameboard::MAX_Y - 2, 3);
+		optimized.setContent(4, Gameboard::MAX_Y - 2, 3);
+		reference.setContent(0, 1, 5);
+		optimized.setContent(0, 1, 5);
+		assert(optimized.getRowMask(2) == BitBoard::FULL_ROW);
+		assert(TestSuite::isSameBoard(reference, optimized));
+		assert(reference.removeCompletedRows() == 4 && optimized.removeCompletedRows() == 4);
+		assert(TestSuite::isSameBoard(reference, optimized));
+		assert(optimized.getContent(4, Gameboard::MAX_Y - 1) == 3 && optimized.getContent(0, 5) == 5);
+
+		// off the grid points are disregarded; fits() has the engine's borders
+		BlockLocs offGrid = { Point(-1, 0), Point(4, -2), Point(Gameboard::MAX_X, 3) };
+		assert(optimized.areLocsEmpty(offGrid) && reference.areLocsEmpty(offGrid));
+		assert(!optimized.fits(offGrid));
+		assert(optimized.fits({ Point(4, -2), Point(4, -1) }));
+		assert(!optimized.fits({ Point(4, Gameboard::MAX_Y) }));
+		assert(!optimized.fits({ Point(4, Gameboard::MAX_Y - 1) }) && !optimized.areLocsEmpty({ Point(4, Gameboard::MAX_Y - 1) }));
+
+		// garbage & emptying, and a copy of a Gameboard
+		assert(reference.raiseRows(2, 8, 3) == optimized.raiseRows(2, 8, 3));
+		assert(TestSuite::isSameBoard(reference, optimized));
+		assert(TestSuite::isSameBoard(reference, BitBoard(reference)));
+		reference.empty();
+		optimized.empty();
+		assert(TestSuite::isSameBoard(reference, optimized));
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+#ifdef SHADERBOARDRENDERER_H
+	// draw a board with the ShaderBoardRenderer and with the board layer's tile
+	//   quads (GameView::addBoard()), and compare the pixels
+	static bool isShaderBoardSameAsLayer(ShaderBoardRenderer &shaderBoard, const sf::Texture &tiles, const Gameboard &board,
+		sf::RenderTexture &shaderTarget, sf::RenderTexture &layerTarget)
+	{
+		shaderBoard.update(board);
+		shaderTarget.clear(sf::Color::Transparent);
+		shaderBoard.draw(shaderTarget, Point(0, 0));
+		shaderTarget.display();
+
+		GameView view(Point(0, 0), Point(0, 0), Point(0, 0));
+		DrawList list;
+		view.addBoard(list, board, Point(0, 0));
+		SfmlDrawListRenderer renderer;
+		renderer.setTexture(TEXTURE_TILES, &tiles);
+		layerTarget.clear(sf::Color::Transparent);
+		renderer.render(list, layerTarget);
+		layerTarget.display();
+
+		sf::Image shaded = shaderTarget.getTexture().copyToImage();
+		sf::Image layered = layerTarget.getTexture().copyToImage();
+		for (unsigned y = 0; y < shaded.getSize().y; y++) {
+			for (unsigned x = 0; x < shaded.getSize().x; x++) {
+				sf::Color a = shaded.getPixel(x, y), b = layered.getPixel(x, y);
+				if (std::abs(a.r - b.r) > 2 || std::abs(a.g - b.g) > 2 || std::abs(a.b - b.b) > 2 || std::abs(a.a - b.a) > 2) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	// the shader path draws the board as the board layer does.  Skipped where
+	//   shaders (or render textures) aren't available; headless, it runs on
+	//   Mesa's software rasterizer (eg: LIBGL_ALWAYS_SOFTWARE=1 under Xvfb)
+	static bool testShaderBoardRenderer()
+	{
+		std::cout << " testShaderBoardRenderer...";
+
+		const int width = Gameboard::MAX_X * GameView::BLOCK_WIDTH;
+		const int height = Gameboard::MAX_Y * GameView::BLOCK_HEIGHT;
+		sf::RenderTexture shaderTarget, layerTarget;
+		if (!sf::Shader::isAvailable() || !shaderTarget.create(width, height) || !layerTarget.create(width, height)) {
+			std::cout << "skipped (no shaders)" << "\n";
+			return true;
+		}
+
+		// solid tiles, a color each (so the two paths' filtering can't differ)
+		sf::Image tileImage;
+		tileImage.create(GameView::BLOCK_WIDTH * 7, GameView::BLOCK_HEIGHT);
+		for (unsigned x = 0; x < tileImage.getSize().x; x++) {
+			sf::Uint8 tile = static_cast<sf::Uint8>(x / GameView::BLOCK_WIDTH);
+			for (unsigned y = 0; y < tileImage.getSize().y; y++) {
+				tileImage.setPixel(x, y, sf::Color(30 + 30 * tile, 240 - 30 * tile, 100, 255));
+			}
+		}
+		sf::Texture tiles;
+		bool loaded = tiles.loadFromImage(tileImage);
+		ShaderBoardRenderer shaderBoard;
+		bool created = loaded && shaderBoard.create(tiles, GameView::BLOCK_WIDTH, GameView::BLOCK_HEIGHT);
+		assert(created && "shaders are available, but the shader board couldn't be created");
+
+		// every color, in the corners & along the edges (where a padded cell texture would be off)
+		Gameboard board;
+		for (int x = 0; x < Gameboard::MAX_X; x++) {
+			board.setContent(x, Gameboard::MAX_Y - 1, x % 7);
+			board.setContent(x, 0, (x + 3) % 7);
+		}
+		board.setContent(0, 7, 2);
+		board.setContent(Gameboard::MAX_X - 1, 8, 5);
+		assert(TestSuite::isShaderBoardSameAsLayer(shaderBoard, tiles, board, shaderTarget, layerTarget));
+
+		// a cell changed through the journal (a 1x1 upload) is drawn too
+		board.clearChanges();
+		board.setContent(4, 9, 6);
+		board.setContent(0, Gameboard::MAX_Y - 1, Gameboard::EMPTY_BLOCK);
+		assert(TestSuite::isShaderBoardSameAsLayer(shaderBoard, tiles, board, shaderTarget, layerTarget));
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+#endif
+
 #ifdef GAMEBOARD_H
 	static bool isGameboardEmpty(Gameboard &g)
 	{
@@ -339,6 +1851,41 @@ public:
 		testPoints.push_back(Point(2, 2));
 		assert(g.areLocsEmpty(testPoints) == false);  // should return false since 2,2 contains content 2
 
+		// test the change journal
+		g.empty();
+		assert(g.getChangeCount() == 1 && g.getChange(0).type == BoardChange::BOARD_EMPTIED);
+		g.clearChanges();
+		g.setContent(3, 4, 2);
+		g.setContent(3, 4, 2);	// no change: not recorded
+		assert(g.getChangeCount() == 1 && g.getChange(0).type == BoardChange::CELL_SET);
+		assert(g.getChange(0).x == 3 && g.getChange(0).y == 4 && g.getChange(0).content == 2);
+		g.fillRow(6, 1);
+		g.clearChanges();
+		assert(g.removeCompletedRows() == 1);
+		assert(g.getChangeCount() == 1 && g.getChange(0).type == BoardChange::ROW_REMOVED && g.getChange(0).y == 6);
+		assert(!g.haveChangesOverflowed());
+		for (int i = 0; i <= Gameboard::MAX_CHANGES; i++) {
+			g.setContent(i % Gameboard::MAX_X, 10 + i / Gameboard::MAX_X, 3);
+		}
+		assert(g.haveChangesOverflowed());	// too many changes: consumers must rescan
+		g.clearChanges();
+		assert(g.getChangeCount() == 0 && !g.haveChangesOverflowed());
+		g.invalidateChanges();
+		assert(g.haveChangesOverflowed());
+		g.clearChanges();
+
+		// test getRowMask() & raiseRows()
+		g.empty();
+		g.setContent(0, 0, 2);
+		g.setContent(9, Gameboard::MAX_Y - 1, 2);
+		assert(g.getRowMask(0) == 1 && g.getRowMask(Gameboard::MAX_Y - 1) == (1 << 9) && g.getRowMask(10) == 0);
+		assert(g.raiseRows(2, 3, 4) == false);	// the block in row 0 was pushed off
+		assert(g.getRowMask(Gameboard::MAX_Y - 3) == (1 << 9));
+		assert(g.getRowMask(Gameboard::MAX_Y - 2) == (0x3FF & ~(1 << 4)) && g.getContent(0, Gameboard::MAX_Y - 1) == 3);
+		assert(g.getRowMask(0) == 0 && g.haveChangesOverflowed());
+		assert(g.raiseRows(1, 3, 0) == true);
+		g.clearChanges();
+
 		// lastly do a visual printout of an empty board
 		g.empty();
 		g.printToConsole();
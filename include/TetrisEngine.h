@@ -0,0 +1,322 @@
+// The TetrisEngine class encapsulates the gameplay rules of a single tetris game:
+// the board, the falling & "on-deck" tetrominoes, the score and the tick timing.
+//
+// The TetrisEngine has no concept of a window, a sprite or a font!
+// This is intentional.  Keeping the rules headless means an engine can be:
+//   - stepped without a window (servers, bots, tests),
+//   - copied by value to take a snapshot, and assigned to restore one,
+//   - re-simulated deterministically (the same seed & the same inputs always
+//     produce the same game), which is what rollback netcode relies on.
+// Drawing is handled by TetrisGame (which owns an engine).
+//
+// There are 2 ways to drive an engine:
+//   1) event style (the original TetrisGame behaviour):
+//        onButtonPressed() for each key press, processGameLoop() once per loop.
+//   2) fixed step style (netplay/replays):
+//        step() once per simulation frame with the mask of buttons held down
+//        during that frame.  A button acts on the frame it goes down.
+//
+// In the fixed step style, held buttons also auto-repeat inside the simulation
+// (see AutoRepeatSettings): LEFT / RIGHT shift again after a delay (DAS) and
+// then every few frames (ARR), and DOWN soft drops every few frames.  Because
+// it's counted in frames rather than left to the OS key repeat, fast movement
+// is the same at any frame rate, and replays & netplay reproduce it exactly.
+//
+// Besides copying the whole engine, its state can be saved as a compact
+// EngineSnapshot (a couple of hundred bytes: the board at 4 bits a cell), cheap
+// enough to keep one for every frame of the last few seconds (see TickHistory).
+// getStateHash() boils the same state down to 64 bits: two engines that hash
+// the same after every step() played the same game, which is how replays,
+// netplay & changes to the rules are checked for desyncs (see src/desync).
+//
+// In multiplayer modes opponents send garbage (queueGarbage()): rows of
+// GARBAGE_COLOR (dark blue) with one hole each, which rise from the bottom the next time a shape locks
+// without clearing a row.  getClearedRows() tells the mode what to send back.
+//
+//  [expected .cpp size: ~ 380 lines]
+
+#ifndef TETRISENGINE_H
+#define TETRISENGINE_H
+
+#include <cstdint>
+#include "Gameboard.h"
+#include "GridTetromino.h"
+
+// the buttons a player can hold down (combined into an InputMask)
+enum InputButton {
+	BUTTON_ROTATE = 1 << 0,
+	BUTTON_LEFT = 1 << 1,
+	BUTTON_RIGHT = 1 << 2,
+	BUTTON_DOWN = 1 << 3,
+	BUTTON_DROP = 1 << 4
+};
+
+// a set of InputButtons held down during one simulation frame
+typedef std::uint8_t InputMask;
+
+// things that happen in a game (for sound effects & the like)
+enum GameEvent {
+	GAME_EVENT_ROTATED = 1 << 0,				// the falling shape rotated
+	GAME_EVENT_LOCKED = 1 << 1,					// a shape was locked onto the board
+	GAME_EVENT_ROWS_CLEARED = 1 << 2,		// completed rows were removed
+	GAME_EVENT_GAME_OVER = 1 << 3				// a shape couldn't spawn: the game was reset
+};
+
+// a set of GameEvents
+typedef std::uint8_t GameEventMask;
+
+// how held buttons repeat in step(), in simulation frames
+//   (every peer of a netplay game, and a replay, must use the same settings)
+struct AutoRepeatSettings
+{
+	int delayFrames = 10;			// DAS: frames LEFT / RIGHT are held before they repeat (at least 1)
+	int repeatFrames = 2;			// ARR: frames between repeats (0: shift straight to the wall)
+	int softDropFrames = 2;		// frames between the rows a held DOWN moves (at least 1)
+};
+
+// an engine's state, packed (see TetrisEngine::saveSnapshot())
+//   (the auto-repeat settings aren't state: they stay as they are)
+struct EngineSnapshot
+{
+	static const int CELL_BYTES = (Gameboard::MAX_X * Gameboard::MAX_Y + 1) / 2;
+
+	std::uint8_t cells[CELL_BYTES] = {};		// 2 cells a byte (low nibble first): content + 1 (0: empty)
+	std::uint8_t currentShape = 0;					// TetShape
+	std::uint8_t currentRotation = 0;
+	std::int8_t currentX = 0;
+	std::int8_t currentY = 0;
+	std::uint8_t nextShape = 0;
+	std::uint8_t lastLockedShape = 0;
+	std::uint8_t lastLockedRotation = 0;
+	std::int8_t lastLockedX = 0;
+	std::int8_t lastLockedY = 0;
+	std::int32_t score = 0;
+	std::uint32_t rngState = 0;
+	std::uint32_t frame = 0;
+	std::uint32_t shapeCount = 0;
+	double secondsPerTick = 0;
+	double secondsSinceLastTick = 0;
+	std::uint32_t shiftHeldFrames = 0;
+	std::uint32_t downHeldFrames = 0;
+	InputMask previousButtons = 0;
+	InputMask shiftButton = 0;
+	GameEventMask events = 0;
+	std::uint8_t clearedRows = 0;
+	bool shapePlaced = false;
+	std::uint8_t pendingGarbage = 0;
+	std::int8_t garbageHoles[Gameboard::MAX_Y] = {};		// (MAX_PENDING_GARBAGE of them)
+};
+
+class TetrisEngine
+{
+	friend class TestSuite;
+public:
+	// STATIC CONSTANTS
+	static const int FRAMES_PER_SECOND = 60;										// fixed simulation rate used by step()
+	static constexpr double SECONDS_PER_FRAME = 1.0 / FRAMES_PER_SECOND;
+	static constexpr double MAX_SECONDS_PER_TICK = 0.75;				// start off with a slow (max) tick rate. (seconds per game tick)
+	static constexpr double MIN_SECONDS_PER_TICK = 0.20;				// this is the fastest tick pace (seconds per game tick).
+	static const InputMask ALL_BUTTONS = BUTTON_ROTATE | BUTTON_LEFT | BUTTON_RIGHT | BUTTON_DOWN | BUTTON_DROP;
+	static const int MAX_PENDING_GARBAGE = Gameboard::MAX_Y;		// garbage rows that can wait to rise (more are dropped)
+	static const TetColor GARBAGE_COLOR = BLUE_DARK;						// the content of garbage blocks
+
+	// MEMBER FUNCTIONS
+
+	// constructor
+	//   seed the shape generator & reset() the game
+	explicit TetrisEngine(std::uint32_t seed = 1);
+
+	// reset everything for a new game (use existing functions)
+	//  - set the score to 0
+	//  - call determineSecondsPerTick() to determine the tick rate.
+	//  - clear the gameboard,
+	//  - pick & spawn next shape
+	//  - pick next shape again (for the "on-deck" shape)
+	void reset();
+
+	// handle a single button press (rotate, left, right, down, drop)
+	void onButtonPressed(InputButton button);
+
+	// called every game loop to handle ticks & tetromino placement (locking)
+	void processGameLoop(double secondsSinceLastLoop);
+
+	// advance the game by exactly one simulation frame (SECONDS_PER_FRAME).
+	//   - the board's change journal & the events are cleared, so afterwards
+	//     they hold exactly what this frame changed & what happened in it
+	//   - buttons in heldButtons that were not held last frame are pressed
+	//   - buttons held longer auto-repeat (see AutoRepeatSettings)
+	//   - then processGameLoop() runs for one frame
+	void step(InputMask heldButtons);
+
+	// the auto-repeat used by step() (the values are clamped to their minimums)
+	void setAutoRepeat(const AutoRepeatSettings &settings);
+	const AutoRepeatSettings& getAutoRepeat() const;
+
+	// A tick() forces the currentShape to move (if there were no tick,
+	// the currentShape would float in position forever). This should
+	// call attemptMove() on the currentShape.  If not successful, lock()
+	// the currentShape (it can move no further), and record the fact that a
+	// shape was placed (using shapePlacedSinceLastGameLoop)
+	void tick();
+
+	// accessors (for drawing & inspecting the game)
+	const Gameboard& getBoard() const;
+	const GridTetromino& getCurrentShape() const;
+	const GridTetromino& getNextShape() const;
+	int getScore() const;
+	// the number of step() frames simulated since construction
+	std::uint32_t getFrame() const;
+	// the number of shapes spawned since construction (the current shape's number)
+	std::uint32_t getShapeCount() const;
+	// the shape last locked onto the board (where it was locked)
+	const GridTetromino& getLastLocked() const;
+	// how far the time to the next tick has gone (0 just after a tick, 1 when the next is due),
+	//   secondsAhead after the last processGameLoop() (for drawing between simulation frames)
+	double getTickProgress(double secondsAhead = 0) const;
+	// could the currentShape fall one more row? (false: the next tick locks it)
+	bool canCurrentShapeFall() const;
+
+	// the GameEvents since the last clearEvents() (so for step() users: in the last step())
+	GameEventMask getEvents() const;
+	// the rows cleared since the last clearEvents() (with GAME_EVENT_ROWS_CLEARED)
+	int getClearedRows() const;
+	// forget the events (event style users: once per loop, after reading them)
+	void clearEvents();
+
+	// queue garbage rows (eg: sent by an opponent): they rise from the bottom,
+	//   with a hole at holeX, the next time a shape locks without clearing a
+	//   row (rows past MAX_PENDING_GARBAGE are dropped).  If the falling shape
+	//   no longer fits once they have risen, the game is over.
+	void queueGarbage(int rows, int holeX);
+	// the garbage rows waiting to rise
+	int getPendingGarbage() const;
+
+	// clear the board's change journal (event style users: once per loop,
+	//   after everything that reads the journal has run)
+	void clearBoardChanges();
+	// save the game's state, or restore a saved one (the board's change
+	//   journal is invalidated: it no longer describes the board)
+	//   Board contents must be in -1 to 14 (EMPTY_BLOCK & the colors are)
+	EngineSnapshot saveSnapshot() const;
+	void restoreSnapshot(const EngineSnapshot &snapshot);
+	// a 64-bit hash of the game's state (everything a snapshot holds)
+	//   call it after each step() to compare games tick by tick
+	std::uint64_t getStateHash() const;
+	// a busy, repeatable set of buttons for game index to hold on a frame
+	//   (mostly moving & rotating, a new set every 8 frames): for autoplay,
+	//   and for tools that replay the same game in two builds
+	static InputMask autoplayButtons(int index, int frame);
+
+	// mark the board's change journal as overflowed, so its consumers rescan
+	//   (after restoring a snapshot, the journal no longer describes the board)
+	//   The mark is kept through the next step(), so consumers reading after it see it too.
+	void invalidateBoardChanges();
+
+private:
+	// return the next value of the (xorshift32) shape generator
+	std::uint32_t nextRandom();
+
+	// set a shape from a snapshot's fields (see restoreSnapshot())
+	static void restoreShape(GridTetromino &shape, std::uint8_t type, std::uint8_t rotation, int x, int y);
+
+	// assign nextShape.setShape a new random shape
+	void pickNextShape();
+
+	// copy the nextShape into the currentShape (through assignment)
+	//   position the currentShape to its spawn location.
+	//	 - return true/false based on isPositionLegal()
+	bool spawnNextShape();
+
+	// Test if a rotation is legal on the tetromino and if so, rotate it.
+	//  To do this:
+	//	 1) create a (local) temporary copy of the tetromino
+	//	 2) rotate it (shape.rotateClockwise())
+	//	 3) test if temp rotation was legal (isPositionLegal()),
+	//      if so - rotate the original tetromino.
+	//	 4) return true/false to indicate successful movement
+	bool attemptRotate(GridTetromino &shape);
+
+	// test if a move is legal on the tetromino, if so, move it.
+	//  To do this:
+	//	 1) create a (local) temporary copy of the tetromino
+	//	 2) move it (temp.move())
+	//	 3) test if temp move was legal (isPositionLegal(),
+	//      if so - move the original.
+	//	 4) return true/false to indicate successful movement
+	bool attemptMove(GridTetromino &shape, int x, int y);
+
+	// drops the tetromino vertically as far as it can
+	//   legally go.  Use attemptMove(). This can be done in 1 line.
+	void drop(GridTetromino &shape);
+
+	// copy the contents (color) of the tetromino's mapped block locs to the grid.
+	//	 1) get current blockshape locs via tetromino.getBlockLocsMappedToGrid()
+	//	 2) copy the content (color) to the grid (via gameboard.setContent())
+	//   blocks still above the top of the board (when topping out) are not copied.
+	//   GAME_EVENT_LOCKED happens if the board changed (not when a shape locked
+	//   by DOWN / DROP is locked again by the next tick).
+	void lock(const GridTetromino &shape);
+
+	// return true if shape is within borders (isShapeWithinBorders())
+	//	 and the shape's mapped board locs are empty.
+	//   Make use of Gameboard's areLocsEmpty() and pass it the shape's mapped locs.
+	bool isPositionLegal(const GridTetromino &shape) const;
+
+	// return true if the shape is within the left, right, and lower border of
+	//	 the grid, but *NOT* the top border. (return false otherwise)
+	//   * Ignore the upper border because we want shapes to be able to drop
+	//     in from the top of the gameboard.
+	//   All of a shape's blocks must be inside these 3 borders to return true
+	bool isShapeWithinBorders(const GridTetromino &shape) const;
+
+	// repeat the held buttons that are due this step() (after the presses)
+	//   - the shift follows the most recently pressed of LEFT / RIGHT; releasing
+	//     it hands over to the other one if that's still held (which charges
+	//     its delay again)
+	void autoRepeat(InputMask heldButtons, InputMask pressed);
+
+	// raise the pending garbage rows (see queueGarbage())
+	//   return false if that topped the board out (blocks were pushed off the
+	//   top, or the falling shape no longer fits)
+	bool raiseGarbage();
+
+	// set secsPerTick
+	//   - basic: use MAX_SECS_PER_TICK
+	//   - advanced: base it on score (higher score results in lower secsPerTick)
+	void determineSecondsPerTick();
+
+	// MEMBER VARIABLES
+
+	// State members ---------------------------------------------
+	int score = 0;							// the current game score.
+	Gameboard board;						// the gameboard (grid) to represent where all the blocks are.
+	GridTetromino nextShape;		// the tetromino shape that is "on deck".
+	GridTetromino currentShape; // the tetromino that is currently falling.
+	GridTetromino lastLocked;		// the tetromino that was last locked onto the board.
+	std::uint32_t shapeCount = 0;	// shapes spawned since construction.
+	std::uint32_t rngState;			// state of the shape generator (never 0)
+
+	// Input members ---------------------------------------------
+	InputMask previousButtons = 0;	// buttons held during the previous step()
+	std::uint32_t frame = 0;				// frames simulated by step()
+	AutoRepeatSettings autoRepeatSettings;	// DAS / ARR / soft drop rates used by step()
+	InputMask shiftButton = 0;			// BUTTON_LEFT / BUTTON_RIGHT being auto-repeated (0: none)
+	std::uint32_t shiftHeldFrames = 0;	// frames shiftButton has been held since it was pressed
+	std::uint32_t downHeldFrames = 0;		// frames BUTTON_DOWN has been held since it was pressed
+	bool boardChangesInvalidated = false;	// invalidateBoardChanges() not yet seen by a step()
+	GameEventMask events = 0;				// what happened since the last clearEvents()
+	int clearedRows = 0;						// rows cleared since the last clearEvents()
+	std::int8_t garbageHoles[MAX_PENDING_GARBAGE] = {};	// the hole of each garbage row waiting to rise (oldest first)
+	int pendingGarbage = 0;					// the number of garbage rows waiting to rise
+
+	// Time members ----------------------------------------------
+	// Note: a "tick" is the amount of time it takes a block to fall one line.
+	double secondsPerTick = MAX_SECONDS_PER_TICK; // the number of seconds per tick (changes depending on score)
+
+	double secondsSinceLastTick = 0.0;				 // update this every game loop until it is >= secsPerTick,
+																						 // we then know to trigger a tick.  Reduce this var (by a tick) & repeat.
+	bool shapePlacedSinceLastGameLoop = false; // Tracks whether we have placed (locked) a shape on
+																						 // the gameboard in the current gameloop
+};
+
+#endif /* TETRISENGINE_H */
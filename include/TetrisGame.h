@@ -3,23 +3,38 @@
 // and have them run side by side (player vs player).
 // So, anything you would need for an individual tetris game has been included here.
 // Anything you might use between games (like the background, or the sprite used for
-// rendering a tetromino block) was left in main.cpp
+// rendering a tetromino block) was left in main.cpp, and the assets are shared
+// between games through a ResourceCache.
 //
 // This class is responsible for:
-//   - setting up the board,
 //	 - drawing game elements to the screen
-//   - spawning tetrominoes,
-//   - handling user input,
-//   - moving and placing tetrominoes
+//   - handling user input (translating keys into engine buttons)
+// What the game looks like is described by a GameView as a backend-neutral
+// DrawList, which this class draws on the window with an SfmlDrawListRenderer.
+// The gameplay itself (the board, spawning, moving and placing tetrominoes)
+// lives in TetrisEngine, which can also run without a window.
 //
-//  [expected .cpp size: ~ 275 lines]
+// Every step() is recorded in a TickHistory, so the game can be paused (F7)
+// and stepped back & forth through its last few seconds, for debugging.
+//
+//  [expected .cpp size: ~ 340 lines]
 
 #ifndef TETRISGAME_H
 #define TETRISGAME_H
 
+#include "AudioSystem.h"
+#include "Coach.h"
+#include "Finesse.h"
 #include "Gameboard.h"
 #include "GridTetromino.h"
+#include "GameView.h"
+#include "InputThread.h"
+#include "ResourceCache.h"
+#include "SfmlDrawListRenderer.h"
+#include "ShaderBoardRenderer.h"
+#include "TetrisEngine.h"
 #include "TestSuite.h"
+#include "TickHistory.h"
 #include <SFML/Graphics.hpp>
 
 class TetrisGame
@@ -27,160 +42,154 @@ class TetrisGame
 	friend class Testsuite;
 public:
 	// STATIC CONSTANTS
-	static const int BLOCK_WIDTH = 32;	// pixel width of a tetris block
-	static const int BLOCK_HEIGHT = 32; // pixel height of a tetris block
+	static const int BLOCK_WIDTH = GameView::BLOCK_WIDTH;	// pixel width of a tetris block
+	static const int BLOCK_HEIGHT = GameView::BLOCK_HEIGHT; // pixel height of a tetris block
 
 	// MEMBER FUNCTIONS
 
 	// constructor
 	//   initialize/assign variables
-	//   reset() the game
-	//   load font from file: fonts/RedOctober.ttf
-	//   setup scoreText
-	TetrisGame(sf::RenderWindow &window, sf::Sprite &blockSprite, Point gameboardOffset, Point nextShapeOffset);
+	//   seed the engine (from rand()) which resets the game
+	//   get the font from resources: fonts/RedOctober.ttf (shared with other games)
+	//   setup the draw list renderer (blockSprite's texture & the font)
+	TetrisGame(sf::RenderWindow &window, sf::Sprite &blockSprite, Point gameboardOffset, Point nextShapeOffset,
+		ResourceCache &resources);
 
 	// Draw anything to do with the game,
 	//   includes the board, currentShape, nextShape, score
-	//   called every game loop
-	void draw();
+	//   called every rendered frame.
+	//   secondsAhead: how long after the last step() this frame is
+	//   shown (the falling shape is drawn where it would be by then)
+	void draw(double secondsAhead = 0);
+
+	// draw a debug overlay (lines of text, eg: statistics) over the top left
+	//   of the window, in the score font.  Call it after draw().
+	void drawOverlay(const std::vector<std::string> &lines);
 
 	// Event and game loop processing
-	// handles keypress events (up, left, right, down, space)
+	// handles window keypress events that aren't gameplay:
+	//   F2 toggles the shader board render path
+	//   F5 toggles coaching
+	//   F7 toggles time travel, where Left / Right step a frame back / forward,
+	//   and Down / Up a second
+	// (the gameplay keys are read by the InputThread, see onInputEvent())
 	void onKeyPressed(sf::Event event);
 
-	// called every game loop to handle ticks & tetromino placement (locking)
-	void processGameLoop(float secondsSinceLastLoop);
+	// handle a button press/release from the InputThread
+	//   (call it before the step() the event happened in)
+	void onInputEvent(const InputEvent &event);
+
+	// hold exactly these buttons from now on (for scripted or bot players, instead
+	//   of onInputEvent())
+	void setHeldButtons(InputMask buttons);
 
-	// A tick() forces the currentShape to move (if there were no tick,
-	// the currentShape would float in position forever). This should
-	// call attemptMove() on the currentShape.  If not successful, lock()
-	// the currentShape (it can move no further), and record the fact that a
-	// shape was placed (using shapePlacedSinceLastGameLoop)
+	// advance the game one fixed simulation step (TetrisEngine::SECONDS_PER_FRAME)
+	//   with the buttons held (see TetrisEngine::step(), which also auto-repeats them)
+	//   a button pressed & released since the last step is held for this one
+	void step();
+
+	// force a tick on the engine (see TetrisEngine::tick())
 	void tick();
 
-private:
-	// reset everything for a new game (use existing functions)
-	//  - set the score to 0 and call updateScoreDisplay()
-	//  - call determineSecondsPerTick() to determine the tick rate.
-	//  - clear the gameboard,
-	//  - pick & spawn next shape
-	//  - pick next shape again (for the "on-deck" shape)
-	void reset();
-
-	// assign nextShape.setShape a new random shape
-	void pickNextShape();
-
-	// copy the nextShape into the currentShape (through assignment)
-	//   position the currentShape to its spawn location.
-	//	 - return true/false based on isPositionLegal()
-	bool spawnNextShape();
-
-	// Test if a rotation is legal on the tetromino and if so, rotate it.
-	//  To do this:
-	//	 1) create a (local) temporary copy of the tetromino
-	//	 2) rotate it (shape.rotateClockwise())
-	//	 3) test if temp rotation was legal (isPositionLegal()),
-	//      if so - rotate the original tetromino.
-	//	 4) return true/false to indicate successful movement
-	bool attemptRotate(GridTetromino &shape);
-
-	// test if a move is legal on the tetromino, if so, move it.
-	//  To do this:
-	//	 1) create a (local) temporary copy of the tetromino
-	//	 2) move it (temp.move())
-	//	 3) test if temp move was legal (isPositionLegal(),
-	//      if so - move the original.
-	//	 4) return true/false to indicate successful movement
-	bool attemptMove(GridTetromino &shape, int x, int y);
-
-	// drops the tetromino vertically as far as it can
-	//   legally go.  Use attemptMove(). This can be done in 1 line.
-	void drop(GridTetromino &shape);
-
-	// copy the contents (color) of the tetromino's mapped block locs to the grid.
-	//	 1) get current blockshape locs via tetromino.getBlockLocsMappedToGrid()
-	//	 2) copy the content (color) to the grid (via gameboard.setContent())
-	void lock(const GridTetromino &shape);
+	// the gameplay state of this game
+	//   (the non-const one lets a match send the game garbage, see BattleRoyale)
+	const TetrisEngine& getEngine() const;
+	TetrisEngine& getEngine();
+
+	// how held buttons auto-repeat (see AutoRepeatSettings)
+	void setAutoRepeat(const AutoRepeatSettings &settings);
+
+	// play the game's sound effects on audio (nullptr: silent)
+	void setAudio(AudioSystem *audio);
+
+	// draw the locked blocks with the ShaderBoardRenderer (one quad) instead of
+	//   the cached board layer.
+	//   return false (and keep the board layer) if shaders aren't available
+	bool setShaderBoardRendering(bool enabled);
+
+	// the number of draw calls the last draw() made
+	int getLastDrawCalls() const;
+
+	// coach the player (see Coach): show where the falling shape should go as
+	//   a ghost, and grade each shape locked (and its finesse, see
+	//   FinesseTracker).  The search runs on the coach's own thread (started &
+	//   stopped here).
+	void setCoaching(bool enabled);
+	bool isCoaching() const;
 
+	// time travel (for debugging): pause the game, to step back & forth through
+	//   the frames in its history (each one restored into the engine as it's
+	//   shown).  Leaving it resumes the game from the frame shown, and forgets
+	//   the frames after it.  step() does nothing while it's on.
+	void setTimeTravel(bool enabled);
+	bool isTimeTravelling() const;
+
+	// show the frame frames on from the one shown (negative: back), as far as
+	//   the history goes
+	void travel(int frames);
+
+private:
 	// Graphics methods ==============================================
 
-	// Draw a tetris block sprite on the canvas
-	// The block position is specified in terms of 2 offsets:
-	//    1) the top left (of the gameboard in pixels)
-	//    2) an x & y offset into the gameboard - in blocks (not pixels)
-	//       meaning they need to be multiplied by BLOCK_WIDTH and BLOCK_HEIGHT
-	//       to get the pixel offset.
-	//	 1) set the block color using blockSprite.setTextureRect()
-	//   2) set the block location using blockSprite.setPosition()
-	//	 3) draw the block using window.draw()
-	//   For details/instructions on these 3 operations see:
-	//       www.sfml-dev.org/tutorials/2.5/graphics-sprite.php
-	//       use member variables: window and blockSprite (assigned in constructor)
-	void drawBlock(const Point &topLeft, int xOffset, int yOffset, TetColor color);
-
-	// Draw the gameboard blocks on the window
-	//   Iterate through each row & col, use drawBlock() to
-	//   draw a block if it isn't empty.
-	void drawGameboard();
-
-	// Draw a tetromino on the window
-	//	 Iterate through each mapped loc & drawBlock() for each.
-	//   The topLeft determines a 'base point' from which to calculate block offsets
-	//      If the Tetromino is on the gameboard: use gameboardOffset
-	void drawTetromino(const GridTetromino &tetromino, const Point &topLeft);
-
-	// update the score display
-	// form a string "score: ##" to display the current score
-	// user scoreText.setString() to display it.
-	void updateScoreDisplay();
-
-	// State & gameplay/logic methods ================================
-
-	// return true if shape is within borders (isShapeWithinBorders())
-	//	 and the shape's mapped board locs are empty.
-	//   Make use of Gameboard's areLocsEmpty() and pass it the shape's mapped locs.
-	bool isPositionLegal(const GridTetromino &shape) const;
-
-	// return true if the shape is within the left, right, and lower border of
-	//	 the grid, but *NOT* the top border. (return false otherwise)
-	//   * Ignore the upper border because we want shapes to be able to drop
-	//     in from the top of the gameboard.
-	//   All of a shape's blocks must be inside these 3 borders to return true
-	bool isShapeWithinBorders(const GridTetromino &shape) const;
-
-	// set secsPerTick
-	//   - basic: use MAX_SECS_PER_TICK
-	//   - advanced: base it on score (higher score results in lower secsPerTick)
-	void determineSecondsPerTick();
+	// Rebuild the board layer (if the board changed since it was last built)
+	//   The locked blocks only change when a shape locks or rows are removed,
+	//   which the board's change journal tells us about.  So they are drawn
+	//   into boardLayer once per change, rather than walked every frame.
+	//   The blocks are listed in boardList by the GameView.
+	void updateBoardLayer();
+
+	// Draw the board layer on the window
+	//   (draws boardList directly if the RenderTexture couldn't be created)
+	//   return the number of draw calls it took
+	int drawBoardLayer();
 
 	// MEMBER VARIABLES
 
 	// State members ---------------------------------------------
-	int score;									// the current game score.
-	Gameboard board;						// the gameboard (grid) to represent where all the blocks are.
-	GridTetromino nextShape;		// the tetromino shape that is "on deck".
-	GridTetromino currentShape; // the tetromino that is currently falling.
+	TetrisEngine engine;				// the gameplay rules (board, shapes, score & tick timing).
+
+	// Input members ---------------------------------------------
+	InputMask heldButtons = 0;			// buttons down (from the InputThread's events).
+	InputMask tappedButtons = 0;		// buttons pressed since the last step() (so a tap isn't missed).
+
+	// Sound members ---------------------------------------------
+	AudioSystem *audio = nullptr;		// plays the sound effects (nullptr: silent).
 
 	// Graphics members ------------------------------------------
 	const Point gameboardOffset; // pixel XY offset of the gameboard on the screen
-	const Point nextShapeOffset; // pixel XY offset to the nextShape
-	sf::Sprite &blockSprite;		 // the sprite used for all the blocks.
+	const GameView view;				 // what the game looks like (as draw lists).
+	sf::Sprite &blockSprite;		 // the sprite used for all the blocks (we draw with its texture).
 	sf::RenderWindow &window;		 // the window that we are drawing on.
 
-	sf::Font scoreFont; // SFML font for displaying the score.
-	sf::Text scoreText; // SFML text object for displaying the score
-
-	// Time members ----------------------------------------------
-	// Note: a "tick" is the amount of time it takes a block to fall one line.
-
-	const double MAX_SECONDS_PER_TICK = 0.75;			// start off with a slow (max) tick rate. (seconds per game tick)
-	const double MIN_SECONDS_PER_TICK = 0.20;			// this is the fastest tick pace (seconds per game tick).
-	double secondsPerTick = MAX_SECONDS_PER_TICK; // the number of seconds per tick (changes depending on score)
-
-	double secondsSinceLastTick = 0.0;				 // update this every game loop until it is >= secsPerTick,
-																						 // we then know to trigger a tick.  Reduce this var (by a tick) & repeat.
-	bool shapePlacedSinceLastGameLoop = false; // Tracks whether we have placed (locked) a shape on
-																						 // the gameboard in the current gameloop
+	std::shared_ptr<const sf::Font> scoreFont;	// SFML font for displaying the score (nullptr if missing).
+	SfmlDrawListRenderer renderer;			// draws draw lists with SFML.
+	DrawList drawList;									// this frame's falling & next blocks and score.
+	DrawList overlayList;								// the debug overlay (see drawOverlay()).
+	int lastDrawCalls = 0;							// the draw calls made by the last draw().
+
+	DrawList boardList;						 // the locked blocks (relative to the board layer's top left).
+	sf::RenderTexture boardLayer;	 // the locked blocks, drawn once per board change.
+	sf::Sprite boardLayerSprite;	 // boardLayer, placed at gameboardOffset.
+	bool boardLayerCreated;				 // false if the RenderTexture couldn't be created.
+	bool boardLayerDirty = true;	 // does the board layer need rebuilding?
+	bool boardChangesMissed = false; // did a step() clear board changes draw() hadn't seen?
+
+	ShaderBoardRenderer shaderBoard; // draws the locked blocks from a cell texture (created on first use).
+	bool useShaderBoard = false;		 // draw with shaderBoard instead of the board layer?
+
+	// Coaching members ------------------------------------------
+	Coach coach;										 // suggests placements & grades locks (on its own thread).
+	bool coaching = false;					 // is the coach watching?
+	CoachAdvice advice;							 // the coach's latest advice (found is false while there's none).
+	CoachGrade grade;								 // the coach's grade for the last shape locked.
+	bool graded = false;						 // has the coach graded a shape yet?
+	FinesseTracker finesse;					 // counts the player's presses for each shape.
+
+	// Debugging members -----------------------------------------
+	TickHistory history;						 // the last few seconds of steps.
+	bool timeTravelling = false;		 // paused, showing a frame from the history?
+	int travelAge = 0;							 // the frame shown (its age in the history: 0 is the newest).
+	std::vector<std::string> travelLines; // the time travel overlay's text.
 };
 
 #endif /* TETRISGAME_H */
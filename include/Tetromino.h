@@ -4,6 +4,7 @@
 #include <vector>
 #include <iostream>
 #include "point.h"
+#include "BlockLocs.h"
 
 enum TetColor {
     RED, // textRect BLOCK_WIDTH * 0, 0
@@ -30,11 +31,12 @@ class Tetromino
 {
     friend class TestSuite;
     
-    TetColor color;
-    TetShape shape;
+    TetColor color = RED; // (until setShape())
+    TetShape shape = S;   // (until setShape())
+    int rotation = 0; // clockwise quarter turns since setShape() (0-3)
 
     protected:
-        std::vector<Point> blockLocs;
+        BlockLocs blockLocs; // (held inline: copying a Tetromino never allocates)
     
     public:
         Tetromino();
@@ -48,6 +50,8 @@ class Tetromino
         void setShape(TetShape shape);
         
         void rotateClockwise();
+
+        int getRotation() const;
         
         void printToConsole() const;
 
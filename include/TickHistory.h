@@ -0,0 +1,58 @@
+// A TickHistory keeps the last few seconds of a game, one EngineSnapshot for
+// every step() (see TetrisEngine::saveSnapshot()), for a time-travel debugger:
+// pause the game, then restore any recent frame into the engine to see (and
+// step through) how it got there.
+//
+// The snapshots are kept in a ring buffer sized once, up front: recording
+// overwrites the oldest snapshot when it's full, and never allocates.  At a
+// couple of hundred bytes a snapshot, the default 10 seconds is ~110 KB and a
+// copy per frame, so the history can stay on in normal builds.
+//
+// The history lives beside the engine, not in it: engines are copied a lot
+// (rollback, searches, bots), and those copies stay small.
+//
+//  [expected .cpp size: ~ 75 lines]
+
+#ifndef TICKHISTORY_H
+#define TICKHISTORY_H
+
+#include <vector>
+#include "TetrisEngine.h"
+
+class TickHistory
+{
+public:
+	// STATIC CONSTANTS
+	static const int DEFAULT_CAPACITY = 10 * TetrisEngine::FRAMES_PER_SECOND;	// 10 seconds of steps
+
+	// MEMBER FUNCTIONS
+
+	// constructor
+	//   capacity: the most snapshots kept (at least 1)
+	explicit TickHistory(int capacity = DEFAULT_CAPACITY);
+
+	// save the engine's state as the newest snapshot (call it after each step())
+	//   the oldest is dropped when the history is full
+	void record(const TetrisEngine &engine);
+
+	// the snapshots kept, and the most there can be
+	int size() const;
+	int getCapacity() const;
+
+	// a snapshot by age: 0 is the newest, size() - 1 the oldest
+	const EngineSnapshot& get(int age) const;
+
+	// drop the newest count snapshots (eg: resuming from an older one)
+	void dropNewest(int count);
+
+	// drop them all
+	void clear();
+
+private:
+	// MEMBER VARIABLES
+	std::vector<EngineSnapshot> snapshots;	// the ring (sized once)
+	int newest = -1;												// the index of the newest snapshot
+	int count = 0;													// the snapshots kept
+};
+
+#endif /* TICKHISTORY_H */
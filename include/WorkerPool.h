@@ -0,0 +1,70 @@
+// A WorkerPool is a fixed set of threads that run a batch of independent tasks
+// (eg: stepping every game once) and then wait for the next batch.
+//
+// run(count, task) calls task(0) ... task(count - 1), spread over the workers
+// and the calling thread, and returns when they have all finished.  Tasks are
+// handed out one at a time from a shared counter, so a slow task doesn't hold
+// up a whole share of them.  The threads are started once and sleep between
+// batches, so a batch costs a wake up, not a thread start.
+//
+// Tasks must not touch each other's data (each game owns its state).  Only one
+// thread may call run() at a time.  Everything a task did happens before run()
+// returns.
+//
+//  [expected .cpp size: ~ 125 lines]
+
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkerPool
+{
+public:
+	// MEMBER FUNCTIONS
+
+	// constructor
+	//   start threadCount - 1 workers (the thread calling run() is the other one)
+	//   threadCount 0 means one per hardware thread; 1 runs every task on the caller
+	explicit WorkerPool(int threadCount = 0);
+
+	// destructor: stop & join the workers
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	// run task(0) ... task(count - 1) on the pool, returning when all have finished
+	void run(int count, const std::function<void(int)> &task);
+
+	// the threads that run tasks (the workers & the caller)
+	int getThreadCount() const;
+
+private:
+	// a worker thread: run each batch's tasks until the pool is destroyed
+	void work();
+
+	// claim & run the current batch's tasks until there are none left
+	void runTasks(const std::function<void(int)> &task, int count);
+
+	// MEMBER VARIABLES
+	std::vector<std::thread> workers;
+	std::mutex mutex;										// guards everything below but nextTask
+	std::condition_variable batchStarted;	// a batch (or stopping) for the workers
+	std::condition_variable batchDone;		// the last task finished, or a worker left the batch
+	const std::function<void(int)> *task = nullptr;		// the current batch
+	int taskCount = 0;
+	std::atomic<int> nextTask{ 0 };			// the next task to claim
+	int unfinishedTasks = 0;
+	int busyWorkers = 0;								// workers still in a batch
+	std::uint64_t batch = 0;						// batches started (a worker joins each once)
+	bool stopping = false;
+};
+
+#endif /* WORKERPOOL_H */
@@ -0,0 +1,201 @@
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include "AllocationCounter.h"
+
+namespace
+{
+  const char *const OTHER_SUBSYSTEM = "other";
+
+  // a subsystem's count (the name is claimed once, with a compare & swap, so
+  //   counting never takes a lock or allocates)
+  struct SubsystemCount
+  {
+    std::atomic<const char*> name{ nullptr };
+    std::atomic<std::uint64_t> count{ 0 };
+  };
+
+  std::atomic<bool> countingEnabled{ false };
+  std::atomic<std::uint64_t> totalCount{ 0 };
+  SubsystemCount subsystems[AllocationCounter::MAX_SUBSYSTEMS];
+
+  // the subsystem the calling thread is running (nullptr: "other")
+  thread_local const char *currentSubsystem = nullptr;
+
+  // the count for a subsystem, claiming a free one for a new name
+  //   (nullptr if they are all taken)
+  SubsystemCount* findSubsystem(const char *name)
+  {
+    for(SubsystemCount &subsystem : subsystems)
+    {
+      const char *claimed = subsystem.name.load(std::memory_order_acquire);
+      if(claimed == nullptr)
+      {
+        // try to claim it (another thread may get there first, maybe with this name)
+        if(subsystem.name.compare_exchange_strong(claimed, name, std::memory_order_acq_rel))
+        {
+          return &subsystem;
+        }
+      }
+      if(claimed == name || std::strcmp(claimed, name) == 0)
+      {
+        return &subsystem;
+      }
+    }
+    return nullptr;
+  }
+}
+
+// start/stop counting (the counts are kept)
+void AllocationCounter::setEnabled(bool enabled)
+{
+  countingEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool AllocationCounter::isEnabled()
+{
+  return countingEnabled.load(std::memory_order_relaxed);
+}
+
+// allocations counted since the last reset()
+std::uint64_t AllocationCounter::getCount()
+{
+  return totalCount.load(std::memory_order_relaxed);
+}
+
+// allocations counted against a subsystem since the last reset()
+std::uint64_t AllocationCounter::getCount(const char *subsystem)
+{
+  for(const SubsystemCount &counted : subsystems)
+  {
+    const char *name = counted.name.load(std::memory_order_acquire);
+    if(name != nullptr && std::strcmp(name, subsystem) == 0)
+    {
+      return counted.count.load(std::memory_order_relaxed);
+    }
+  }
+  return 0;
+}
+
+// the subsystems counted since the last reset(): up to maxSubsystems names
+//   & counts.  return how many were written
+int AllocationCounter::getSubsystemCounts(const char **names, std::uint64_t *counts, int maxSubsystems)
+{
+  int written = 0;
+  for(const SubsystemCount &counted : subsystems)
+  {
+    const char *name = counted.name.load(std::memory_order_acquire);
+    if(name != nullptr && written < maxSubsystems)
+    {
+      names[written] = name;
+      counts[written] = counted.count.load(std::memory_order_relaxed);
+      written++;
+    }
+  }
+  return written;
+}
+
+// zero every count (call it while no other thread is allocating)
+void AllocationCounter::reset()
+{
+  totalCount.store(0, std::memory_order_relaxed);
+  for(SubsystemCount &subsystem : subsystems)
+  {
+    subsystem.name.store(nullptr, std::memory_order_relaxed);
+    subsystem.count.store(0, std::memory_order_relaxed);
+  }
+}
+
+// count an allocation on the calling thread (called by operator new, when enabled)
+void AllocationCounter::recordAllocation()
+{
+  totalCount.fetch_add(1, std::memory_order_relaxed);
+  SubsystemCount *subsystem = findSubsystem(currentSubsystem != nullptr ? currentSubsystem : OTHER_SUBSYSTEM);
+  if(subsystem == nullptr)
+  {
+    subsystem = findSubsystem(OTHER_SUBSYSTEM);
+  }
+  if(subsystem != nullptr)
+  {
+    subsystem->count.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+AllocationScope::AllocationScope(const char *subsystem)
+:previous(currentSubsystem)
+{
+  currentSubsystem = subsystem;
+}
+
+AllocationScope::~AllocationScope()
+{
+  currentSubsystem = previous;
+}
+
+// the replaced global allocation functions: malloc() & free(), counted
+void* operator new(std::size_t size)
+{
+  if(countingEnabled.load(std::memory_order_relaxed))
+  {
+    AllocationCounter::recordAllocation();
+  }
+  void *memory = std::malloc(size != 0 ? size : 1);
+  if(memory == nullptr)
+  {
+    throw std::bad_alloc();
+  }
+  return memory;
+}
+
+void* operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+  try
+  {
+    return operator new(size);
+  }
+  catch(const std::bad_alloc&)
+  {
+    return nullptr;
+  }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+  return operator new(size, std::nothrow);
+}
+
+void operator delete(void *memory) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete[](void *memory) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete[](void *memory, std::size_t) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete(void *memory, const std::nothrow_t&) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete[](void *memory, const std::nothrow_t&) noexcept
+{
+  std::free(memory);
+}
@@ -0,0 +1,312 @@
+#include <cstring>
+#include <fstream>
+#include "AssetArchive.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+  // little endian fields (the archive is the same on every platform)
+  std::uint32_t readU32(const unsigned char *bytes)
+  {
+    return static_cast<std::uint32_t>(bytes[0]) | static_cast<std::uint32_t>(bytes[1]) << 8 |
+      static_cast<std::uint32_t>(bytes[2]) << 16 | static_cast<std::uint32_t>(bytes[3]) << 24;
+  }
+
+  std::uint64_t readU64(const unsigned char *bytes)
+  {
+    return readU32(bytes) | static_cast<std::uint64_t>(readU32(bytes + 4)) << 32;
+  }
+
+  void writeU32(std::vector<unsigned char> &bytes, std::uint32_t value)
+  {
+    for(int i = 0; i < 4; i++)
+    {
+      bytes.push_back(static_cast<unsigned char>(value >> (8 * i)));
+    }
+  }
+
+  void writeU64(std::vector<unsigned char> &bytes, std::uint64_t value)
+  {
+    writeU32(bytes, static_cast<std::uint32_t>(value));
+    writeU32(bytes, static_cast<std::uint32_t>(value >> 32));
+  }
+
+  // size rounded up to a multiple of DATA_ALIGNMENT
+  std::size_t aligned(std::size_t size)
+  {
+    const std::size_t alignment = AssetArchive::DATA_ALIGNMENT;
+    return (size + alignment - 1) / alignment * alignment;
+  }
+}
+
+const char AssetArchive::MAGIC[9] = "TETRPAK1";
+
+// destructor: close()
+AssetArchive::~AssetArchive()
+{
+  close();
+}
+
+// map the archive at path & read its index (closing any open one)
+//   return false if it is missing or malformed
+bool AssetArchive::open(const std::string &path)
+{
+  close();
+#ifdef _WIN32
+  file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if(file == INVALID_HANDLE_VALUE)
+  {
+    file = nullptr;
+    return false;
+  }
+  LARGE_INTEGER size;
+  if(!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+  {
+    close();
+    return false;
+  }
+  mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if(mapping == nullptr)
+  {
+    close();
+    return false;
+  }
+  mapped = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+  mappedSize = static_cast<std::size_t>(size.QuadPart);
+#else
+  int descriptor = ::open(path.c_str(), O_RDONLY);
+  if(descriptor < 0)
+  {
+    return false;
+  }
+  struct stat status;
+  if(fstat(descriptor, &status) != 0 || status.st_size == 0)
+  {
+    ::close(descriptor);
+    return false;
+  }
+  void *memory = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+  ::close(descriptor);	// (the mapping keeps the file)
+  if(memory == MAP_FAILED)
+  {
+    return false;
+  }
+  // we'll read all of it soon: start reading it in now, in big sequential reads
+  madvise(memory, static_cast<std::size_t>(status.st_size), MADV_WILLNEED);
+  mapped = static_cast<const unsigned char*>(memory);
+  mappedSize = static_cast<std::size_t>(status.st_size);
+#endif
+  if(mapped == nullptr || !readIndex())
+  {
+    close();
+    return false;
+  }
+  return true;
+}
+
+// read the index of an archive already in memory (eg: AssetArchiveWriter::
+//   toBytes(), or one embedded in the executable), closing any open one
+//   The bytes aren't copied: they must outlive the archive (or its close()).
+//   return false if it is malformed
+bool AssetArchive::openMemory(const void *data, std::size_t size)
+{
+  close();
+  if(data == nullptr || size == 0)
+  {
+    return false;
+  }
+  mapped = static_cast<const unsigned char*>(data);
+  mappedSize = size;
+  borrowed = true;
+  if(!readIndex())
+  {
+    close();
+    return false;
+  }
+  return true;
+}
+
+// unmap the archive (every view from find() becomes invalid)
+void AssetArchive::close()
+{
+  entries.clear();
+  if(borrowed)
+  {
+    // (not ours to unmap)
+    mapped = nullptr;
+    mappedSize = 0;
+    borrowed = false;
+    return;
+  }
+#ifdef _WIN32
+  if(mapped != nullptr)
+  {
+    UnmapViewOfFile(mapped);
+  }
+  if(mapping != nullptr)
+  {
+    CloseHandle(mapping);
+  }
+  if(file != nullptr)
+  {
+    CloseHandle(file);
+  }
+  mapping = nullptr;
+  file = nullptr;
+#else
+  if(mapped != nullptr)
+  {
+    munmap(const_cast<unsigned char*>(mapped), mappedSize);
+  }
+#endif
+  mapped = nullptr;
+  mappedSize = 0;
+}
+
+bool AssetArchive::isOpen() const
+{
+  return mapped != nullptr;
+}
+
+// the asset called name (eg: "assets/images/tiles.png")
+//   (data is nullptr if there is none)
+AssetView AssetArchive::find(const std::string &name) const
+{
+  std::map<std::string, AssetView>::const_iterator found = entries.find(name);
+  return found != entries.end() ? found->second : AssetView();
+}
+
+// the names of every asset in the archive
+std::vector<std::string> AssetArchive::getNames() const
+{
+  std::vector<std::string> names;
+  for(const std::pair<const std::string, AssetView> &entry : entries)
+  {
+    names.push_back(entry.first);
+  }
+  return names;
+}
+
+// the size of the mapped file, in bytes
+std::size_t AssetArchive::getSize() const
+{
+  return mappedSize;
+}
+
+// read the index of the mapped file into entries
+//   return false if it is malformed
+bool AssetArchive::readIndex()
+{
+  if(mappedSize < HEADER_SIZE || std::memcmp(mapped, MAGIC, 8) != 0)
+  {
+    return false;
+  }
+  std::uint32_t count = readU32(mapped + 8);
+  std::uint64_t indexSize = readU32(mapped + 12);
+  if(indexSize > mappedSize - HEADER_SIZE)
+  {
+    return false;
+  }
+
+  const unsigned char *entry = mapped + HEADER_SIZE;
+  const unsigned char *indexEnd = entry + indexSize;
+  for(std::uint32_t i = 0; i < count; i++)
+  {
+    if(static_cast<std::size_t>(indexEnd - entry) < ENTRY_SIZE)
+    {
+      return false;
+    }
+    std::uint32_t nameLength = readU32(entry);
+    AssetView view;
+    std::uint32_t format = readU32(entry + 4);
+    view.width = readU32(entry + 8);
+    view.height = readU32(entry + 12);
+    std::uint64_t offset = readU64(entry + 16);
+    std::uint64_t size = readU64(entry + 24);
+    entry += ENTRY_SIZE;
+
+    // everything must lie inside the file (written so nothing can overflow)
+    if(nameLength > static_cast<std::size_t>(indexEnd - entry) || offset > mappedSize || size > mappedSize - offset)
+    {
+      return false;
+    }
+    if(format == ASSET_RGBA && static_cast<std::uint64_t>(view.width) * view.height * 4 != size)
+    {
+      return false;
+    }
+    if(format != ASSET_FILE && format != ASSET_RGBA)
+    {
+      return false;
+    }
+    view.format = static_cast<AssetFormat>(format);
+    view.data = mapped + offset;
+    view.size = static_cast<std::size_t>(size);
+    entries[std::string(reinterpret_cast<const char*>(entry), nameLength)] = view;
+    entry += nameLength;
+  }
+  return true;
+}
+
+// add an asset (the bytes are copied)
+void AssetArchiveWriter::add(const std::string &name, const void *data, std::size_t size, AssetFormat format,
+  unsigned width, unsigned height)
+{
+  const unsigned char *bytes = static_cast<const unsigned char*>(data);
+  entries.push_back(Entry{ name, std::vector<unsigned char>(bytes, bytes + size), format, width, height });
+}
+
+// the archive's bytes
+std::vector<unsigned char> AssetArchiveWriter::toBytes() const
+{
+  std::size_t indexSize = 0;
+  for(const Entry &entry : entries)
+  {
+    indexSize += AssetArchive::ENTRY_SIZE + entry.name.size();
+  }
+
+  std::vector<unsigned char> bytes(AssetArchive::MAGIC, AssetArchive::MAGIC + 8);
+  writeU32(bytes, static_cast<std::uint32_t>(entries.size()));
+  writeU32(bytes, static_cast<std::uint32_t>(indexSize));
+
+  // the index (each entry's data follows the one before, aligned)
+  std::size_t offset = aligned(AssetArchive::HEADER_SIZE + indexSize);
+  for(const Entry &entry : entries)
+  {
+    writeU32(bytes, static_cast<std::uint32_t>(entry.name.size()));
+    writeU32(bytes, entry.format);
+    writeU32(bytes, entry.width);
+    writeU32(bytes, entry.height);
+    writeU64(bytes, offset);
+    writeU64(bytes, entry.data.size());
+    bytes.insert(bytes.end(), entry.name.begin(), entry.name.end());
+    offset = aligned(offset + entry.data.size());
+  }
+
+  // the data
+  for(const Entry &entry : entries)
+  {
+    bytes.resize(aligned(bytes.size()), 0);
+    bytes.insert(bytes.end(), entry.data.begin(), entry.data.end());
+  }
+  return bytes;
+}
+
+// write the archive to path
+//   return false if it couldn't be written
+bool AssetArchiveWriter::write(const std::string &path) const
+{
+  std::vector<unsigned char> bytes = toBytes();
+  std::ofstream out(path, std::ios::binary);
+  out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+  return static_cast<bool>(out);
+}
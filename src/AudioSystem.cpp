@@ -0,0 +1,213 @@
+#include "AudioSystem.h"
+
+namespace
+{
+  // the file of each SoundEffect (in the sfx directory)
+  const char *const EFFECT_FILES[SOUND_COUNT] = {
+    "blockDrop.ogg",
+    "blockRotate.ogg",
+    "levelUp.ogg",
+    "gameOver.ogg"
+  };
+  const char *const MUSIC_FILE = "tetrisMusic.ogg";
+}
+
+// destructor: stop()
+AudioSystem::~AudioSystem()
+{
+  stop();
+}
+
+// get every effect from resources & open the music, from the sfx directory
+//   (eg: "assets/sfx").  Call it before start().
+//   return false if anything failed to load (what did load still plays)
+bool AudioSystem::load(ResourceCache &resources, const std::string &directory)
+{
+  bool allLoaded = true;
+  for(int i = 0; i < SOUND_COUNT; i++)
+  {
+    buffers[i] = resources.getSoundBuffer(directory + "/" + EFFECT_FILES[i]);
+    allLoaded = allLoaded && buffers[i] != nullptr;
+  }
+
+  // (streamed from the archive's mapping, if it's packed)
+  std::string musicPath = directory + "/" + MUSIC_FILE;
+  AssetView packed = resources.findPacked(musicPath);
+  musicLoaded = packed.data != nullptr ? music.openFromMemory(packed.data, packed.size) : music.openFromFile(musicPath);
+  if(musicLoaded)
+  {
+    music.setLoop(true);
+  }
+  return allLoaded && musicLoaded;
+}
+
+// start/stop the audio thread (stop() stops every sound too)
+void AudioSystem::start()
+{
+  if(!running)
+  {
+    running = true;
+    thread = std::thread(&AudioSystem::run, this);
+  }
+}
+
+void AudioSystem::stop()
+{
+  running = false;
+  if(thread.joinable())
+  {
+    thread.join();
+  }
+  for(sf::Sound &voice : voices)
+  {
+    voice.stop();
+  }
+  music.stop();
+}
+
+// queue a command for the audio thread (game loop thread only, never blocks)
+//   return false (and drop it) if the queue is full
+bool AudioSystem::post(const AudioCommand &command)
+{
+  if(!queue.push(command))
+  {
+    droppedCommands++;
+    return false;
+  }
+  return true;
+}
+
+// queue commands (see post())
+void AudioSystem::playEffect(SoundEffect effect)
+{
+  AudioCommand command;
+  command.type = AudioCommand::PLAY_EFFECT;
+  command.effect = effect;
+  post(command);
+}
+
+void AudioSystem::playMusic()
+{
+  AudioCommand command;
+  command.type = AudioCommand::PLAY_MUSIC;
+  post(command);
+}
+
+void AudioSystem::pauseMusic()
+{
+  AudioCommand command;
+  command.type = AudioCommand::PAUSE_MUSIC;
+  post(command);
+}
+
+void AudioSystem::stopMusic()
+{
+  AudioCommand command;
+  command.type = AudioCommand::STOP_MUSIC;
+  post(command);
+}
+
+void AudioSystem::setEffectsVolume(float volume)
+{
+  AudioCommand command;
+  command.type = AudioCommand::SET_EFFECTS_VOLUME;
+  command.volume = volume;
+  post(command);
+}
+
+void AudioSystem::setMusicVolume(float volume)
+{
+  AudioCommand command;
+  command.type = AudioCommand::SET_MUSIC_VOLUME;
+  command.volume = volume;
+  post(command);
+}
+
+// play the effects for a set of GameEvents (eg: TetrisEngine::getEvents())
+void AudioSystem::playEventEffects(GameEventMask events)
+{
+  if(events & GAME_EVENT_ROTATED)
+  {
+    playEffect(SOUND_BLOCK_ROTATE);
+  }
+  if(events & GAME_EVENT_LOCKED)
+  {
+    playEffect(SOUND_BLOCK_DROP);
+  }
+  if(events & GAME_EVENT_ROWS_CLEARED)
+  {
+    playEffect(SOUND_LEVEL_UP);	// (there are no levels yet: clearing rows is the reward)
+  }
+  if(events & GAME_EVENT_GAME_OVER)
+  {
+    playEffect(SOUND_GAME_OVER);
+  }
+}
+
+// commands dropped because the queue was full
+std::uint64_t AudioSystem::getDroppedCommands() const
+{
+  return droppedCommands.load();
+}
+
+// carry out the posted commands until stop()
+void AudioSystem::run()
+{
+  while(running)
+  {
+    AudioCommand command;
+    while(queue.pop(command))
+    {
+      execute(command);
+    }
+    // a millisecond's wait is far below what anyone can hear
+    sf::sleep(sf::milliseconds(1));
+  }
+}
+
+// carry out one command (on the audio thread)
+void AudioSystem::execute(const AudioCommand &command)
+{
+  switch(command.type)
+  {
+    case AudioCommand::PLAY_EFFECT:
+      if(command.effect >= 0 && command.effect < SOUND_COUNT && buffers[command.effect] != nullptr)
+      {
+        int voice = chooseVoice();
+        voices[voice].stop();
+        voices[voice].setBuffer(*buffers[command.effect]);
+        voices[voice].play();
+        voiceStarted[voice] = ++effectsPlayed;
+      }
+      break;
+    case AudioCommand::PLAY_MUSIC: if(musicLoaded) music.play(); break;
+    case AudioCommand::PAUSE_MUSIC: music.pause(); break;
+    case AudioCommand::STOP_MUSIC: music.stop(); break;
+    case AudioCommand::SET_EFFECTS_VOLUME:
+      for(sf::Sound &voice : voices)
+      {
+        voice.setVolume(command.volume);
+      }
+      break;
+    case AudioCommand::SET_MUSIC_VOLUME: music.setVolume(command.volume); break;
+  }
+}
+
+// the voice to play the next effect on: an idle one, or the one that
+//   started longest ago
+int AudioSystem::chooseVoice() const
+{
+  int oldest = 0;
+  for(int i = 0; i < VOICE_COUNT; i++)
+  {
+    if(voices[i].getStatus() != sf::Sound::Playing)
+    {
+      return i;
+    }
+    if(voiceStarted[i] < voiceStarted[oldest])
+    {
+      oldest = i;
+    }
+  }
+  return oldest;
+}
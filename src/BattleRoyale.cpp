@@ -0,0 +1,242 @@
+#include <algorithm>
+#include "BattleRoyale.h"
+
+const int BattleRoyale::ATTACK_ROWS[5] = { 0, 0, 1, 2, 4 };
+
+// constructor
+//   human: the human's engine (stepped by the caller; nullptr: bots only)
+//   botCount bots, of mixed strength, seeded from seed
+//   pool steps the bots (it must outlive the match)
+BattleRoyale::BattleRoyale(TetrisEngine *human, int botCount, std::uint32_t seed, WorkerPool &pool)
+:pool(pool), firstBot(human != nullptr ? 1 : 0)
+{
+  // xorshift32 gets stuck on 0, so nudge a zero seed
+  rngState = (seed != 0) ? seed : 0x9E3779B9u;
+
+  botCount = std::max(0, botCount);
+  botEngines.reserve(botCount);
+  for(int i = 0; i < botCount; i++)
+  {
+    botEngines.push_back(TetrisEngine(nextRandom()));
+    // from a quick bot (a press every 3 frames) to a slow one (every 14)
+    bots.push_back(BotPlayer(3 + static_cast<int>(nextRandom() % 12)));
+  }
+
+  if(human != nullptr)
+  {
+    players.push_back(Player());
+    players.back().engine = human;
+  }
+  for(TetrisEngine &engine : botEngines)
+  {
+    players.push_back(Player());
+    players.back().engine = &engine;
+  }
+  aliveCount = getPlayerCount();
+}
+
+// step every bot still playing once, then settle knockouts & garbage
+//   (step the human's engine first)
+void BattleRoyale::step()
+{
+  if(isOver() || paused)
+  {
+    return;
+  }
+
+  pool.run(static_cast<int>(bots.size()), [this](int bot)
+  {
+    if(players[firstBot + bot].alive)
+    {
+      TetrisEngine &engine = botEngines[bot];
+      engine.step(bots[bot].nextButtons(engine));
+    }
+  });
+  frame++;
+
+  // knockouts first, so no one attacks a board that's already gone
+  for(int player = 0; player < getPlayerCount(); player++)
+  {
+    if(players[player].alive && (players[player].engine->getEvents() & GAME_EVENT_GAME_OVER))
+    {
+      knockOut(player);
+    }
+  }
+
+  for(int player = 0; player < getPlayerCount() && !isOver(); player++)
+  {
+    Player &attacker = players[player];
+    if(!attacker.alive)
+    {
+      continue;
+    }
+    updateTarget(player);
+    int rows = ATTACK_ROWS[std::min(4, attacker.engine->getClearedRows())];
+    if(rows > 0 && attacker.target >= 0)
+    {
+      Player &victim = players[attacker.target];
+      victim.engine->queueGarbage(rows, static_cast<int>(nextRandom() % Gameboard::MAX_X));
+      victim.lastAttacker = player;
+      victim.revengeOn = player;
+      garbageSent += rows;
+    }
+  }
+}
+
+// pause the whole match (step() does nothing until it's unpaused)
+void BattleRoyale::setPaused(bool pause)
+{
+  paused = pause;
+}
+
+bool BattleRoyale::isPaused() const
+{
+  return paused;
+}
+
+// players: the human (if there is one) is player HUMAN, then the bots
+int BattleRoyale::getPlayerCount() const
+{
+  return static_cast<int>(players.size());
+}
+
+bool BattleRoyale::hasHuman() const
+{
+  return firstBot == 1;
+}
+
+const TetrisEngine& BattleRoyale::getEngine(int player) const
+{
+  return *players[player].engine;
+}
+
+bool BattleRoyale::isAlive(int player) const
+{
+  return players[player].alive;
+}
+
+int BattleRoyale::getAliveCount() const
+{
+  return aliveCount;
+}
+
+// the place a player finished in (1 is the winner); 0 while it is playing
+int BattleRoyale::getPlacement(int player) const
+{
+  return players[player].placement;
+}
+
+// the player's target (-1 if there's no one left to attack)
+int BattleRoyale::getTarget(int player) const
+{
+  return players[player].target;
+}
+
+// the players this one knocked out
+int BattleRoyale::getKnockouts(int player) const
+{
+  return players[player].knockouts;
+}
+
+// the last player standing (-1 while the match is on)
+int BattleRoyale::getWinner() const
+{
+  for(int player = 0; player < getPlayerCount() && isOver(); player++)
+  {
+    if(players[player].placement == 1)
+    {
+      return player;
+    }
+  }
+  return -1;
+}
+
+bool BattleRoyale::isOver() const
+{
+  return aliveCount <= 1;
+}
+
+// the garbage rows sent by everyone so far
+std::uint64_t BattleRoyale::getGarbageSent() const
+{
+  return garbageSent;
+}
+
+// the frames stepped so far
+std::uint32_t BattleRoyale::getFrame() const
+{
+  return frame;
+}
+
+// knock a player out (it finishes in the place of the players left)
+void BattleRoyale::knockOut(int player)
+{
+  Player &loser = players[player];
+  loser.alive = false;
+  loser.placement = aliveCount;
+  loser.target = -1;
+  aliveCount--;
+  if(loser.lastAttacker >= 0)
+  {
+    players[loser.lastAttacker].knockouts++;
+  }
+
+  // the last one standing has won
+  if(isOver())
+  {
+    for(Player &survivor : players)
+    {
+      if(survivor.alive)
+      {
+        survivor.placement = 1;
+        survivor.target = -1;
+      }
+    }
+  }
+}
+
+// pick a player's target if it has none, or it's time for a new one
+void BattleRoyale::updateTarget(int player)
+{
+  Player &attacker = players[player];
+  int revenge = attacker.revengeOn;
+  attacker.revengeOn = -1;
+  if(revenge >= 0 && players[revenge].alive)
+  {
+    attacker.target = revenge;
+    attacker.framesOnTarget = 0;
+  }
+  else if(attacker.target < 0 || !players[attacker.target].alive || ++attacker.framesOnTarget >= RETARGET_FRAMES)
+  {
+    attacker.target = randomOpponent(player);
+    attacker.framesOnTarget = 0;
+  }
+}
+
+// a random player still playing, other than player (-1 if there is none)
+int BattleRoyale::randomOpponent(int player)
+{
+  if(aliveCount <= 1)
+  {
+    return -1;
+  }
+  // the nth of the others still playing
+  int n = static_cast<int>(nextRandom() % static_cast<std::uint32_t>(aliveCount - 1));
+  for(int other = 0; other < getPlayerCount(); other++)
+  {
+    if(other != player && players[other].alive && n-- == 0)
+    {
+      return other;
+    }
+  }
+  return -1;
+}
+
+// return the next value of the (xorshift32) generator
+std::uint32_t BattleRoyale::nextRandom()
+{
+  rngState ^= rngState << 13;
+  rngState ^= rngState >> 17;
+  rngState ^= rngState << 5;
+  return rngState;
+}
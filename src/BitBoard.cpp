@@ -0,0 +1,151 @@
+#include <assert.h>
+#include <cstring>
+#include "BitBoard.h"
+
+// constructor - empty() the grid
+BitBoard::BitBoard()
+{
+  empty();
+}
+
+// a copy of a Gameboard's cells
+BitBoard::BitBoard(const Gameboard &board)
+{
+  for(int y = 0; y < MAX_Y; y++)
+  {
+    rows[y] = board.getRowMask(y);
+    for(int x = 0; x < MAX_X; x++)
+    {
+      contents[y][x] = static_cast<std::int8_t>(board.getContent(x, y));
+    }
+  }
+}
+
+// return the content at an x,y grid loc (assert the point is valid)
+int BitBoard::getContent(int x, int y) const
+{
+  assert(x >= 0 && x < MAX_X && y >= 0 && y < MAX_Y && "Invalid x, y");
+
+  return contents[y][x];
+}
+
+// set the content at an x,y position (assert the point is valid)
+void BitBoard::setContent(int x, int y, int content)
+{
+  assert(x >= 0 && x < MAX_X && y >= 0 && y < MAX_Y && "Invalid point");
+  assert(content >= INT8_MIN && content <= INT8_MAX && "Content doesn't fit a byte");
+
+  contents[y][x] = static_cast<std::int8_t>(content);
+  std::uint16_t bit = static_cast<std::uint16_t>(1u << x);
+  rows[y] = static_cast<std::uint16_t>(content != EMPTY_BLOCK ? (rows[y] | bit) : (rows[y] & ~bit));
+}
+
+// return true if the content at ALL (valid) points is empty
+//   (points off the grid are disregarded, as in Gameboard)
+bool BitBoard::areLocsEmpty(const BlockLocs &locs) const
+{
+  for(const Point &p : locs)
+  {
+    // (unsigned compares: negative x & y are off the grid too)
+    if(static_cast<unsigned>(p.getX()) < MAX_X && static_cast<unsigned>(p.getY()) < MAX_Y
+      && (rows[p.getY()] >> p.getX() & 1))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// can a shape's blocks be here?  inside the left, right & bottom borders,
+//   on empty cells (the engine's rule: the top is open, so shapes can spawn
+//   above it)
+bool BitBoard::fits(const BlockLocs &locs) const
+{
+  for(const Point &p : locs)
+  {
+    if(static_cast<unsigned>(p.getX()) >= MAX_X || p.getY() >= MAX_Y)
+    {
+      return false;
+    }
+    if(p.getY() >= 0 && (rows[p.getY()] >> p.getX() & 1))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// removes all completed rows from the board
+//   (the kept rows are moved down once each, from the bottom up, to close
+//   the gaps: the same board Gameboard's row by row removal leaves)
+//   return the # of completed rows removed
+int BitBoard::removeCompletedRows()
+{
+  int to = MAX_Y - 1;
+  for(int from = MAX_Y - 1; from >= 0; from--)
+  {
+    if(rows[from] == FULL_ROW)
+    {
+      continue;
+    }
+    if(to != from)
+    {
+      rows[to] = rows[from];
+      std::memcpy(contents[to], contents[from], sizeof(contents[to]));
+    }
+    to--;
+  }
+
+  // the rows left at the top are new, empty ones
+  int removed = to + 1;
+  for(int y = 0; y < removed; y++)
+  {
+    rows[y] = 0;
+    std::memset(contents[y], EMPTY_BLOCK, sizeof(contents[y]));
+  }
+  return removed;
+}
+
+// fill the board with EMPTY_BLOCK
+void BitBoard::empty()
+{
+  std::memset(rows, 0, sizeof(rows));
+  std::memset(contents, EMPTY_BLOCK, sizeof(contents));
+}
+
+// push every row up count rows (the top count rows are lost) and fill the
+//   bottom count rows with content, except for a hole at holeX (garbage rows)
+//   return false if a lost row had blocks in it
+bool BitBoard::raiseRows(int count, int content, int holeX)
+{
+  if(count <= 0)
+  {
+    return true;
+  }
+  if(count > MAX_Y)
+  {
+    count = MAX_Y;
+  }
+
+  bool keptEverything = true;
+  for(int y = 0; y < count; y++)
+  {
+    keptEverything = keptEverything && rows[y] == 0;
+  }
+  std::memmove(rows, rows + count, (MAX_Y - count) * sizeof(rows[0]));
+  std::memmove(contents, contents + count, (MAX_Y - count) * sizeof(contents[0]));
+  for(int y = MAX_Y - count; y < MAX_Y; y++)
+  {
+    for(int x = 0; x < MAX_X; x++)
+    {
+      setContent(x, y, (x == holeX) ? EMPTY_BLOCK : content);
+    }
+  }
+  return keptEverything;
+}
+
+// the occupied cells of row y as bits (bit x is set if x,y isn't EMPTY_BLOCK)
+std::uint16_t BitBoard::getRowMask(int y) const
+{
+  return rows[y];
+}
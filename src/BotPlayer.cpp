@@ -0,0 +1,97 @@
+#include <algorithm>
+#include "BotPlayer.h"
+
+// constructor
+//   framesPerAction: frames from one button press to the next (at least 2:
+//   a press, then a release)
+BotPlayer::BotPlayer(int framesPerAction, const PlacementWeights &weights)
+:framesPerAction(std::max(2, framesPerAction)), weights(weights)
+{
+}
+
+// the buttons to hold for the engine's next step()
+InputMask BotPlayer::nextButtons(const TetrisEngine &engine)
+{
+  // a new shape (whether we dropped the last or it locked before we got it there)
+  const GridTetromino &shape = engine.getCurrentShape();
+  if(engine.getShapeCount() != lastShape)
+  {
+    planned = false;
+    awaitingShape = false;
+  }
+  lastShape = engine.getShapeCount();
+  if(awaitingShape)
+  {
+    return 0;
+  }
+
+  int x = shape.getGridLoc().getX();
+  if(!planned)
+  {
+    plan = PlacementSearch::findBest(engine.getBoard(), shape, weights);
+    planned = true;
+    targetRotation = (shape.getRotation() + plan.rotations) % 4;
+    // (the table's paths start from the spawn: a shape first seen anywhere
+    //   else is steered with taps)
+    Point spawn = engine.getBoard().getSpawnLoc();
+    bool atSpawn = shape.getRotation() == 0 && x == spawn.getX() && shape.getGridLoc().getY() == spawn.getY();
+    path = atSpawn ? FinesseTable::get().getPath(shape.getShape(), targetRotation, plan.x) : FinessePath();
+    nextMove = 0;
+    if(holding != 0)
+    {
+      // (let go of a shift still held for the last shape first)
+      holding = 0;
+      framesToAction = std::max(framesToAction, 1);
+    }
+  }
+
+  // hold a shift until the shape can go no further (the wall, or the stack)
+  if(holding != 0)
+  {
+    GridTetromino further = shape;
+    further.move(holding == BUTTON_LEFT ? -1 : 1, 0);
+    if(PlacementSearch::isLegal(engine.getBoard(), further))
+    {
+      return holding;
+    }
+    holding = 0;
+    framesToAction = framesPerAction - 1;
+    return 0;
+  }
+
+  // release between presses
+  if(framesToAction > 0)
+  {
+    framesToAction--;
+    return 0;
+  }
+  framesToAction = framesPerAction - 1;
+
+  if(plan.found && path.reachable && nextMove < path.count)
+  {
+    switch(path.moves[nextMove++])
+    {
+      case FINESSE_ROTATE: return BUTTON_ROTATE;
+      case FINESSE_LEFT: return BUTTON_LEFT;
+      case FINESSE_RIGHT: return BUTTON_RIGHT;
+      case FINESSE_DAS_LEFT: holding = BUTTON_LEFT; return holding;
+      case FINESSE_DAS_RIGHT: holding = BUTTON_RIGHT; return holding;
+    };
+  }
+  if(plan.found && shape.getRotation() != targetRotation)
+  {
+    return BUTTON_ROTATE;
+  }
+  if(plan.found && x != plan.x)
+  {
+    return x < plan.x ? BUTTON_RIGHT : BUTTON_LEFT;
+  }
+  awaitingShape = true;
+  return BUTTON_DROP;
+}
+
+// the placement being played (found is false while there's none)
+const Placement& BotPlayer::getPlan() const
+{
+  return plan;
+}
@@ -0,0 +1,311 @@
+#include <algorithm>
+#include <vector>
+#include "Coach.h"
+
+const double Coach::GOOD_SCORE_LOST = 1.0;
+const double Coach::FAIR_SCORE_LOST = 3.0;
+
+namespace
+{
+  // the board a snapshot holds (every block the same color: the search only
+  //   looks at which cells are filled)
+  Gameboard boardOf(const CoachSnapshot &snapshot)
+  {
+    Gameboard board;
+    for(int y = 0; y < Gameboard::MAX_Y; y++)
+    {
+      for(int x = 0; x < Gameboard::MAX_X; x++)
+      {
+        if(snapshot.rows[y] & (1u << x))
+        {
+          board.setContent(x, y, static_cast<int>(TetrisEngine::GARBAGE_COLOR));
+        }
+      }
+    }
+    return board;
+  }
+
+  // the score of landing shape where it is on board: the board it leaves,
+  //   with the next shape placed as well as it can be (one shape ahead)
+  double scoreLanded(const Gameboard &board, const GridTetromino &landed, GridTetromino next,
+    const PlacementWeights &weights)
+  {
+    Gameboard after = board;
+    int rowsCleared = PlacementSearch::place(after, landed);
+    double score = weights.rowsCleared * rowsCleared;
+    for(const Point &p : landed.getBlockLocsMappedToGrid())
+    {
+      if(p.getY() < 0)
+      {
+        score += weights.toppedOut;
+        break;
+      }
+    }
+
+    next.setGridLoc(after.getSpawnLoc());
+    Placement best = PlacementSearch::findBest(after, next, weights);
+    if(best.found)
+    {
+      return score + best.score;
+    }
+    // the next shape can't even spawn
+    return score + PlacementSearch::evaluate(after, 0, weights) + weights.toppedOut;
+  }
+
+  // every simple placement of the snapshot's falling shape (see PlacementSearch),
+  //   landed, with its score
+  void scoreAll(const Gameboard &board, const CoachSnapshot &snapshot, const PlacementWeights &weights,
+    std::vector<GridTetromino> &landed, std::vector<double> &scores)
+  {
+    std::vector<Placement> placements;
+    PlacementSearch::findAll(board, snapshot.current, placements, weights);
+    for(const Placement &placement : placements)
+    {
+      GridTetromino shape = snapshot.current;
+      PlacementSearch::reach(board, shape, placement.rotations, placement.x);
+      landed.push_back(shape);
+      scores.push_back(scoreLanded(board, shape, snapshot.next, weights));
+    }
+  }
+}
+
+// constructor
+//   weights: how placements are scored (see PlacementSearch)
+Coach::Coach(const PlacementWeights &weights)
+:weights(weights)
+{
+}
+
+// stops the thread
+Coach::~Coach()
+{
+  stop();
+}
+
+// start/stop the coach's thread (requests wait in the queue until it starts)
+//   start() forgets the game it watched before (and any results not polled)
+void Coach::start()
+{
+  if(!thread.joinable())
+  {
+    // (with the thread stopped, this thread is the only one using the queues)
+    GradeRequest oldRequest;
+    CoachAdvice oldAdvice;
+    CoachGrade oldGrade;
+    while(gradeRequests.pop(oldRequest)) { }
+    while(advice.pop(oldAdvice)) { }
+    while(grades.pop(oldGrade)) { }
+    advicePending = false;
+    haveSnapshot = false;
+
+    stopping = false;
+    thread = std::thread(&Coach::run, this);
+  }
+}
+
+void Coach::stop()
+{
+  if(thread.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> lock(slotMutex);
+      stopping = true;
+    }
+    wake.notify_one();
+    thread.join();
+  }
+}
+
+// look at the game after a step(): ask for a grade if a shape locked, and
+//   for advice if a new one spawned (game loop thread only, never waits on
+//   the search)
+void Coach::observe(const TetrisEngine &engine)
+{
+  // (grade before advising on the next shape: both can happen in one step)
+  if(haveSnapshot && (engine.getEvents() & GAME_EVENT_LOCKED) && gradedShape != snapshot.shapeNumber)
+  {
+    GradeRequest request;
+    request.snapshot = snapshot;
+    request.locked = engine.getLastLocked();
+    if(gradeRequests.push(request))
+    {
+      wakeUp();
+    }
+    else
+    {
+      droppedRequests++;
+    }
+    gradedShape = snapshot.shapeNumber;
+  }
+  if(!haveSnapshot || engine.getShapeCount() != snapshot.shapeNumber)
+  {
+    snapshot = takeSnapshot(engine);
+    haveSnapshot = true;
+    {
+      std::lock_guard<std::mutex> lock(slotMutex);
+      adviceRequest = snapshot;
+      advicePending = true;
+    }
+    wake.notify_one();
+  }
+}
+
+// take the newest advice / grade since the last poll (false if there's none)
+//   (game loop thread only, never blocks)
+bool Coach::pollAdvice(CoachAdvice &newest)
+{
+  bool found = false;
+  CoachAdvice next;
+  while(advice.pop(next))
+  {
+    // (advice for a shape that has locked since is no use)
+    if(haveSnapshot && next.shapeNumber == snapshot.shapeNumber)
+    {
+      newest = next;
+      found = true;
+    }
+  }
+  return found;
+}
+
+bool Coach::pollGrade(CoachGrade &newest)
+{
+  bool found = false;
+  while(grades.pop(newest))
+  {
+    found = true;
+  }
+  return found;
+}
+
+// grade requests dropped because the coach's queue was full
+std::uint64_t Coach::getDroppedRequests() const
+{
+  return droppedRequests;
+}
+
+// the snapshot of an engine's board & shapes
+CoachSnapshot Coach::takeSnapshot(const TetrisEngine &engine)
+{
+  CoachSnapshot snapshot;
+  snapshot.shapeNumber = engine.getShapeCount();
+  for(int y = 0; y < Gameboard::MAX_Y; y++)
+  {
+    snapshot.rows[y] = engine.getBoard().getRowMask(y);
+  }
+  snapshot.current = engine.getCurrentShape();
+  snapshot.next = engine.getNextShape();
+  return snapshot;
+}
+
+// the best placement for the snapshot's falling shape (on the caller)
+CoachAdvice Coach::advise(const CoachSnapshot &snapshot, const PlacementWeights &weights)
+{
+  Gameboard board = boardOf(snapshot);
+  std::vector<GridTetromino> landed;
+  std::vector<double> scores;
+  scoreAll(board, snapshot, weights, landed, scores);
+
+  CoachAdvice advice;
+  advice.shapeNumber = snapshot.shapeNumber;
+  for(std::size_t i = 0; i < scores.size(); i++)
+  {
+    if(!advice.found || scores[i] > advice.score)
+    {
+      advice.found = true;
+      advice.ghost = landed[i];
+      advice.score = scores[i];
+    }
+  }
+  return advice;
+}
+
+// grade the snapshot's falling shape locked at locked (on the caller)
+CoachGrade Coach::grade(const CoachSnapshot &snapshot, const GridTetromino &locked, const PlacementWeights &weights)
+{
+  Gameboard board = boardOf(snapshot);
+  std::vector<GridTetromino> landed;
+  std::vector<double> scores;
+  scoreAll(board, snapshot, weights, landed, scores);
+
+  // (the player may have found a placement the simple search can't reach, eg:
+  //   a shape slid under an overhang, so it counts as a candidate too)
+  const double EPSILON = 1e-9;
+  double lockedScore = scoreLanded(board, locked, snapshot.next, weights);
+  CoachGrade grade;
+  grade.shapeNumber = snapshot.shapeNumber;
+  grade.placements = static_cast<int>(scores.size());
+  double best = lockedScore;
+  for(double score : scores)
+  {
+    if(score > lockedScore + EPSILON)
+    {
+      grade.rank++;
+    }
+    best = std::max(best, score);
+  }
+  grade.scoreLost = best - lockedScore;
+  if(grade.scoreLost <= EPSILON)
+  {
+    grade.level = GRADE_BEST;
+  }
+  else if(grade.scoreLost <= GOOD_SCORE_LOST)
+  {
+    grade.level = GRADE_GOOD;
+  }
+  else if(grade.scoreLost <= FAIR_SCORE_LOST)
+  {
+    grade.level = GRADE_FAIR;
+  }
+  else
+  {
+    grade.level = GRADE_POOR;
+  }
+  return grade;
+}
+
+// wake the thread for a new request
+void Coach::wakeUp()
+{
+  // (the lock only orders the request with the thread's check before it sleeps)
+  {
+    std::lock_guard<std::mutex> lock(slotMutex);
+  }
+  wake.notify_one();
+}
+
+// the coach's thread: carry out requests until stop()
+void Coach::run()
+{
+  CoachSnapshot toAdvise;
+  while(true)
+  {
+    bool adviseNow = false;
+    {
+      std::unique_lock<std::mutex> lock(slotMutex);
+      wake.wait(lock, [this] { return stopping || advicePending || gradeRequests.front() != nullptr; });
+      if(stopping)
+      {
+        return;
+      }
+      if(advicePending)
+      {
+        toAdvise = adviceRequest;
+        advicePending = false;
+        adviseNow = true;
+      }
+    }
+
+    // advice first (the player is waiting on it), then one grade
+    if(adviseNow)
+    {
+      advice.push(advise(toAdvise, weights));
+    }
+    const GradeRequest *request = gradeRequests.front();
+    if(request != nullptr)
+    {
+      grades.push(grade(request->snapshot, request->locked, weights));
+      gradeRequests.popFront();
+    }
+  }
+}
@@ -0,0 +1,77 @@
+#include <cstring>
+#include "DrawList.h"
+
+// remove every quad & text run (keeps the storage)
+void DrawList::clear()
+{
+  quads.clear();
+  texts.clear();
+}
+
+// make room for this many quads & text runs, so filling the list up to
+//   that never allocates
+void DrawList::reserve(std::size_t quadCount, std::size_t textCount)
+{
+  quads.reserve(quadCount);
+  texts.reserve(textCount);
+}
+
+// add a quad textured from source (texture pixels), tinted by color
+//   (white: as the texture is)
+void DrawList::addTexturedQuad(DrawTextureId texture, const DrawRect &dest, const DrawRect &source,
+  DrawColor color)
+{
+  DrawQuad quad;
+  quad.dest = dest;
+  quad.texture = texture;
+  quad.source = source;
+  quad.color = color;
+  quads.push_back(quad);
+}
+
+// add a solid color quad
+void DrawList::addRect(const DrawRect &dest, DrawColor color)
+{
+  DrawQuad quad;
+  quad.dest = dest;
+  quad.color = color;
+  quads.push_back(quad);
+}
+
+// add a text run (text is copied, up to DrawText::MAX_LENGTH characters)
+void DrawList::addText(float x, float y, int characterSize, DrawColor color, const char *text)
+{
+  DrawText run;
+  run.x = x;
+  run.y = y;
+  run.characterSize = characterSize;
+  run.color = color;
+  std::strncpy(run.text, text, DrawText::MAX_LENGTH);
+  run.text[DrawText::MAX_LENGTH] = '\0';
+  texts.push_back(run);
+}
+
+const std::vector<DrawQuad>& DrawList::getQuads() const
+{
+  return quads;
+}
+
+const std::vector<DrawText>& DrawList::getTexts() const
+{
+  return texts;
+}
+
+// the number of draw calls a batching backend needs for this list:
+//   one per run of consecutive quads with the same texture, plus one per text run
+int DrawList::countBatches() const
+{
+  int batches = 0;
+  for(std::size_t i = 0; i < quads.size(); i++)
+  {
+    if(i == 0 || quads[i].texture != quads[i - 1].texture)
+    {
+      batches++;
+    }
+  }
+  return batches + static_cast<int>(texts.size());
+}
@@ -0,0 +1,233 @@
+#include <algorithm>
+#include "Finesse.h"
+#include "PlacementSearch.h"
+
+namespace
+{
+  // the cells a shape covers once dropped on an empty board, in a fixed order
+  //   (x, and rows up from the floor), to spot placements that cover the same cells
+  struct Footprint
+  {
+    int cells[BlockLocs::MAX_BLOCKS] = {};
+
+    bool operator==(const Footprint &other) const
+    {
+      return std::equal(cells, cells + BlockLocs::MAX_BLOCKS, other.cells);
+    }
+  };
+
+  Footprint footprintOf(const GridTetromino &shape)
+  {
+    BlockLocs locs = shape.getBlockLocsMappedToGrid();
+    int bottom = locs[0].getY();
+    for(const Point &p : locs)
+    {
+      bottom = std::max(bottom, p.getY());
+    }
+    Footprint footprint;
+    for(std::size_t i = 0; i < locs.size(); i++)
+    {
+      footprint.cells[i] = locs[i].getX() * Gameboard::MAX_Y + (bottom - locs[i].getY());
+    }
+    std::sort(footprint.cells, footprint.cells + locs.size());
+    return footprint;
+  }
+}
+
+// the table (worked out on the first call)
+const FinesseTable& FinesseTable::get()
+{
+  static const FinesseTable table;
+  return table;
+}
+
+// the shortest presses from spawn to a shape's rotation (0-3) & grid loc x
+//   (unreachable if there's no such placement)
+const FinessePath& FinesseTable::getPath(TetShape shape, int rotation, int x) const
+{
+  if(shape < 0 || shape >= TetShape::COUNT || rotation < 0 || rotation > 3 || x < MIN_X || x >= MIN_X + COLUMNS)
+  {
+    return unreachable;
+  }
+  return paths[shape][rotation][x - MIN_X];
+}
+
+// work the table out (see the top)
+FinesseTable::FinesseTable()
+{
+  for(int shape = 0; shape < TetShape::COUNT; shape++)
+  {
+    build(TetShape(shape));
+  }
+}
+
+// work out one shape's paths
+void FinesseTable::build(TetShape shape)
+{
+  const Gameboard board;
+  const Point spawn = board.getSpawnLoc();
+
+  // the shape in each rotation, at its spawn row & column x
+  GridTetromino rotated[4];
+  rotated[0].setShape(shape);
+  for(int rotation = 1; rotation < 4; rotation++)
+  {
+    rotated[rotation] = rotated[rotation - 1];
+    rotated[rotation].rotateClockwise();
+  }
+  auto placed = [&](int rotation, int x)
+  {
+    GridTetromino at = rotated[rotation];
+    at.setGridLoc(x, spawn.getY());
+    return at;
+  };
+  auto isLegal = [&](int rotation, int x)
+  {
+    return x >= MIN_X && x < MIN_X + COLUMNS && PlacementSearch::isLegal(board, placed(rotation, x));
+  };
+
+  // breadth first from the spawn: every state is first reached by a shortest path
+  FinessePath (&found)[4][COLUMNS] = paths[shape];
+  int queue[4 * COLUMNS];
+  int queued = 0;
+  int next = 0;
+  found[0][spawn.getX() - MIN_X].reachable = true;
+  queue[queued++] = spawn.getX() - MIN_X;
+  while(next < queued)
+  {
+    int rotation = queue[next] / COLUMNS;
+    int x = queue[next] % COLUMNS + MIN_X;
+    next++;
+    const FinessePath &path = found[rotation][x - MIN_X];
+    if(path.count == FinessePath::MAX_MOVES)
+    {
+      continue;
+    }
+
+    const FinesseMove MOVES[] = { FINESSE_ROTATE, FINESSE_LEFT, FINESSE_RIGHT, FINESSE_DAS_LEFT, FINESSE_DAS_RIGHT };
+    for(FinesseMove move : MOVES)
+    {
+      int toRotation = (move == FINESSE_ROTATE) ? (rotation + 1) % 4 : rotation;
+      int toX = x;
+      if(move == FINESSE_LEFT || move == FINESSE_RIGHT)
+      {
+        toX += (move == FINESSE_LEFT) ? -1 : 1;
+      }
+      else if(move == FINESSE_DAS_LEFT || move == FINESSE_DAS_RIGHT)
+      {
+        int step = (move == FINESSE_DAS_LEFT) ? -1 : 1;
+        while(isLegal(rotation, toX + step))
+        {
+          toX += step;
+        }
+      }
+      if((toRotation == rotation && toX == x) || !isLegal(toRotation, toX) || found[toRotation][toX - MIN_X].reachable)
+      {
+        continue;
+      }
+      FinessePath &to = found[toRotation][toX - MIN_X];
+      to = path;
+      to.moves[to.count++] = move;
+      queue[queued++] = toRotation * COLUMNS + (toX - MIN_X);
+    }
+  }
+
+  // placements covering the same cells share the shortest of their paths
+  for(int rotation = 0; rotation < 4; rotation++)
+  {
+    for(int x = MIN_X; x < MIN_X + COLUMNS; x++)
+    {
+      FinessePath &path = found[rotation][x - MIN_X];
+      if(!path.reachable)
+      {
+        continue;
+      }
+      Footprint footprint = footprintOf(placed(rotation, x));
+      for(int otherRotation = 0; otherRotation < 4; otherRotation++)
+      {
+        for(int otherX = MIN_X; otherX < MIN_X + COLUMNS; otherX++)
+        {
+          const FinessePath &other = found[otherRotation][otherX - MIN_X];
+          if(other.reachable && other.count < path.count && footprintOf(placed(otherRotation, otherX)) == footprint)
+          {
+            path = other;
+          }
+        }
+      }
+    }
+  }
+}
+
+// look at the game after a step() made with heldButtons held
+void FinesseTracker::observe(const TetrisEngine &engine, InputMask heldButtons)
+{
+  // the presses went to the shape that was falling before the step
+  InputMask pressed = heldButtons & ~previousButtons;
+  previousButtons = heldButtons;
+  if(tracking)
+  {
+    const InputMask COUNTED[] = { BUTTON_ROTATE, BUTTON_LEFT, BUTTON_RIGHT };
+    for(InputMask button : COUNTED)
+    {
+      if(pressed & button)
+      {
+        presses++;
+      }
+    }
+  }
+
+  // it locked: compare its presses with the table's
+  if(tracking && (engine.getEvents() & GAME_EVENT_LOCKED))
+  {
+    const GridTetromino &locked = engine.getLastLocked();
+    const FinessePath &path = FinesseTable::get().getPath(locked.getShape(), locked.getRotation(), locked.getGridLoc().getX());
+    if(path.reachable)
+    {
+      lastResult.shapeNumber = shapeNumber;
+      lastResult.shape = locked.getShape();
+      lastResult.presses = presses;
+      lastResult.minimum = path.count;
+      lastResult.errors = std::max(0, presses - path.count);
+      haveResult = true;
+      shapes++;
+      faults += (lastResult.errors > 0) ? 1 : 0;
+      errors += lastResult.errors;
+    }
+    tracking = false;
+  }
+
+  // a new shape to count presses for
+  if(engine.getShapeCount() != shapeNumber)
+  {
+    shapeNumber = engine.getShapeCount();
+    tracking = true;
+    presses = 0;
+  }
+}
+
+// the last shape locked (false before one has)
+bool FinesseTracker::hasResult() const
+{
+  return haveResult;
+}
+
+const FinesseResult& FinesseTracker::getLastResult() const
+{
+  return lastResult;
+}
+
+// totals since the tracker started
+int FinesseTracker::getShapes() const
+{
+  return shapes;
+}
+
+int FinesseTracker::getFaults() const
+{
+  return faults;
+}
+
+int FinesseTracker::getErrors() const
+{
+  return errors;
+}
@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <cmath>
+#include "FrameScheduler.h"
+
+// constructor
+//   stepSeconds: the fixed simulation step
+//   maxStepsPerFrame: the most steps a single frame may run
+FrameScheduler::FrameScheduler(double stepSeconds, int maxStepsPerFrame)
+:stepSeconds(stepSeconds), maxStepsPerFrame(maxStepsPerFrame)
+{
+}
+
+// start rendering a frame at time now (seconds, from any steady clock).
+//   return the number of fixed steps to simulate before drawing it
+int FrameScheduler::beginFrame(double now)
+{
+  if(!started)
+  {
+    started = true;
+    lastFrameTime = now;
+    return 0;
+  }
+
+  double frameSeconds = now - lastFrameTime;
+  lastFrameTime = now;
+
+  // frame time statistics (Welford's online mean & variance)
+  stats.frames++;
+  double deviation = frameSeconds - stats.meanFrameSeconds;
+  stats.meanFrameSeconds += deviation / stats.frames;
+  frameSecondsSquaredDeviation += deviation * (frameSeconds - stats.meanFrameSeconds);
+  stats.jitterSeconds = std::sqrt(frameSecondsSquaredDeviation / stats.frames);
+  stats.maxFrameSeconds = std::max(stats.maxFrameSeconds, frameSeconds);
+
+  accumulator += frameSeconds;
+  int steps = static_cast<int>(accumulator / stepSeconds);
+  if(steps > maxStepsPerFrame)
+  {
+    stats.droppedSteps += steps - maxStepsPerFrame;
+    steps = maxStepsPerFrame;
+    accumulator = 0;	// give up on the time we couldn't simulate
+  }
+  else
+  {
+    accumulator -= steps * stepSeconds;
+  }
+  stats.steps += steps;
+  return steps;
+}
+
+// how far between the last simulated step and the next this frame is (0 to 1)
+double FrameScheduler::getAlpha() const
+{
+  return std::min(1.0, accumulator / stepSeconds);
+}
+
+// the time (on the beginFrame() clock) the simulation has reached, once
+//   the steps beginFrame() returned have run.  Step i of those steps
+//   (0 based, of n) covers the stepSeconds up to
+//   getSimulatedTime() - (n - 1 - i) * stepSeconds
+double FrameScheduler::getSimulatedTime() const
+{
+  return lastFrameTime - accumulator;
+}
+
+double FrameScheduler::getStepSeconds() const
+{
+  return stepSeconds;
+}
+
+FrameStats FrameScheduler::getStats() const
+{
+  return stats;
+}
+
+void FrameScheduler::resetStats()
+{
+  stats = FrameStats();
+  frameSecondsSquaredDeviation = 0;
+}
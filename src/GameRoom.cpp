@@ -0,0 +1,136 @@
+#include <assert.h>
+#include "GameRoom.h"
+
+// constructor
+//   every player's engine uses the same seed (same piece sequence)
+GameRoom::GameRoom(std::uint32_t id, std::uint32_t seed)
+:id(id)
+{
+  for(int slot = 0; slot < PLAYER_COUNT; slot++)
+  {
+    engines[slot] = TetrisEngine(seed);
+    occupied[slot] = false;
+    heldButtons[slot] = 0;
+    lastInputFrame[slot] = -1;
+    for(int i = 0; i < INPUT_BUFFER_FRAMES; i++)
+    {
+      bufferedButtons[slot][i] = 0;
+      bufferedFrame[slot][i] = -1;
+    }
+  }
+}
+
+std::uint32_t GameRoom::getId() const
+{
+  return id;
+}
+
+// add a player to the room, return their slot (or -1 if the room is full)
+//   (the first free slot)
+int GameRoom::addPlayer()
+{
+  for(int slot = 0; slot < PLAYER_COUNT; slot++)
+  {
+    if(!occupied[slot])
+    {
+      occupied[slot] = true;
+      playerCount++;
+      return slot;
+    }
+  }
+  return -1;
+}
+
+// free a player's slot (its buffered inputs are dropped; its game goes on)
+void GameRoom::removePlayer(int slot)
+{
+  if(!hasPlayer(slot))
+  {
+    return;
+  }
+  occupied[slot] = false;
+  playerCount--;
+  heldButtons[slot] = 0;
+  lastInputFrame[slot] = -1;
+  for(int i = 0; i < INPUT_BUFFER_FRAMES; i++)
+  {
+    bufferedFrame[slot][i] = -1;
+  }
+}
+
+bool GameRoom::hasPlayer(int slot) const
+{
+  return slot >= 0 && slot < PLAYER_COUNT && occupied[slot];
+}
+
+int GameRoom::getPlayerCount() const
+{
+  return playerCount;
+}
+
+// validate a player's held buttons for a frame, and queue them if legal
+GameRoom::InputResult GameRoom::submitInput(int slot, std::uint32_t inputFrame, InputMask heldButtons)
+{
+  if(!hasPlayer(slot))
+  {
+    return INPUT_INVALID_SLOT;
+  }
+  if(heldButtons & ~TetrisEngine::ALL_BUTTONS)
+  {
+    return INPUT_INVALID_BUTTONS;
+  }
+  if(static_cast<std::int64_t>(inputFrame) <= lastInputFrame[slot])
+  {
+    return INPUT_DUPLICATE;
+  }
+  if(inputFrame >= frame + INPUT_BUFFER_FRAMES)
+  {
+    return INPUT_TOO_EARLY;
+  }
+  if(inputFrame + MAX_INPUT_LAG_FRAMES < frame)
+  {
+    return INPUT_STALE;
+  }
+
+  lastInputFrame[slot] = inputFrame;
+  if(inputFrame <= frame)
+  {
+    // on time for the next step (or a little late): apply it next step
+    this->heldButtons[slot] = heldButtons;
+  }
+  else
+  {
+    int index = inputFrame % INPUT_BUFFER_FRAMES;
+    bufferedButtons[slot][index] = heldButtons;
+    bufferedFrame[slot][index] = inputFrame;
+  }
+  return INPUT_ACCEPTED;
+}
+
+// advance every engine in the room by one frame
+void GameRoom::step()
+{
+  int index = frame % INPUT_BUFFER_FRAMES;
+  for(int slot = 0; slot < PLAYER_COUNT; slot++)
+  {
+    if(bufferedFrame[slot][index] == frame)
+    {
+      heldButtons[slot] = bufferedButtons[slot][index];
+      bufferedFrame[slot][index] = -1;
+    }
+    engines[slot].step(heldButtons[slot]);
+  }
+  frame++;
+}
+
+// the frame the room will simulate next
+std::uint32_t GameRoom::getFrame() const
+{
+  return frame;
+}
+
+const TetrisEngine& GameRoom::getEngine(int slot) const
+{
+  assert(slot >= 0 && slot < PLAYER_COUNT && "Invalid slot");
+  return engines[slot];
+}
@@ -0,0 +1,443 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <map>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <SFML/Network.hpp>
+#include "GameRoom.h"
+#include "GameServer.h"
+#include "ServerProtocol.h"
+
+// One worker thread: a socket, a selector and a shard of the rooms.
+// Only the worker's own thread touches its rooms; the stats are atomics so
+// GameServer::getStats() can read them from any thread.
+class ServerWorker
+{
+public:
+  ServerWorker(int index, int workerCount, unsigned short port)
+  :index(index), workerCount(workerCount), port(port)
+  {
+  }
+
+  // bind the socket (on the calling thread, so start() can report failure)
+  bool bind()
+  {
+    if(socket.bind(port) != sf::Socket::Done)
+    {
+      return false;
+    }
+    socket.setBlocking(false);
+    selector.add(socket);
+    return true;
+  }
+
+  void start()
+  {
+    running = true;
+    thread = std::thread(&ServerWorker::run, this);
+  }
+
+  void stop()
+  {
+    running = false;
+    if(thread.joinable())
+    {
+      thread.join();
+    }
+    socket.unbind();
+  }
+
+  // add this worker's totals into stats
+  void addStats(ServerStats &stats) const
+  {
+    stats.rooms += roomCount.load();
+    stats.players += playerCount.load();
+    stats.roomFramesStepped += roomFramesStepped.load();
+    stats.inputsAccepted += inputsAccepted.load();
+    stats.inputsRejected += inputsRejected.load();
+    stats.packetsSent += packetsSent.load();
+    stats.busySeconds += busyMicroseconds.load() / 1e6;
+    stats.elapsedSeconds = std::max(stats.elapsedSeconds, elapsedMicroseconds.load() / 1e6);
+  }
+
+private:
+  typedef std::tuple<sf::Uint32, unsigned short, sf::Uint32> JoinKey;	// (ip, port, nonce)
+
+  // a player who joined through this worker
+  struct Player
+  {
+    std::size_t roomIndex;
+    int slot;
+    sf::IpAddress address;
+    unsigned short port;
+    JoinKey joinKey;								// (forgotten with the player)
+    std::uint64_t lastHeardFrame;		// the worker frame of its last packet
+  };
+
+  // the worker loop: wait for packets until the next frame is due, then step every room
+  void run()
+  {
+    const sf::Time frameTime = sf::seconds(static_cast<float>(TetrisEngine::SECONDS_PER_FRAME));
+    sf::Clock clock;
+    sf::Time nextFrame = frameTime;
+
+    while(running)
+    {
+      sf::Time now = clock.getElapsedTime();
+      if(now < nextFrame)
+      {
+        if(selector.wait(nextFrame - now))
+        {
+          sf::Time busyStart = clock.getElapsedTime();
+          receiveAll();
+          busyMicroseconds += (clock.getElapsedTime() - busyStart).asMicroseconds();
+        }
+        continue;
+      }
+
+      // step every room in one batch (a few times if we fell behind)
+      sf::Time busyStart = clock.getElapsedTime();
+      int framesStepped = 0;
+      while(clock.getElapsedTime() >= nextFrame && framesStepped < GameServer::MAX_CATCH_UP_FRAMES)
+      {
+        stepRooms();
+        nextFrame += frameTime;
+        framesStepped++;
+      }
+      if(clock.getElapsedTime() >= nextFrame)
+      {
+        nextFrame = clock.getElapsedTime() + frameTime;	// too far behind: skip frames
+      }
+      busyMicroseconds += (clock.getElapsedTime() - busyStart).asMicroseconds();
+      elapsedMicroseconds = clock.getElapsedTime().asMicroseconds();
+    }
+  }
+
+  // drain every datagram waiting on the socket
+  void receiveAll()
+  {
+    sf::Packet packet;
+    sf::IpAddress sender;
+    unsigned short senderPort;
+    while(socket.receive(packet, sender, senderPort) == sf::Socket::Done)
+    {
+      sf::Uint8 type;
+      if(packet >> type)
+      {
+        if(type == MSG_JOIN)
+        {
+          handleJoin(packet, sender, senderPort);
+        }
+        else if(type == MSG_INPUT)
+        {
+          handleInput(packet, sender, senderPort);
+        }
+      }
+    }
+  }
+
+  // MSG_JOIN roomId nonce: join (or create) a room
+  void handleJoin(sf::Packet &packet, const sf::IpAddress &sender, unsigned short senderPort)
+  {
+    sf::Uint32 roomId, nonce;
+    if(!(packet >> roomId >> nonce))
+    {
+      return;
+    }
+    if(static_cast<int>(roomId % workerCount) != index)
+    {
+      reject(REJECT_WRONG_SHARD, sender, senderPort);
+      return;
+    }
+
+    // a re-sent join (the reply was lost): answer it again
+    JoinKey joinKey = std::make_tuple(sender.toInteger(), senderPort, nonce);
+    auto previous = joins.find(joinKey);
+    if(previous != joins.end())
+    {
+      players[previous->second].lastHeardFrame = workerFrame;
+      sendJoined(previous->second, sender, senderPort, nonce);
+      return;
+    }
+
+    auto found = roomIndices.find(roomId);
+    std::size_t roomIndex;
+    if(found == roomIndices.end())
+    {
+      if(rooms.size() >= static_cast<std::size_t>(GameServer::MAX_ROOMS_PER_WORKER))
+      {
+        reject(REJECT_SERVER_FULL, sender, senderPort);
+        return;
+      }
+      roomIndex = rooms.size();
+      rooms.emplace_back(roomId, roomId * 2654435761u + 1);
+      roomTokens.emplace_back();
+      roomIndices[roomId] = roomIndex;
+      roomCount++;
+    }
+    else
+    {
+      roomIndex = found->second;
+    }
+
+    int slot = rooms[roomIndex].addPlayer();
+    if(slot < 0)
+    {
+      reject(REJECT_ROOM_FULL, sender, senderPort);
+      return;
+    }
+
+    sf::Uint32 token = (++tokenCounter * 2654435761u) ^ tokenSalt;
+    players[token] = Player{ roomIndex, slot, sender, senderPort, joinKey, workerFrame };
+    roomTokens[roomIndex][slot] = token;
+    joins[joinKey] = token;
+    playerCount++;
+    sendJoined(token, sender, senderPort, nonce);
+  }
+
+  // MSG_INPUT token frame buttons: validate against the room's simulation
+  void handleInput(sf::Packet &packet, const sf::IpAddress &sender, unsigned short senderPort)
+  {
+    sf::Uint32 token, inputFrame;
+    sf::Uint8 buttons;
+    if(!(packet >> token >> inputFrame >> buttons))
+    {
+      return;
+    }
+
+    auto found = players.find(token);
+    if(found == players.end() || found->second.address != sender || found->second.port != senderPort)
+    {
+      inputsRejected++;
+      reject(REJECT_UNKNOWN_PLAYER, sender, senderPort);
+      return;
+    }
+
+    Player &player = found->second;
+    player.lastHeardFrame = workerFrame;
+    if(rooms[player.roomIndex].submitInput(player.slot, inputFrame, buttons) == GameRoom::INPUT_ACCEPTED)
+    {
+      inputsAccepted++;
+    }
+    else
+    {
+      inputsRejected++;
+    }
+  }
+
+  // step every occupied room once, and broadcast state every STATE_INTERVAL_FRAMES
+  //   (and drop the players who timed out, now and then)
+  void stepRooms()
+  {
+    workerFrame++;
+    if(workerFrame % GameServer::EXPIRE_INTERVAL_FRAMES == 0)
+    {
+      expirePlayers();
+    }
+
+    for(std::size_t i = 0; i < rooms.size(); i++)
+    {
+      GameRoom &room = rooms[i];
+      if(room.getPlayerCount() == 0)
+      {
+        continue;
+      }
+      room.step();
+      roomFramesStepped++;
+
+      if(room.getFrame() % GameServer::STATE_INTERVAL_FRAMES == 0)
+      {
+        sendState(i);
+      }
+    }
+  }
+
+  // MSG_STATE: the authoritative state of every player in a room, to every player in it
+  void sendState(std::size_t roomIndex)
+  {
+    const GameRoom &room = rooms[roomIndex];
+    sf::Packet packet;
+    packet << sf::Uint8(MSG_STATE) << sf::Uint32(room.getId()) << sf::Uint32(room.getFrame());
+    for(int slot = 0; slot < GameRoom::PLAYER_COUNT; slot++)
+    {
+      const TetrisEngine &engine = room.getEngine(slot);
+      Point loc = engine.getCurrentShape().getGridLoc();
+      packet << sf::Int32(engine.getScore()) << sf::Uint8(engine.getCurrentShape().getShape())
+             << sf::Int8(loc.getX()) << sf::Int8(loc.getY());
+    }
+
+    for(int slot = 0; slot < GameRoom::PLAYER_COUNT; slot++)
+    {
+      if(!room.hasPlayer(slot))
+      {
+        continue;
+      }
+      const Player &player = players[roomTokens[roomIndex][slot]];
+      socket.send(packet, player.address, player.port);
+      packetsSent++;
+    }
+  }
+
+  // drop every player that hasn't sent a packet for PLAYER_TIMEOUT_FRAMES
+  void expirePlayers()
+  {
+    for(auto player = players.begin(); player != players.end();)
+    {
+      if(workerFrame - player->second.lastHeardFrame < static_cast<std::uint64_t>(GameServer::PLAYER_TIMEOUT_FRAMES))
+      {
+        ++player;
+        continue;
+      }
+      std::size_t roomIndex = player->second.roomIndex;
+      rooms[roomIndex].removePlayer(player->second.slot);
+      roomTokens[roomIndex][player->second.slot] = 0;
+      joins.erase(player->second.joinKey);
+      player = players.erase(player);
+      playerCount--;
+      if(rooms[roomIndex].getPlayerCount() == 0)
+      {
+        removeRoom(roomIndex);
+      }
+    }
+  }
+
+  // free an empty room: the last room moves into its place (so rooms stays
+  //   dense), and the indices that pointed at the last room follow it
+  void removeRoom(std::size_t roomIndex)
+  {
+    roomIndices.erase(rooms[roomIndex].getId());
+    std::size_t last = rooms.size() - 1;
+    if(roomIndex != last)
+    {
+      rooms[roomIndex] = rooms[last];
+      roomTokens[roomIndex] = roomTokens[last];
+      roomIndices[rooms[roomIndex].getId()] = roomIndex;
+      for(int slot = 0; slot < GameRoom::PLAYER_COUNT; slot++)
+      {
+        if(rooms[roomIndex].hasPlayer(slot))
+        {
+          players[roomTokens[roomIndex][slot]].roomIndex = roomIndex;
+        }
+      }
+    }
+    rooms.pop_back();
+    roomTokens.pop_back();
+    roomCount--;
+  }
+
+  void sendJoined(sf::Uint32 token, const sf::IpAddress &address, unsigned short toPort, sf::Uint32 nonce)
+  {
+    const Player &player = players[token];
+    sf::Packet packet;
+    packet << sf::Uint8(MSG_JOINED) << sf::Uint32(rooms[player.roomIndex].getId()) << token
+           << sf::Uint8(player.slot) << nonce;
+    socket.send(packet, address, toPort);
+    packetsSent++;
+  }
+
+  void reject(RejectReason reason, const sf::IpAddress &address, unsigned short toPort)
+  {
+    sf::Packet packet;
+    packet << sf::Uint8(MSG_REJECT) << sf::Uint8(reason);
+    socket.send(packet, address, toPort);
+    packetsSent++;
+  }
+
+  // MEMBER VARIABLES
+  int index;
+  int workerCount;
+  unsigned short port;
+  sf::UdpSocket socket;
+  sf::SocketSelector selector;
+  std::thread thread;
+  std::atomic<bool> running{ false };
+
+  std::vector<GameRoom> rooms;																		// this worker's shard (stepped in order)
+  std::vector<std::array<sf::Uint32, GameRoom::PLAYER_COUNT>> roomTokens;	// player tokens per room
+  std::unordered_map<sf::Uint32, std::size_t> roomIndices;				// roomId -> index into rooms
+  std::unordered_map<sf::Uint32, Player> players;									// token -> player
+  std::map<JoinKey, sf::Uint32> joins;														// (ip, port, nonce) -> token
+  std::uint64_t workerFrame = 0;																	// frames stepped (the players' clock)
+  sf::Uint32 tokenCounter = 0;
+  sf::Uint32 tokenSalt = static_cast<sf::Uint32>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+
+  std::atomic<std::uint64_t> roomCount{ 0 };
+  std::atomic<std::uint64_t> playerCount{ 0 };
+  std::atomic<std::uint64_t> roomFramesStepped{ 0 };
+  std::atomic<std::uint64_t> inputsAccepted{ 0 };
+  std::atomic<std::uint64_t> inputsRejected{ 0 };
+  std::atomic<std::uint64_t> packetsSent{ 0 };
+  std::atomic<std::int64_t> busyMicroseconds{ 0 };
+  std::atomic<std::int64_t> elapsedMicroseconds{ 0 };
+};
+
+// constructor
+//   workerCount 0 means one worker per hardware thread
+GameServer::GameServer(unsigned short basePort, int workerCount)
+:basePort(basePort)
+{
+  if(workerCount <= 0)
+  {
+    workerCount = std::max(1u, std::thread::hardware_concurrency());
+  }
+  for(int i = 0; i < workerCount; i++)
+  {
+    workers.push_back(std::unique_ptr<ServerWorker>(
+      new ServerWorker(i, workerCount, static_cast<unsigned short>(basePort + i))));
+  }
+}
+
+GameServer::~GameServer()
+{
+  stop();
+}
+
+// bind every worker's socket and start the worker threads.
+//   return false if a port could not be bound.
+bool GameServer::start()
+{
+  for(auto &worker : workers)
+  {
+    if(!worker->bind())
+    {
+      return false;
+    }
+  }
+  for(auto &worker : workers)
+  {
+    worker->start();
+  }
+  return true;
+}
+
+// stop & join every worker thread
+void GameServer::stop()
+{
+  for(auto &worker : workers)
+  {
+    worker->stop();
+  }
+}
+
+int GameServer::getWorkerCount() const
+{
+  return static_cast<int>(workers.size());
+}
+
+unsigned short GameServer::getBasePort() const
+{
+  return basePort;
+}
+
+// a snapshot of the totals across every worker (safe to call while running)
+ServerStats GameServer::getStats() const
+{
+  ServerStats stats;
+  for(const auto &worker : workers)
+  {
+    worker->addStats(stats);
+  }
+  return stats;
+}
@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include "GameView.h"
+
+// constructor
+//   the pixel offsets of the top left of the gameboard, the next shape and the score
+GameView::GameView(Point gameboardOffset, Point nextShapeOffset, Point scoreOffset)
+:gameboardOffset(gameboardOffset), nextShapeOffset(nextShapeOffset), scoreOffset(scoreOffset)
+{
+}
+
+// add the whole game: the board, the falling & next shapes and the score
+void GameView::addGame(DrawList &list, const TetrisEngine &engine) const
+{
+  addBoard(list, engine.getBoard(), gameboardOffset);
+  addPieces(list, engine);
+}
+
+// add everything but the board's locked blocks
+//   (for backends that draw the board some other way, eg: a cached layer)
+//   fallOffset: how far (in blocks) below its grid location to draw the falling shape
+void GameView::addPieces(DrawList &list, const TetrisEngine &engine, double fallOffset) const
+{
+  Point fallingOffset(gameboardOffset.getX(), gameboardOffset.getY() + static_cast<int>(std::lround(fallOffset * BLOCK_HEIGHT)));
+  addTetromino(list, engine.getCurrentShape(), fallingOffset);
+  addTetromino(list, engine.getNextShape(), nextShapeOffset);
+
+  char scoreString[DrawText::MAX_LENGTH + 1];
+  std::snprintf(scoreString, sizeof(scoreString), "Score: %d", engine.getScore());
+  DrawColor white;
+  list.addText(static_cast<float>(scoreOffset.getX()), static_cast<float>(scoreOffset.getY()),
+               SCORE_CHARACTER_SIZE, white, scoreString);
+}
+
+// the fallOffset that makes the falling shape glide down between ticks
+//   (instead of jumping a row per tick), secondsAhead after the engine's
+//   last simulated frame.  0 if the shape can't fall any further.
+double GameView::getFallOffset(const TetrisEngine &engine, double secondsAhead)
+{
+  return engine.canCurrentShapeFall() ? engine.getTickProgress(secondsAhead) : 0.0;
+}
+
+// add the board's locked blocks, with the board's top left at topLeft
+void GameView::addBoard(DrawList &list, const Gameboard &board, const Point &topLeft) const
+{
+  for(int y = 0; y < Gameboard::MAX_Y; y++)
+  {
+    for(int x = 0; x < Gameboard::MAX_X; x++)
+    {
+      if(board.getContent(x, y) != Gameboard::EMPTY_BLOCK)
+      {
+        addBlock(list, topLeft, x, y, TetColor(board.getContent(x, y)));
+      }
+    }
+  }
+}
+
+// add a tetromino's blocks, with the grid's top left at topLeft
+void GameView::addTetromino(DrawList &list, const GridTetromino &tetromino, const Point &topLeft) const
+{
+  BlockLocs points = tetromino.getBlockLocsMappedToGrid();
+  for(Point p : points)
+  {
+    addBlock(list, topLeft, p.getX(), p.getY(), tetromino.getColor());
+  }
+}
+
+// add a ghost of a shape on the board: its blocks, translucent
+//   (eg: where the coach suggests it goes)
+void GameView::addGhost(DrawList &list, const GridTetromino &ghost) const
+{
+  DrawColor tint;
+  tint.a = GHOST_ALPHA;
+  for(const Point &p : ghost.getBlockLocsMappedToGrid())
+  {
+    if(p.getY() >= 0)
+    {
+      addBlock(list, gameboardOffset, p.getX(), p.getY(), ghost.getColor(), tint);
+    }
+  }
+}
+
+// add the coach's grade for the last shape locked, under the score
+void GameView::addCoachGrade(DrawList &list, const CoachGrade &grade) const
+{
+  // a word & a color for each grade (green to red)
+  static const char *const LEVEL_NAMES[] = { "Best move!", "Good", "Fair", "Poor" };
+  static const DrawColor LEVEL_COLORS[] = { { 90, 230, 90, 255 }, { 200, 230, 90, 255 }, { 240, 180, 60, 255 }, { 240, 80, 70, 255 } };
+
+  char gradeString[DrawText::MAX_LENGTH + 1];
+  if(grade.level == GRADE_BEST)
+  {
+    std::snprintf(gradeString, sizeof(gradeString), "%s", LEVEL_NAMES[grade.level]);
+  }
+  else
+  {
+    std::snprintf(gradeString, sizeof(gradeString), "%s: #%d of %d", LEVEL_NAMES[grade.level], grade.rank,
+                  std::max(grade.rank, grade.placements));
+  }
+  list.addText(static_cast<float>(scoreOffset.getX()), static_cast<float>(scoreOffset.getY() + SCORE_CHARACTER_SIZE + 8),
+               GRADE_CHARACTER_SIZE, LEVEL_COLORS[grade.level], gradeString);
+}
+
+// add the finesse of the last shape locked & the totals, under the grade
+void GameView::addFinesse(DrawList &list, const FinesseTracker &finesse) const
+{
+  if(!finesse.hasResult())
+  {
+    return;
+  }
+  const FinesseResult &last = finesse.getLastResult();
+  char finesseString[DrawText::MAX_LENGTH + 1];
+  std::snprintf(finesseString, sizeof(finesseString), "Finesse: %d/%d keys, %d faults in %d", last.presses, last.minimum,
+                finesse.getFaults(), finesse.getShapes());
+  DrawColor color;
+  if(last.errors > 0)
+  {
+    color = DrawColor{ 240, 80, 70, 255 };
+  }
+  list.addText(static_cast<float>(scoreOffset.getX()), static_cast<float>(scoreOffset.getY() + SCORE_CHARACTER_SIZE + GRADE_CHARACTER_SIZE + 16),
+               GRADE_CHARACTER_SIZE, color, finesseString);
+}
+
+// add a block: the tile for color, at block xOffset,yOffset from topLeft (in pixels)
+//   tinted by tint (white: as the tile is)
+void GameView::addBlock(DrawList &list, const Point &topLeft, int xOffset, int yOffset, TetColor color,
+  DrawColor tint)
+{
+  DrawRect dest;
+  dest.left = static_cast<float>(xOffset * BLOCK_WIDTH + topLeft.getX());
+  dest.top = static_cast<float>(yOffset * BLOCK_HEIGHT + topLeft.getY());
+  dest.width = BLOCK_WIDTH;
+  dest.height = BLOCK_HEIGHT;
+
+  DrawRect source;
+  source.left = static_cast<float>(BLOCK_WIDTH * static_cast<int>(color));
+  source.width = BLOCK_WIDTH;
+  source.height = BLOCK_HEIGHT;
+
+  list.addTexturedQuad(TEXTURE_TILES, dest, source, tint);
+}
+
+// add a MinimapAtlas (every minimap, one quad), scaled up to fill dest
+void GameView::addMinimaps(DrawList &list, const DrawRect &dest, const MinimapAtlas &atlas)
+{
+  DrawRect source;
+  source.width = static_cast<float>(atlas.getWidth());
+  source.height = static_cast<float>(atlas.getHeight());
+  list.addTexturedQuad(TEXTURE_MINIMAPS, dest, source);
+}
+
+// add a debug overlay: lines of text on a dark panel, with the panel's top left at topLeft
+//   (lines longer than DrawText::MAX_LENGTH are cut)
+void GameView::addOverlay(DrawList &list, const Point &topLeft, const std::vector<std::string> &lines)
+{
+  const float margin = 4;
+  const float lineHeight = OVERLAY_CHARACTER_SIZE + 4;
+  DrawRect panel;
+  panel.left = static_cast<float>(topLeft.getX());
+  panel.top = static_cast<float>(topLeft.getY());
+  panel.width = DrawText::MAX_LENGTH * OVERLAY_CHARACTER_SIZE * 0.6f + 2 * margin;
+  panel.height = lines.size() * lineHeight + 2 * margin;
+  DrawColor shade;
+  shade.r = shade.g = shade.b = 0;
+  shade.a = 180;
+  list.addRect(panel, shade);
+
+  DrawColor white;
+  for(size_t i = 0; i < lines.size(); i++)
+  {
+    list.addText(panel.left + margin, panel.top + margin + i * lineHeight, OVERLAY_CHARACTER_SIZE, white, lines[i].c_str());
+  }
+}
+
+Point GameView::getGameboardOffset() const
+{
+  return gameboardOffset;
+}
@@ -2,6 +2,7 @@
 #include <iostream>
 #include <assert.h>
 #include "Gameboard.h"
+#include "Profiler.h"
 
 Gameboard::Gameboard()
 {
@@ -21,33 +22,34 @@ int Gameboard::getContent(int x, int y) const
   return grid[y][x];
 }
 
-Point Gameboard::getSpawnLoc()
+// return the gameboard offset to spawn a new tetromino at
+Point Gameboard::getSpawnLoc() const
 {
-  return Point{MAX_X / 2, 0};
+  return spawnLoc;
 }
 
 // set the content at a given point (only if the point is valid)
 void Gameboard::setContent(const Point &pt, int content)
 {
-  assert(isValidPoint(pt) && "Invalid point");
-
-  grid[pt.getY()][pt.getX()] = content;
+  setContent(pt.getX(), pt.getY(), content);
 }
 // set the content at an x,y position (only if the point is valid)
 void Gameboard::setContent(int x, int y, int content)
 {
   assert(isValidPoint(x, y) && "Invalid point");
 
-  grid[y][x] = content;
+  if (grid[y][x] != content)
+  {
+    grid[y][x] = content;
+    recordChange(BoardChange::CELL_SET, x, y, content);
+  }
 }
 // set the content for a set of points (only if the points are valid)
 void Gameboard::setContent(const std::vector<Point> &locs, int content)
 {
   for (Point pt : locs)
   {
-    assert(isValidPoint(pt) && "Invalid point");
-
-    grid[pt.getY()][pt.getX()] = content;
+    setContent(pt.getX(), pt.getY(), content);
   }
 }
 
@@ -59,7 +61,23 @@ void Gameboard::setContent(const std::vector<Point> &locs, int content)
 //   Testing invalid points would likely result in an out of bounds
 //     error or segmentation fault!
 //   If none of the points are valid, return true
-bool Gameboard::areLocsEmpty(std::vector<Point> locs) const
+bool Gameboard::areLocsEmpty(const std::vector<Point> &locs) const
+{
+  for (Point pt : locs)
+  {
+    if (isValidPoint(pt))
+    {
+      if (getContent(pt) != EMPTY_BLOCK)
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// (the same, for a tetromino's mapped locs)
+bool Gameboard::areLocsEmpty(const BlockLocs &locs) const
 {
   for (Point pt : locs)
   {
@@ -75,14 +93,24 @@ bool Gameboard::areLocsEmpty(std::vector<Point> locs) const
 }
 
 // removes all completed rows from the board
-//   use getCompletedRowIndices() and removeRows()
+//   (top to bottom, like removeRows(getCompletedRowIndices()), but without
+//   building the vector: this runs every time a shape locks)
 //   return the # of completed rows removed
 int Gameboard::removeCompletedRows()
 {
-  std::vector<int> completeRows = getCompletedRowIndices();
-  removeRows(completeRows);
+  PROFILE_SCOPE("removeCompletedRows");
+  // removing row y only moves the rows above it (already checked) down
+  int removed = 0;
+  for (int y = 0; y < MAX_Y; y++)
+  {
+    if (isRowCompleted(y))
+    {
+      removeRow(y);
+      removed++;
+    }
+  }
 
-  return completeRows.size();
+  return removed;
 }
 
 // fill the board with EMPTY_BLOCK
@@ -93,6 +121,98 @@ void Gameboard::empty()
   {
     fillRow(y, EMPTY_BLOCK);
   }
+
+  // nothing recorded before this matters any more
+  changeCount = 0;
+  changesOverflowed = false;
+  recordChange(BoardChange::BOARD_EMPTIED, 0, 0, EMPTY_BLOCK);
+}
+
+// push every row up count rows (the top count rows are lost) and fill the
+//   bottom count rows with content, except for a hole at holeX (garbage rows)
+//   The journal can't describe the shift, so it is marked as overflowed.
+//   return false if a lost row had blocks in it
+bool Gameboard::raiseRows(int count, int content, int holeX)
+{
+  if (count <= 0)
+  {
+    return true;
+  }
+  if (count > MAX_Y)
+  {
+    count = MAX_Y;
+  }
+
+  bool keptEverything = true;
+  for (int y = 0; y < count; y++)
+  {
+    keptEverything = keptEverything && getRowMask(y) == 0;
+  }
+  for (int y = 0; y + count < MAX_Y; y++)
+  {
+    copyRowIntoRow(y + count, y);
+  }
+  for (int y = MAX_Y - count; y < MAX_Y; y++)
+  {
+    fillRow(y, content);
+    if (isValidPoint(holeX, y))
+    {
+      grid[y][holeX] = EMPTY_BLOCK;
+    }
+  }
+
+  invalidateChanges();
+  return keptEverything;
+}
+
+// the occupied cells of row y as bits (bit x is set if x,y isn't EMPTY_BLOCK)
+//   (for minimaps & bots, which only need to know what's filled)
+std::uint16_t Gameboard::getRowMask(int y) const
+{
+  std::uint16_t mask = 0;
+  for (int x = 0; x < MAX_X; x++)
+  {
+    if (grid[y][x] != EMPTY_BLOCK)
+    {
+      mask |= static_cast<std::uint16_t>(1u << x);
+    }
+  }
+  return mask;
+}
+
+// the number of changes recorded since the last clearChanges()
+int Gameboard::getChangeCount() const
+{
+  return changeCount;
+}
+
+// a recorded change (0 is the oldest)
+const BoardChange &Gameboard::getChange(int index) const
+{
+  assert(index >= 0 && index < changeCount && "Invalid change index");
+
+  return changes[index];
+}
+
+// true if the journal overflowed (or was invalidated) - changes were lost,
+//   so consumers must rescan the whole board.
+bool Gameboard::haveChangesOverflowed() const
+{
+  return changesOverflowed;
+}
+
+// forget every recorded change
+void Gameboard::clearChanges()
+{
+  changeCount = 0;
+  changesOverflowed = false;
+}
+
+// forget every recorded change and mark the journal as overflowed
+void Gameboard::invalidateChanges()
+{
+  changeCount = 0;
+  changesOverflowed = true;
 }
 
 // print the grid contents to the console (for debugging purposes)
@@ -158,6 +278,8 @@ void Gameboard::removeRow(int rowIndex)
     copyRowIntoRow(y - 1, y);
   }
   fillRow(0, EMPTY_BLOCK);
+
+  recordChange(BoardChange::ROW_REMOVED, 0, rowIndex, EMPTY_BLOCK);
 }
 
 // given a vector of row indices, remove them
@@ -217,4 +339,19 @@ bool Gameboard::isValidPoint(int x, int y) const
   }
 
   return true;
-}
\ No newline at end of file
+}
+
+// append a change to the journal (or flag an overflow if it is full)
+void Gameboard::recordChange(BoardChange::Type type, int x, int y, int content)
+{
+  if (changesOverflowed)
+  {
+    return;
+  }
+  if (changeCount == MAX_CHANGES)
+  {
+    changesOverflowed = true;
+    return;
+  }
+  changes[changeCount++] = BoardChange{ type, static_cast<std::int8_t>(x), static_cast<std::int8_t>(y), static_cast<std::int8_t>(content) };
+}
@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <SFML/System/Sleep.hpp>
+#include <SFML/Window/Keyboard.hpp>
+#include "InputThread.h"
+
+namespace
+{
+  // the keys the game is played with
+  struct KeyBinding
+  {
+    sf::Keyboard::Key key;
+    InputButton button;
+  };
+
+  const KeyBinding BINDINGS[] = {
+    { sf::Keyboard::R, BUTTON_ROTATE },
+    { sf::Keyboard::Left, BUTTON_LEFT },
+    { sf::Keyboard::Right, BUTTON_RIGHT },
+    { sf::Keyboard::Down, BUTTON_DOWN },
+    { sf::Keyboard::Space, BUTTON_DROP }
+  };
+  const int BINDING_COUNT = sizeof(BINDINGS) / sizeof(BINDINGS[0]);
+}
+
+// constructor
+//   clock: the event timestamps are clock.getElapsedTime() (it must outlive the thread)
+InputThread::InputThread(const sf::Clock &clock)
+:clock(clock)
+{
+}
+
+// destructor: stop()
+InputThread::~InputThread()
+{
+  stop();
+}
+
+void InputThread::start()
+{
+  if(!running)
+  {
+    running = true;
+    thread = std::thread(&InputThread::run, this);
+  }
+}
+
+void InputThread::stop()
+{
+  running = false;
+  if(thread.joinable())
+  {
+    thread.join();
+  }
+}
+
+// should the keyboard be read? (only while the game window has focus)
+void InputThread::setFocused(bool isFocused)
+{
+  focused = isFocused;
+}
+
+// the events, oldest first (only the main thread may pop them)
+InputThread::Queue& InputThread::getQueue()
+{
+  return queue;
+}
+
+// events dropped because the queue was full
+std::uint64_t InputThread::getDroppedEvents() const
+{
+  return droppedEvents.load();
+}
+
+// sample the keyboard until stop()
+void InputThread::run()
+{
+  bool held[BINDING_COUNT] = {};
+  const double pollInterval = 1.0 / POLL_HZ;
+  double nextPoll = now();
+
+  while(running)
+  {
+    double time = now();
+    bool readKeys = focused;
+    for(int i = 0; i < BINDING_COUNT; i++)
+    {
+      bool down = readKeys && sf::Keyboard::isKeyPressed(BINDINGS[i].key);
+      if(down != held[i])
+      {
+        held[i] = down;
+        pushEvent(time, BINDINGS[i].button, down);
+      }
+    }
+
+    // sf::sleep() asks Windows for 1ms timer resolution (std::this_thread's sleeps don't)
+    nextPoll = std::max(nextPoll + pollInterval, time);
+    sf::sleep(sf::seconds(static_cast<float>(nextPoll - now())));
+  }
+}
+
+// the time on the clock, in seconds
+double InputThread::now() const
+{
+  return clock.getElapsedTime().asMicroseconds() / 1e6;
+}
+
+void InputThread::pushEvent(double time, InputButton button, bool pressed)
+{
+  InputEvent event;
+  event.time = time;
+  event.button = button;
+  event.pressed = pressed;
+  if(!queue.push(event))
+  {
+    droppedEvents++;
+  }
+}
@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include "LatencyHistogram.h"
+
+// count one duration (negative durations count as 0)
+void LatencyHistogram::record(double seconds)
+{
+  seconds = std::max(0.0, seconds);
+  int bucket = static_cast<int>(seconds / BUCKET_SECONDS);
+  if(bucket < BUCKET_COUNT)
+  {
+    buckets[bucket]++;
+  }
+  else
+  {
+    overflow++;
+  }
+  count++;
+  totalSeconds += seconds;
+  maxSeconds = std::max(maxSeconds, seconds);
+}
+
+// forget everything recorded
+void LatencyHistogram::reset()
+{
+  *this = LatencyHistogram();
+}
+
+std::uint64_t LatencyHistogram::getCount() const
+{
+  return count;
+}
+
+double LatencyHistogram::getMaxSeconds() const
+{
+  return maxSeconds;
+}
+
+double LatencyHistogram::getMeanSeconds() const
+{
+  return (count > 0) ? totalSeconds / count : 0;
+}
+
+// the duration that fraction (0 to 1) of the recorded durations are at or
+//   below (the top of its bucket, or the max if it is in the overflow bucket)
+//   return 0 if nothing has been recorded
+double LatencyHistogram::getPercentileSeconds(double fraction) const
+{
+  if(count == 0)
+  {
+    return 0;
+  }
+
+  // the rank (1 based) of the duration we want
+  std::uint64_t rank = static_cast<std::uint64_t>(std::ceil(std::min(1.0, std::max(0.0, fraction)) * count));
+  rank = std::max<std::uint64_t>(rank, 1);
+
+  std::uint64_t seen = 0;
+  for(int i = 0; i < BUCKET_COUNT; i++)
+  {
+    seen += buckets[i];
+    if(seen >= rank)
+    {
+      // the top of the bucket, but never more than the longest duration seen
+      return std::min((i + 1) * BUCKET_SECONDS, maxSeconds);
+    }
+  }
+  return maxSeconds;
+}
+
+// one line: "name: p50 12.25ms p99 20.50ms max 23.10ms (120 samples)"
+std::string LatencyHistogram::getSummary(const std::string &name) const
+{
+  char line[128];
+  std::snprintf(line, sizeof(line), "%s: p50 %.2fms p99 %.2fms max %.2fms (%llu samples)", name.c_str(),
+    getPercentileSeconds(0.50) * 1000, getPercentileSeconds(0.99) * 1000, maxSeconds * 1000,
+    static_cast<unsigned long long>(count));
+  return line;
+}
+
+// the summary, then "<bucket top in ms> <count>" for each non-empty bucket
+void LatencyHistogram::writeReport(std::ostream &out, const std::string &name) const
+{
+  out << getSummary(name) << "\n";
+  for(int i = 0; i < BUCKET_COUNT; i++)
+  {
+    if(buckets[i] > 0)
+    {
+      out << (i + 1) * BUCKET_SECONDS * 1000 << " " << buckets[i] << "\n";
+    }
+  }
+  if(overflow > 0)
+  {
+    out << "over " << MAX_SECONDS * 1000 << " " << overflow << "\n";
+  }
+}
+
+// a press captured at capturedTime was applied to the game at appliedTime
+void LatencyTracker::onApplied(double capturedTime, double appliedTime)
+{
+  inputToApply.record(appliedTime - capturedTime);
+  if(pendingCount < MAX_PENDING)
+  {
+    pending[pendingCount].capturedTime = capturedTime;
+    pending[pendingCount].appliedTime = appliedTime;
+    pendingCount++;
+  }
+}
+
+// a frame was presented at presentedTime: every press applied before it is shown
+void LatencyTracker::onPresented(double presentedTime)
+{
+  for(int i = 0; i < pendingCount; i++)
+  {
+    applyToPresent.record(presentedTime - pending[i].appliedTime);
+    inputToPresent.record(presentedTime - pending[i].capturedTime);
+  }
+  pendingCount = 0;
+}
+
+// forget everything recorded (pending presses are kept)
+void LatencyTracker::reset()
+{
+  inputToApply.reset();
+  applyToPresent.reset();
+  inputToPresent.reset();
+}
+
+const LatencyHistogram& LatencyTracker::getInputToApply() const
+{
+  return inputToApply;
+}
+
+const LatencyHistogram& LatencyTracker::getApplyToPresent() const
+{
+  return applyToPresent;
+}
+
+const LatencyHistogram& LatencyTracker::getInputToPresent() const
+{
+  return inputToPresent;
+}
+
+// each stage's histogram report (see LatencyHistogram::writeReport())
+void LatencyTracker::writeReport(std::ostream &out) const
+{
+  inputToApply.writeReport(out, "input to apply");
+  applyToPresent.writeReport(out, "apply to present");
+  inputToPresent.writeReport(out, "input to present");
+}
@@ -0,0 +1,64 @@
+#include "LoopbackChannel.h"
+
+// constructor
+//   latency & jitter in seconds, lossRate in [0,1]
+LoopbackChannel::LoopbackChannel(double latency, double jitter, double lossRate, std::uint32_t seed)
+:latency(latency), jitter(jitter), lossRate(lossRate), rngState(seed != 0 ? seed : 1)
+{
+}
+
+// send a packet at time 'now' (it may be dropped)
+void LoopbackChannel::send(const std::vector<std::uint8_t> &packet, double now)
+{
+  sentCount++;
+  if(nextUniform() < lossRate)
+  {
+    droppedCount++;
+    return;
+  }
+
+  double arrivalTime = now + latency + (nextUniform() * 2.0 - 1.0) * jitter;
+  inFlight.push_back(InFlight{ arrivalTime, packet });
+}
+
+// receive the earliest packet that has arrived by time 'now'
+//   return false if no packet has arrived yet.
+bool LoopbackChannel::receive(std::vector<std::uint8_t> &packet, double now)
+{
+  int earliest = -1;
+  for(int i = 0; i < static_cast<int>(inFlight.size()); i++)
+  {
+    if(inFlight[i].arrivalTime <= now &&
+       (earliest < 0 || inFlight[i].arrivalTime < inFlight[earliest].arrivalTime))
+    {
+      earliest = i;
+    }
+  }
+  if(earliest < 0)
+  {
+    return false;
+  }
+
+  packet.swap(inFlight[earliest].data);
+  inFlight.erase(inFlight.begin() + earliest);
+  return true;
+}
+
+int LoopbackChannel::getSentCount() const
+{
+  return sentCount;
+}
+
+int LoopbackChannel::getDroppedCount() const
+{
+  return droppedCount;
+}
+
+// return a uniform random number in [0,1)
+double LoopbackChannel::nextUniform()
+{
+  rngState ^= rngState << 13;
+  rngState ^= rngState >> 17;
+  rngState ^= rngState << 5;
+  return (rngState >> 8) / 16777216.0;
+}
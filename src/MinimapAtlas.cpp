@@ -0,0 +1,75 @@
+#include <algorithm>
+#include "MinimapAtlas.h"
+
+namespace
+{
+  struct Rgba
+  {
+    std::uint8_t r, g, b, a;
+  };
+
+  const Rgba EMPTY_COLOR = { 24, 24, 32, 255 };
+  // the blocks' color for each MinimapMark
+  const Rgba BLOCK_COLORS[] = {
+    { 200, 200, 210, 255 },		// MINIMAP_PLAYING
+    { 235, 60, 60, 255 },			// MINIMAP_TARGET
+    { 70, 70, 76, 255 }				// MINIMAP_KNOCKED_OUT
+  };
+}
+
+// constructor
+//   room for count boards, columns to a row (every pixel transparent)
+MinimapAtlas::MinimapAtlas(int count, int columns)
+:count(std::max(0, count)), columns(std::max(1, columns))
+{
+  int rows = (this->count + this->columns - 1) / this->columns;
+  width = this->columns * CELL_WIDTH;
+  height = std::max(1, rows) * CELL_HEIGHT;
+  pixels.assign(static_cast<std::size_t>(width) * height * 4, 0);
+}
+
+// redraw board index's pixels from board
+void MinimapAtlas::update(int index, const Gameboard &board, MinimapMark mark)
+{
+  if(index < 0 || index >= count)
+  {
+    return;
+  }
+  const int left = (index % columns) * CELL_WIDTH;
+  const int top = (index / columns) * CELL_HEIGHT;
+  const Rgba &block = BLOCK_COLORS[mark];
+  for(int y = 0; y < Gameboard::MAX_Y; y++)
+  {
+    std::uint16_t row = board.getRowMask(y);
+    std::uint8_t *pixel = &pixels[(static_cast<std::size_t>(top + y) * width + left) * 4];
+    for(int x = 0; x < Gameboard::MAX_X; x++, pixel += 4)
+    {
+      const Rgba &color = (row & (1u << x)) ? block : EMPTY_COLOR;
+      pixel[0] = color.r;
+      pixel[1] = color.g;
+      pixel[2] = color.b;
+      pixel[3] = color.a;
+    }
+  }
+}
+
+// the atlas: getWidth() x getHeight() RGBA pixels, row by row
+const std::uint8_t* MinimapAtlas::getPixels() const
+{
+  return pixels.data();
+}
+
+int MinimapAtlas::getWidth() const
+{
+  return width;
+}
+
+int MinimapAtlas::getHeight() const
+{
+  return height;
+}
+
+int MinimapAtlas::getCount() const
+{
+  return count;
+}
@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <cstdlib>
+#include "PlacementSearch.h"
+
+namespace
+{
+  // the cells a landed shape covers, in a fixed order (to spot placements
+  //   that reach the same cells by different rotations, eg: an O's)
+  std::vector<int> coveredCells(const GridTetromino &shape)
+  {
+    std::vector<int> cells;
+    for(const Point &p : shape.getBlockLocsMappedToGrid())
+    {
+      cells.push_back(p.getY() * Gameboard::MAX_X + p.getX());
+    }
+    std::sort(cells.begin(), cells.end());
+    return cells;
+  }
+}
+
+// is the shape inside the left, right & bottom borders, on empty cells?
+//   (the engine's rule: the top is open, so shapes can spawn above it)
+bool PlacementSearch::isLegal(const Gameboard &board, const GridTetromino &shape)
+{
+  BlockLocs locs = shape.getBlockLocsMappedToGrid();
+  for(const Point &p : locs)
+  {
+    if(p.getX() < 0 || p.getX() >= Gameboard::MAX_X || p.getY() >= Gameboard::MAX_Y)
+    {
+      return false;
+    }
+  }
+  return board.areLocsEmpty(locs);
+}
+
+// rotate the shape in place, shift it to x, then drop it (as a bot would)
+//   return false (and leave shape part way) if a move on the way is illegal
+bool PlacementSearch::reach(const Gameboard &board, GridTetromino &shape, int rotations, int x)
+{
+  for(int i = 0; i < rotations; i++)
+  {
+    shape.rotateClockwise();
+    if(!isLegal(board, shape))
+    {
+      return false;
+    }
+  }
+  while(shape.getGridLoc().getX() != x)
+  {
+    shape.move(shape.getGridLoc().getX() < x ? 1 : -1, 0);
+    if(!isLegal(board, shape))
+    {
+      return false;
+    }
+  }
+  if(!isLegal(board, shape))
+  {
+    return false;
+  }
+  GridTetromino lower = shape;
+  lower.move(0, 1);
+  while(isLegal(board, lower))
+  {
+    shape = lower;
+    lower.move(0, 1);
+  }
+  return true;
+}
+
+// lock shape (at its grid loc) on board & clear the completed rows
+//   return the number of rows cleared
+int PlacementSearch::place(Gameboard &board, const GridTetromino &shape)
+{
+  for(const Point &p : shape.getBlockLocsMappedToGrid())
+  {
+    if(p.getY() >= 0)
+    {
+      board.setContent(p, static_cast<int>(shape.getColor()));
+    }
+  }
+  return board.removeCompletedRows();
+}
+
+// score a board (higher is better, see the top)
+double PlacementSearch::evaluate(const Gameboard &board, int rowsCleared, const PlacementWeights &weights)
+{
+  // each column's height (rows from its top block to the floor), and the holes under it
+  int heights[Gameboard::MAX_X] = {};
+  int holes = 0;
+  std::uint16_t covered = 0;		// columns that have a block above this row
+  for(int y = 0; y < Gameboard::MAX_Y; y++)
+  {
+    std::uint16_t row = board.getRowMask(y);
+    for(int x = 0; x < Gameboard::MAX_X; x++)
+    {
+      std::uint16_t bit = static_cast<std::uint16_t>(1u << x);
+      if((row & bit) && !(covered & bit))
+      {
+        heights[x] = Gameboard::MAX_Y - y;
+      }
+      else if(!(row & bit) && (covered & bit))
+      {
+        holes++;
+      }
+    }
+    covered |= row;
+  }
+
+  int aggregateHeight = 0;
+  int bumpiness = 0;
+  for(int x = 0; x < Gameboard::MAX_X; x++)
+  {
+    aggregateHeight += heights[x];
+    if(x > 0)
+    {
+      bumpiness += std::abs(heights[x] - heights[x - 1]);
+    }
+  }
+  return weights.rowsCleared * rowsCleared + weights.aggregateHeight * aggregateHeight
+    + weights.holes * holes + weights.bumpiness * bumpiness;
+}
+
+// every placement reachable from where the shape is (one per distinct
+//   rotation & column), scored.  placements is cleared first
+void PlacementSearch::findAll(const Gameboard &board, const GridTetromino &shape, std::vector<Placement> &placements,
+  const PlacementWeights &weights)
+{
+  placements.clear();
+  if(!isLegal(board, shape))
+  {
+    return;
+  }
+  std::vector<std::vector<int>> seen;
+  for(int rotations = 0; rotations < 4; rotations++)
+  {
+    // (a shape's blocks reach at most 2 cells from its grid loc)
+    for(int x = -2; x < Gameboard::MAX_X + 2; x++)
+    {
+      GridTetromino landed = shape;
+      if(!reach(board, landed, rotations, x))
+      {
+        continue;
+      }
+      std::vector<int> cells = coveredCells(landed);
+      if(std::find(seen.begin(), seen.end(), cells) != seen.end())
+      {
+        continue;
+      }
+      seen.push_back(cells);
+
+      Gameboard after = board;
+      Placement placement;
+      placement.found = true;
+      placement.rotations = rotations;
+      placement.x = x;
+      placement.y = landed.getGridLoc().getY();
+      placement.rowsCleared = place(after, landed);
+      placement.score = evaluate(after, placement.rowsCleared, weights);
+      if(cells.front() < 0)
+      {
+        placement.score += weights.toppedOut;
+      }
+      placements.push_back(placement);
+    }
+  }
+}
+
+// the best placement reachable from where the shape is
+//   (found is false if there is none)
+Placement PlacementSearch::findBest(const Gameboard &board, const GridTetromino &shape, const PlacementWeights &weights)
+{
+  std::vector<Placement> placements;
+  findAll(board, shape, placements, weights);
+  Placement best;
+  for(const Placement &placement : placements)
+  {
+    // (ties go to the first found: fewer rotations, further left)
+    if(!best.found || placement.score > best.score)
+    {
+      best = placement;
+    }
+  }
+  return best;
+}
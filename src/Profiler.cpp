@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include "Profiler.h"
+
+namespace
+{
+  // nanoseconds on the steady clock
+  std::uint64_t steadyNanoseconds()
+  {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count());
+  }
+
+  // gives each profiler a different id (so a thread's cached buffer is never
+  //   mistaken for one of a profiler created at the same address later)
+  std::atomic<std::uint64_t> nextProfilerId{ 1 };
+}
+
+// the profiler the PROFILE_SCOPE()s record to
+Profiler& Profiler::global()
+{
+  static Profiler profiler;
+  return profiler;
+}
+
+Profiler::Profiler()
+:id(nextProfilerId++), startNanoseconds(steadyNanoseconds())
+{
+}
+
+// nanoseconds since this profiler was created (steady clock)
+std::uint64_t Profiler::now() const
+{
+  return steadyNanoseconds() - startNanoseconds;
+}
+
+// record a sample on the calling thread's queue (any thread)
+void Profiler::record(const char *name, std::uint64_t startNanoseconds, std::uint64_t durationNanoseconds)
+{
+  ThreadBuffer &buffer = getThreadBuffer();
+  ProfileSample sample;
+  sample.name = name;
+  sample.startNanoseconds = startNanoseconds;
+  sample.durationNanoseconds = durationNanoseconds;
+  sample.thread = buffer.thread;
+  if(!buffer.queue.push(sample))
+  {
+    buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+// move every thread's samples into the trace & this frame's phase stats
+//   (one thread only, eg: main, once per frame)
+void Profiler::collect()
+{
+  std::lock_guard<std::mutex> lock(threadsMutex);
+  for(const std::unique_ptr<ThreadBuffer> &buffer : threads)
+  {
+    const ProfileSample *sample;
+    while((sample = buffer->queue.front()) != nullptr)
+    {
+      Phase *phase = findPhase(sample->name);
+      if(phase != nullptr)
+      {
+        phase->frameNanoseconds += sample->durationNanoseconds;
+      }
+      if(trace.size() < MAX_TRACE_SAMPLES)
+      {
+        trace.push_back(*sample);
+      }
+      else
+      {
+        traceDropped++;
+      }
+      buffer->queue.popFront();
+    }
+  }
+}
+
+// finish a frame's phase stats (after its collect())
+void Profiler::endFrame()
+{
+  statsFrames++;
+  for(int i = 0; i < phaseCount; i++)
+  {
+    Phase &phase = phases[i];
+    phase.totalNanoseconds += phase.frameNanoseconds;
+    phase.maxNanoseconds = std::max(phase.maxNanoseconds, phase.frameNanoseconds);
+    phase.frameNanoseconds = 0;
+    if(statsFrames == STATS_FRAMES)
+    {
+      phase.shownMeanMilliseconds = phase.totalNanoseconds / 1e6 / STATS_FRAMES;
+      phase.shownMaxMilliseconds = phase.maxNanoseconds / 1e6;
+      phase.totalNanoseconds = 0;
+      phase.maxNanoseconds = 0;
+    }
+  }
+  if(statsFrames == STATS_FRAMES)
+  {
+    statsFrames = 0;
+  }
+}
+
+// one line per phase: "name  mean  max" (milliseconds per frame), slowest first
+//   (lines is cleared first)
+void Profiler::getPhaseLines(std::vector<std::string> &lines) const
+{
+  const Phase *sorted[MAX_PHASES];
+  for(int i = 0; i < phaseCount; i++)
+  {
+    sorted[i] = &phases[i];
+  }
+  std::stable_sort(sorted, sorted + phaseCount, [](const Phase *a, const Phase *b) {
+    return a->shownMeanMilliseconds > b->shownMeanMilliseconds;
+  });
+
+  lines.clear();
+  for(int i = 0; i < phaseCount; i++)
+  {
+    char line[64];
+    std::snprintf(line, sizeof(line), "%-20.20s %7.3f %7.3f", sorted[i]->name,
+      sorted[i]->shownMeanMilliseconds, sorted[i]->shownMaxMilliseconds);
+    lines.push_back(line);
+  }
+}
+
+// write the collected trace as Chrome trace_event JSON
+//   (complete "X" events, times in microseconds; the names are literals, so need no escaping)
+void Profiler::writeChromeTrace(std::ostream &out) const
+{
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  char event[256];
+  for(std::size_t i = 0; i < trace.size(); i++)
+  {
+    const ProfileSample &sample = trace[i];
+    std::snprintf(event, sizeof(event), "%s\n{\"name\":\"%s\",\"cat\":\"tetris\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+      (i > 0) ? "," : "", sample.name, sample.startNanoseconds / 1000.0, sample.durationNanoseconds / 1000.0,
+      static_cast<unsigned>(sample.thread));
+    out << event;
+  }
+  out << "\n]}\n";
+}
+
+// forget the trace & phase stats (not the samples waiting to be collected)
+void Profiler::clear()
+{
+  trace.clear();
+  traceDropped = 0;
+  phaseCount = 0;
+  statsFrames = 0;
+}
+
+std::size_t Profiler::getTraceSize() const
+{
+  return trace.size();
+}
+
+std::uint64_t Profiler::getDroppedSamples() const
+{
+  std::uint64_t dropped = traceDropped;
+  std::lock_guard<std::mutex> lock(threadsMutex);
+  for(const std::unique_ptr<ThreadBuffer> &buffer : threads)
+  {
+    dropped += buffer->dropped.load(std::memory_order_relaxed);
+  }
+  return dropped;
+}
+
+// the calling thread's buffer (registered on its first call)
+Profiler::ThreadBuffer& Profiler::getThreadBuffer()
+{
+  // the buffer this thread used last, and whose it is
+  thread_local std::uint64_t cachedId = 0;
+  thread_local ThreadBuffer *cachedBuffer = nullptr;
+  if(cachedId == id)
+  {
+    return *cachedBuffer;
+  }
+
+  std::lock_guard<std::mutex> lock(threadsMutex);
+  threads.emplace_back(new ThreadBuffer());
+  threads.back()->thread = static_cast<std::uint32_t>(threads.size() - 1);
+  cachedId = id;
+  cachedBuffer = threads.back().get();
+  return *cachedBuffer;
+}
+
+// the phase for name (nullptr if there are MAX_PHASES already)
+Profiler::Phase* Profiler::findPhase(const char *name)
+{
+  for(int i = 0; i < phaseCount; i++)
+  {
+    // the same literal is usually the same pointer, but not across translation units
+    if(phases[i].name == name || std::strcmp(phases[i].name, name) == 0)
+    {
+      return &phases[i];
+    }
+  }
+  if(phaseCount == MAX_PHASES)
+  {
+    return nullptr;
+  }
+  phases[phaseCount] = Phase();
+  phases[phaseCount].name = name;
+  return &phases[phaseCount++];
+}
@@ -0,0 +1,256 @@
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include "ResourceCache.h"
+
+namespace
+{
+  // the (lower case) extension of path, without the dot ("" if it has none)
+  std::string extensionOf(const std::string &path)
+  {
+    std::string::size_type dot = path.find_last_of('.');
+    if(dot == std::string::npos || path.find_first_of("/\\", dot) != std::string::npos)
+    {
+      return "";
+    }
+    std::string extension = path.substr(dot + 1);
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+      [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+    return extension;
+  }
+
+  bool isImage(const std::string &extension)
+  {
+    return extension == "png" || extension == "jpg" || extension == "jpeg" || extension == "bmp";
+  }
+
+  bool isFont(const std::string &extension)
+  {
+    return extension == "ttf" || extension == "otf";
+  }
+
+  bool isSound(const std::string &extension)
+  {
+    return extension == "ogg" || extension == "wav" || extension == "flac";
+  }
+
+  // report a failed load (SFML has said why on std::cerr already)
+  void reportFailure(const char *kind, const std::string &path)
+  {
+    std::cerr << "ResourceCache: couldn't load " << kind << " " << path << "\n";
+  }
+}
+
+// constructor
+//   set up the loaders (nothing is loaded yet)
+ResourceCache::ResourceCache()
+:images([this](sf::Image &image, const std::string &path)
+  {
+    AssetView packed = findPacked(path);
+    bool loaded;
+    if(packed.data != nullptr)
+    {
+      loaded = true;
+      if(packed.format == ASSET_RGBA)
+      {
+        image.create(packed.width, packed.height, packed.data);
+      }
+      else
+      {
+        loaded = image.loadFromMemory(packed.data, packed.size);
+      }
+    }
+    else
+    {
+      loaded = image.loadFromFile(path);
+    }
+    if(!loaded)
+    {
+      reportFailure("image", path);
+    }
+    return loaded;
+  }),
+ textures([this](sf::Texture &texture, const std::string &path)
+  {
+    // pre-decoded pixels go straight from the mapping to the GPU
+    AssetView packed = findPacked(path);
+    if(packed.format == ASSET_RGBA && packed.data != nullptr)
+    {
+      bool created = texture.create(packed.width, packed.height);
+      if(created)
+      {
+        texture.update(packed.data);
+      }
+      else
+      {
+        reportFailure("texture", path);
+      }
+      return created;
+    }
+
+    std::shared_ptr<sf::Image> image = images.get(path);
+    if(image == nullptr)
+    {
+      return false;			// (reported by the image loader)
+    }
+    bool loaded = texture.loadFromImage(*image);
+    if(!loaded)
+    {
+      reportFailure("texture", path);
+    }
+    images.erase(path);	// the texture has it now
+    return loaded;
+  }),
+ fonts([this](sf::Font &font, const std::string &path)
+  {
+    AssetView packed = findPacked(path);
+    bool loaded = packed.data != nullptr ? font.loadFromMemory(packed.data, packed.size) : font.loadFromFile(path);
+    if(!loaded)
+    {
+      reportFailure("font", path);
+    }
+    return loaded;
+  }),
+ soundBuffers([this](sf::SoundBuffer &buffer, const std::string &path)
+  {
+    AssetView packed = findPacked(path);
+    bool loaded = packed.data != nullptr ? buffer.loadFromMemory(packed.data, packed.size) : buffer.loadFromFile(path);
+    if(!loaded)
+    {
+      reportFailure("sound", path);
+    }
+    return loaded;
+  })
+{
+}
+
+// destructor: waitForPreload()
+ResourceCache::~ResourceCache()
+{
+  waitForPreload();
+}
+
+// take the assets from archive (nullptr: from their files).  Call it before
+//   loading anything
+void ResourceCache::setArchive(std::shared_ptr<const AssetArchive> newArchive)
+{
+  waitForPreload();
+  archive = newArchive;
+}
+
+// the archived asset at path (data is nullptr if there is no archive, or
+//   it isn't in it).  For assets that aren't cached, like streamed music
+AssetView ResourceCache::findPacked(const std::string &path) const
+{
+  return archive != nullptr ? archive->find(path) : AssetView();
+}
+
+// the texture of the image at path (eg: "assets/images/tiles.png")
+//   call it on the rendering thread.  nullptr if it failed to load
+std::shared_ptr<const sf::Texture> ResourceCache::getTexture(const std::string &path)
+{
+  return textures.get(path);
+}
+
+// the font at path (eg: "assets/fonts/RedOctober.ttf")
+//   nullptr if it failed to load
+std::shared_ptr<const sf::Font> ResourceCache::getFont(const std::string &path)
+{
+  return fonts.get(path);
+}
+
+// the decoded sound at path (eg: "assets/sfx/blockDrop.ogg")
+//   nullptr if it failed to load
+std::shared_ptr<const sf::SoundBuffer> ResourceCache::getSoundBuffer(const std::string &path)
+{
+  return soundBuffers.get(path);
+}
+
+// start loading paths on a background thread (by extension: .png/.jpg/.bmp
+//   images, .ttf/.otf fonts, .ogg/.wav/.flac sounds; anything else is reported
+//   & skipped).
+//   A get() of an asset it is still loading waits for it.
+//   Waits for an earlier preload() to finish first.
+void ResourceCache::preload(const std::vector<std::string> &paths)
+{
+  waitForPreload();
+  preloadDone = 0;
+  preloadCount = static_cast<int>(paths.size());
+  preloader = std::thread([this, paths]()
+  {
+    for(const std::string &path : paths)
+    {
+      preloadOne(path);
+      preloadDone++;
+    }
+  });
+}
+
+// is a preload() still running?
+bool ResourceCache::isPreloading() const
+{
+  return preloadDone.load() < preloadCount.load();
+}
+
+// the fraction of the last preload() done (0 to 1; 1 if there was none)
+float ResourceCache::getPreloadProgress() const
+{
+  int count = preloadCount.load();
+  return count == 0 ? 1.0f : static_cast<float>(preloadDone.load()) / count;
+}
+
+// wait for the preload() (if any) to finish
+void ResourceCache::waitForPreload()
+{
+  if(preloader.joinable())
+  {
+    preloader.join();
+  }
+}
+
+// the paths that failed to load (each once)
+std::vector<std::string> ResourceCache::getFailures() const
+{
+  // (a texture whose image failed is listed by both)
+  std::vector<std::string> failures = images.getFailures();
+  for(const std::vector<std::string> &more : { textures.getFailures(), fonts.getFailures(), soundBuffers.getFailures() })
+  {
+    failures.insert(failures.end(), more.begin(), more.end());
+  }
+  std::sort(failures.begin(), failures.end());
+  failures.erase(std::unique(failures.begin(), failures.end()), failures.end());
+  return failures;
+}
+
+// drop the assets nothing outside the cache holds
+//   return how many were dropped
+int ResourceCache::purge()
+{
+  return images.purge() + textures.purge() + fonts.purge() + soundBuffers.purge();
+}
+
+// load one path on the preload thread (see preload())
+void ResourceCache::preloadOne(const std::string &path)
+{
+  std::string extension = extensionOf(path);
+  if(isImage(extension))
+  {
+    // (the upload waits for getTexture(); packed pixels need no decoding)
+    if(!textures.contains(path) && findPacked(path).format != ASSET_RGBA)
+    {
+      images.get(path);
+    }
+  }
+  else if(isFont(extension))
+  {
+    fonts.get(path);
+  }
+  else if(isSound(extension))
+  {
+    soundBuffers.get(path);
+  }
+  else
+  {
+    reportFailure("(unknown type)", path);
+  }
+}
@@ -0,0 +1,218 @@
+#include <algorithm>
+#include <assert.h>
+#include <chrono>
+#include "RollbackSession.h"
+
+namespace
+{
+  void writeInt32(std::vector<std::uint8_t> &out, std::int32_t value)
+  {
+    std::uint32_t bits = static_cast<std::uint32_t>(value);
+    for(int i = 0; i < 4; i++)
+    {
+      out.push_back(static_cast<std::uint8_t>(bits >> (8 * i)));
+    }
+  }
+
+  std::int32_t readInt32(const std::uint8_t *data)
+  {
+    std::uint32_t bits = 0;
+    for(int i = 0; i < 4; i++)
+    {
+      bits |= static_cast<std::uint32_t>(data[i]) << (8 * i);
+    }
+    return static_cast<std::int32_t>(bits);
+  }
+}
+
+// constructor
+//   localPlayer is 0 or 1, both peers must use the same seed
+RollbackSession::RollbackSession(int localPlayer, std::uint32_t seed)
+:localPlayer(localPlayer)
+{
+  assert((localPlayer == 0 || localPlayer == 1) && "Invalid local player");
+
+  for(int player = 0; player < PLAYER_COUNT; player++)
+  {
+    engines[player] = TetrisEngine(seed);
+  }
+  std::fill(localInputs, localInputs + HISTORY_SIZE, InputMask(0));
+  std::fill(remoteInputs, remoteInputs + HISTORY_SIZE, InputMask(0));
+  std::fill(usedRemoteInputs, usedRemoteInputs + HISTORY_SIZE, InputMask(0));
+}
+
+// record the local input for the next frame and simulate that frame.
+//   return false (and do nothing) if the remote peer is too far behind.
+bool RollbackSession::advanceFrame(InputMask localInput)
+{
+  // too far ahead of the remote: a rollback could go deeper than our history,
+  // or we could overwrite local inputs the remote hasn't received yet.
+  if(currentFrame - confirmedFrame > MAX_PREDICTION_FRAMES ||
+     currentFrame - remoteAckFrame >= HISTORY_SIZE)
+  {
+    stats.stalls++;
+    return false;
+  }
+
+  localInputs[currentFrame % HISTORY_SIZE] = localInput;
+  simulateFrame(currentFrame);
+  currentFrame++;
+  stats.framesSimulated++;
+
+  return true;
+}
+
+// build the packet to send to the remote peer.
+//   layout: [startFrame:int32][ackFrame:int32][count:uint8][count x InputMask]
+std::vector<std::uint8_t> RollbackSession::buildInputPacket() const
+{
+  int startFrame = std::max(remoteAckFrame + 1, currentFrame - HISTORY_SIZE);
+  int count = currentFrame - startFrame;
+
+  std::vector<std::uint8_t> packet;
+  packet.reserve(PACKET_HEADER_SIZE + count);
+  writeInt32(packet, startFrame);
+  writeInt32(packet, confirmedFrame);
+  packet.push_back(static_cast<std::uint8_t>(count));
+  for(int frame = startFrame; frame < currentFrame; frame++)
+  {
+    packet.push_back(localInputs[frame % HISTORY_SIZE]);
+  }
+  return packet;
+}
+
+// handle a packet from the remote peer.
+//   confirms remote inputs and rolls back if any prediction was wrong.
+//   return false if the packet was malformed.
+bool RollbackSession::receiveInputPacket(const std::uint8_t *data, std::size_t size)
+{
+  if(size < PACKET_HEADER_SIZE)
+  {
+    return false;
+  }
+  int startFrame = readInt32(data);
+  int ackFrame = readInt32(data + 4);
+  int count = data[8];
+  if(startFrame < 0 || size != PACKET_HEADER_SIZE + count)
+  {
+    return false;
+  }
+
+  remoteAckFrame = std::max(remoteAckFrame, std::min(ackFrame, currentFrame - 1));
+
+  int firstMispredicted = -1;
+  for(int i = 0; i < count; i++)
+  {
+    int frame = startFrame + i;
+    if(frame <= confirmedFrame)
+    {
+      continue;	// already have it (re-sent for redundancy)
+    }
+    if(frame != confirmedFrame + 1 || frame - currentFrame >= HISTORY_SIZE - MAX_PREDICTION_FRAMES)
+    {
+      break;		// a gap, or further ahead than our history can hold
+    }
+
+    InputMask input = data[PACKET_HEADER_SIZE + i] & TetrisEngine::ALL_BUTTONS;
+    remoteInputs[frame % HISTORY_SIZE] = input;
+    confirmedFrame = frame;
+
+    if(frame < currentFrame && firstMispredicted < 0 && usedRemoteInputs[frame % HISTORY_SIZE] != input)
+    {
+      firstMispredicted = frame;
+    }
+  }
+
+  if(firstMispredicted >= 0)
+  {
+    rollbackTo(firstMispredicted);
+  }
+  return true;
+}
+
+// the engine of a given player (0 or 1)
+const TetrisEngine& RollbackSession::getEngine(int player) const
+{
+  assert((player == 0 || player == 1) && "Invalid player");
+  return engines[player];
+}
+
+// the number of frames simulated so far (the next frame to simulate)
+int RollbackSession::getFrame() const
+{
+  return currentFrame;
+}
+
+// the newest frame for which the remote input is known (-1 if none)
+int RollbackSession::getConfirmedFrame() const
+{
+  return confirmedFrame;
+}
+
+const RollbackStats& RollbackSession::getStats() const
+{
+  return stats;
+}
+
+// the remote input to use for a frame: confirmed if we have it,
+//   otherwise predicted (repeat the newest confirmed input).
+InputMask RollbackSession::getRemoteInput(int frame) const
+{
+  if(frame <= confirmedFrame)
+  {
+    return remoteInputs[frame % HISTORY_SIZE];
+  }
+  if(confirmedFrame >= 0)
+  {
+    return remoteInputs[confirmedFrame % HISTORY_SIZE];
+  }
+  return 0;
+}
+
+// snapshot the engines, then step both with the local & remote inputs of a frame
+void RollbackSession::simulateFrame(int frame)
+{
+  int slot = frame % HISTORY_SIZE;
+  for(int player = 0; player < PLAYER_COUNT; player++)
+  {
+    snapshots[slot][player] = engines[player];
+  }
+
+  InputMask remoteInput = getRemoteInput(frame);
+  usedRemoteInputs[slot] = remoteInput;
+
+  // always step player 0 before player 1 so both peers agree
+  for(int player = 0; player < PLAYER_COUNT; player++)
+  {
+    engines[player].step(player == localPlayer ? localInputs[slot] : remoteInput);
+  }
+}
+
+// restore the snapshot taken before a frame, and re-simulate up to currentFrame
+void RollbackSession::rollbackTo(int frame)
+{
+  assert(currentFrame - frame <= HISTORY_SIZE && "Rollback deeper than history");
+  auto start = std::chrono::steady_clock::now();
+
+  int slot = frame % HISTORY_SIZE;
+  for(int player = 0; player < PLAYER_COUNT; player++)
+  {
+    engines[player] = snapshots[slot][player];
+  }
+  for(int resim = frame; resim < currentFrame; resim++)
+  {
+    simulateFrame(resim);
+  }
+  // the journals only describe the last re-simulated frame, not what changed
+  // since the (mispredicted) board consumers last saw
+  for(int player = 0; player < PLAYER_COUNT; player++)
+  {
+    engines[player].invalidateBoardChanges();
+  }
+
+  int depth = currentFrame - frame;
+  stats.rollbacks++;
+  stats.framesResimulated += depth;
+  stats.maxRollbackDepth = std::max(stats.maxRollbackDepth, depth);
+  stats.rollbackSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <cmath>
+#include "Profiler.h"
+#include "SessionHost.h"
+
+namespace
+{
+  // the columns of a grid of gameCount cells that is as square as it can be
+  int columnsFor(int gameCount)
+  {
+    return std::max(1, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(gameCount)))));
+  }
+
+  int rowsFor(int gameCount)
+  {
+    int columns = columnsFor(gameCount);
+    return std::max(1, (gameCount + columns - 1) / columns);
+  }
+}
+
+// constructor
+//   set up gameCount games (each seeded by rand()), laid out on window
+//   the offsets place the board & next shape in a game's layout (see TetrisGame)
+//   the sprites, resources & pool are shared by every game (and must outlive it)
+//   area: the part of the window (0 to 1) to lay the games out in
+SessionHost::SessionHost(sf::RenderWindow &window, sf::Sprite &blockSprite, sf::Sprite &backgroundSprite,
+  Point gameboardOffset, Point nextShapeOffset, ResourceCache &resources, WorkerPool &pool, int gameCount,
+  sf::FloatRect area)
+:window(window), backgroundSprite(backgroundSprite), pool(pool), area(area), autoplayed(std::max(1, gameCount), false)
+{
+  for(int i = 0; i < std::max(1, gameCount); i++)
+  {
+    games.push_back(std::unique_ptr<TetrisGame>(
+      new TetrisGame(window, blockSprite, gameboardOffset, nextShapeOffset, resources)));
+  }
+  layOut();
+}
+
+// a window size that fits gameCount games in maxSize (as big as it can, up
+//   to the games' own size), in a grid as square as it can be
+sf::Vector2u SessionHost::getWindowSize(int gameCount, sf::Vector2u maxSize)
+{
+  int columns = columnsFor(gameCount);
+  int rows = rowsFor(gameCount);
+  double scale = std::min(1.0, std::min(static_cast<double>(maxSize.x) / (columns * GAME_WIDTH),
+    static_cast<double>(maxSize.y) / (rows * GAME_HEIGHT)));
+  return sf::Vector2u(static_cast<unsigned>(columns * GAME_WIDTH * scale), static_cast<unsigned>(rows * GAME_HEIGHT * scale));
+}
+
+int SessionHost::getGameCount() const
+{
+  return static_cast<int>(games.size());
+}
+
+TetrisGame& SessionHost::getGame(int index)
+{
+  return *games[index];
+}
+
+// autoplay a game (see the top), or hand it back to the caller's input
+void SessionHost::setAutoplay(int index, bool enabled)
+{
+  autoplayed[index] = enabled;
+  if(!enabled)
+  {
+    games[index]->setHeldButtons(0);
+  }
+}
+
+// step every game once, in parallel (see TetrisGame::step())
+void SessionHost::step()
+{
+  PROFILE_SCOPE("SessionHost::step");
+  stepClock.restart();
+  pool.run(getGameCount(), [this](int index)
+  {
+    if(autoplayed[index])
+    {
+      games[index]->setHeldButtons(TetrisEngine::autoplayButtons(index, frame));
+    }
+    games[index]->step();
+  });
+  frame++;
+  lastStepSeconds = stepClock.getElapsedTime().asMicroseconds() / 1e6;
+}
+
+// draw every game (the background too) in its viewport of the window
+//   (see TetrisGame::draw()), then restore the window's default view
+void SessionHost::draw(double secondsAhead)
+{
+  for(int i = 0; i < getGameCount(); i++)
+  {
+    window.setView(views[i]);
+    window.draw(backgroundSprite);
+    games[i]->draw(secondsAhead);
+  }
+  window.setView(window.getDefaultView());
+}
+
+// the part of the window (0 to 1) a game is drawn in
+sf::FloatRect SessionHost::getViewport(int index) const
+{
+  return views[index].getViewport();
+}
+
+// how long the last step() took (all the games), in seconds
+double SessionHost::getLastStepSeconds() const
+{
+  return lastStepSeconds;
+}
+
+// lay the games' viewports out in a grid on the window (on construction)
+void SessionHost::layOut()
+{
+  // cells of the games' shape, as big as fit, with the grid centred in the area
+  int columns = columnsFor(getGameCount());
+  int rows = rowsFor(getGameCount());
+  sf::Vector2u windowSize = window.getSize();
+  float scale = std::min(area.width * windowSize.x / (columns * GAME_WIDTH),
+    area.height * windowSize.y / (rows * GAME_HEIGHT));
+  float cellWidth = GAME_WIDTH * scale / windowSize.x;
+  float cellHeight = GAME_HEIGHT * scale / windowSize.y;
+  float left = area.left + (area.width - columns * cellWidth) / 2;
+  float top = area.top + (area.height - rows * cellHeight) / 2;
+
+  views.clear();
+  for(int i = 0; i < getGameCount(); i++)
+  {
+    sf::View view(sf::FloatRect(0, 0, GAME_WIDTH, GAME_HEIGHT));
+    view.setViewport(sf::FloatRect(left + (i % columns) * cellWidth, top + (i / columns) * cellHeight, cellWidth, cellHeight));
+    views.push_back(view);
+  }
+}
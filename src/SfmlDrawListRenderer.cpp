@@ -0,0 +1,102 @@
+#include "SfmlDrawListRenderer.h"
+
+// constructor
+SfmlDrawListRenderer::SfmlDrawListRenderer()
+:batch(sf::Quads)
+{
+}
+
+// the texture to use for a texture id (nullptr to draw those quads untextured)
+void SfmlDrawListRenderer::setTexture(DrawTextureId id, const sf::Texture *texture)
+{
+  textures[id] = texture;
+}
+
+// the font for text runs (text runs aren't drawn without one)
+void SfmlDrawListRenderer::setFont(const sf::Font *newFont)
+{
+  font = newFont;
+  texts.clear();
+}
+
+// make room to batch this many quads, so drawing lists up to that size never allocates
+void SfmlDrawListRenderer::reserve(std::size_t quadCount)
+{
+  // (sf::VertexArray::clear() keeps its storage)
+  batch.resize(quadCount * 4);
+  batch.clear();
+}
+
+// draw a draw list (quads, then text runs) on a target.
+//   return the number of draw calls it took
+int SfmlDrawListRenderer::render(const DrawList &list, sf::RenderTarget &target)
+{
+  int drawCalls = 0;
+
+  // quads: one draw call per run of quads with the same texture
+  const std::vector<DrawQuad> &quads = list.getQuads();
+  for(std::size_t i = 0; i < quads.size(); i++)
+  {
+    const DrawQuad &quad = quads[i];
+    if(i > 0 && quad.texture != quads[i - 1].texture)
+    {
+      flushBatch(target, quads[i - 1].texture);
+      drawCalls++;
+    }
+
+    const DrawRect &d = quad.dest;
+    const DrawRect &s = quad.source;
+    sf::Color color(quad.color.r, quad.color.g, quad.color.b, quad.color.a);
+    batch.append(sf::Vertex(sf::Vector2f(d.left, d.top), color, sf::Vector2f(s.left, s.top)));
+    batch.append(sf::Vertex(sf::Vector2f(d.left + d.width, d.top), color, sf::Vector2f(s.left + s.width, s.top)));
+    batch.append(sf::Vertex(sf::Vector2f(d.left + d.width, d.top + d.height), color, sf::Vector2f(s.left + s.width, s.top + s.height)));
+    batch.append(sf::Vertex(sf::Vector2f(d.left, d.top + d.height), color, sf::Vector2f(s.left, s.top + s.height)));
+  }
+  if(!quads.empty())
+  {
+    flushBatch(target, quads.back().texture);
+    drawCalls++;
+  }
+
+  // text runs: only re-set the string (which re-lays out the glyphs) when it changed
+  if(font == nullptr)
+  {
+    return drawCalls;
+  }
+  const std::vector<DrawText> &runs = list.getTexts();
+  if(texts.size() < runs.size())
+  {
+    texts.resize(runs.size());
+  }
+  for(std::size_t i = 0; i < runs.size(); i++)
+  {
+    const DrawText &run = runs[i];
+    CachedText &cached = texts[i];
+    if(cached.text.getFont() != font)
+    {
+      cached.text.setFont(*font);
+    }
+    if(cached.characterSize != run.characterSize)
+    {
+      cached.characterSize = run.characterSize;
+      cached.text.setCharacterSize(static_cast<unsigned int>(run.characterSize));
+    }
+    if(std::strcmp(cached.string, run.text) != 0)
+    {
+      std::strcpy(cached.string, run.text);
+      cached.text.setString(run.text);
+    }
+    cached.text.setFillColor(sf::Color(run.color.r, run.color.g, run.color.b, run.color.a));
+    cached.text.setPosition(run.x, run.y);
+    target.draw(cached.text);
+    drawCalls++;
+  }
+  return drawCalls;
+}
+
+// draw the quads in batch and clear it
+void SfmlDrawListRenderer::flushBatch(sf::RenderTarget &target, DrawTextureId texture)
+{
+  target.draw(batch, textures[texture]);
+  batch.clear();
+}
@@ -0,0 +1,130 @@
+#include "ShaderBoardRenderer.h"
+
+namespace
+{
+  // gl_TexCoord[0] is the position in the cell texture (0..1 over its whole,
+  // power of two, size: the board is its top left corner).
+  // the cell texel holds content + 1 (0 = empty); that picks the tile to sample.
+  const char *BOARD_FRAGMENT_SHADER =
+    "uniform sampler2D cells;\n"
+    "uniform sampler2D tiles;\n"
+    "uniform vec2 cellTextureSize;\n"	// in cells
+    "uniform vec2 tileSize;\n"		// one tile, as a fraction of the tiles texture
+    "void main()\n"
+    "{\n"
+    "  vec2 cell = gl_TexCoord[0].xy * cellTextureSize;\n"
+    "  float value = floor(texture2D(cells, (floor(cell) + 0.5) / cellTextureSize).r * 255.0 + 0.5);\n"
+    "  if(value < 0.5)\n"
+    "    discard;\n"
+    "  vec2 withinCell = fract(cell);\n"
+    "  vec2 tileCoord = vec2((value - 1.0 + withinCell.x) * tileSize.x, withinCell.y * tileSize.y);\n"
+    "  gl_FragColor = texture2D(tiles, tileCoord) * gl_Color;\n"
+    "}\n";
+}
+
+// prepare the cell texture and compile the shader.
+//   tiles: the block tiles, one blockWidth x blockHeight tile per TetColor, left to right
+//   return false if shaders aren't available or the shader didn't compile
+bool ShaderBoardRenderer::create(const sf::Texture &tiles, int blockWidth, int blockHeight)
+{
+  created = false;
+  if(!sf::Shader::isAvailable() ||
+     !cellTexture.create(CELL_TEXTURE_WIDTH, CELL_TEXTURE_HEIGHT) ||
+     !shader.loadFromMemory(BOARD_FRAGMENT_SHADER, sf::Shader::Fragment))
+  {
+    return false;
+  }
+  cellTexture.setSmooth(false);
+
+  sf::Vector2u tilesSize = tiles.getSize();
+  shader.setUniform("cells", sf::Shader::CurrentTexture);
+  shader.setUniform("tiles", tiles);
+  shader.setUniform("cellTextureSize", sf::Glsl::Vec2(CELL_TEXTURE_WIDTH, CELL_TEXTURE_HEIGHT));
+  shader.setUniform("tileSize", sf::Glsl::Vec2(static_cast<float>(blockWidth) / tilesSize.x,
+                                               static_cast<float>(blockHeight) / tilesSize.y));
+
+  // one quad over the whole board, texture coords in cell texels
+  float width = static_cast<float>(Gameboard::MAX_X * blockWidth);
+  float height = static_cast<float>(Gameboard::MAX_Y * blockHeight);
+  quad.setPrimitiveType(sf::Quads);
+  quad.resize(4);
+  quad[0] = sf::Vertex(sf::Vector2f(0, 0), sf::Vector2f(0, 0));
+  quad[1] = sf::Vertex(sf::Vector2f(width, 0), sf::Vector2f(Gameboard::MAX_X, 0));
+  quad[2] = sf::Vertex(sf::Vector2f(width, height), sf::Vector2f(Gameboard::MAX_X, Gameboard::MAX_Y));
+  quad[3] = sf::Vertex(sf::Vector2f(0, height), sf::Vector2f(0, Gameboard::MAX_Y));
+
+  fullUploadNeeded = true;
+  created = true;
+  return true;
+}
+
+// bring the cell texture up to date with the board
+//   (from the board's change journal, or a full upload if that isn't enough)
+void ShaderBoardRenderer::update(const Gameboard &board)
+{
+  if(!created)
+  {
+    return;
+  }
+  if(fullUploadNeeded || board.haveChangesOverflowed())
+  {
+    uploadAll(board);
+    return;
+  }
+
+  // single cells are uploaded as 1x1 updates; anything that moves rows re-uploads it all
+  for(int i = 0; i < board.getChangeCount(); i++)
+  {
+    if(board.getChange(i).type != BoardChange::CELL_SET)
+    {
+      uploadAll(board);
+      return;
+    }
+  }
+  for(int i = 0; i < board.getChangeCount(); i++)
+  {
+    const BoardChange &change = board.getChange(i);
+    sf::Uint8 *texel = cellPixels + (change.y * Gameboard::MAX_X + change.x) * 4;
+    texel[0] = static_cast<sf::Uint8>(change.content + 1);
+    cellTexture.update(texel, 1, 1, change.x, change.y);
+  }
+}
+
+// force a full upload on the next update()
+//   (call when update() didn't see every change, eg: after using another render path)
+void ShaderBoardRenderer::invalidate()
+{
+  fullUploadNeeded = true;
+}
+
+// draw the board with its top left at topLeft (in pixels)
+void ShaderBoardRenderer::draw(sf::RenderTarget &target, const Point &topLeft) const
+{
+  if(!created)
+  {
+    return;
+  }
+  sf::RenderStates states(&shader);
+  states.texture = &cellTexture;
+  states.transform.translate(static_cast<float>(topLeft.getX()), static_cast<float>(topLeft.getY()));
+  target.draw(quad, states);
+}
+
+bool ShaderBoardRenderer::isCreated() const
+{
+  return created;
+}
+
+// upload every cell
+void ShaderBoardRenderer::uploadAll(const Gameboard &board)
+{
+  for(int y = 0; y < Gameboard::MAX_Y; y++)
+  {
+    for(int x = 0; x < Gameboard::MAX_X; x++)
+    {
+      cellPixels[(y * Gameboard::MAX_X + x) * 4] = static_cast<sf::Uint8>(board.getContent(x, y) + 1);
+    }
+  }
+  cellTexture.update(cellPixels, Gameboard::MAX_X, Gameboard::MAX_Y, 0, 0);
+  fullUploadNeeded = false;
+}
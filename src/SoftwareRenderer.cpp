@@ -0,0 +1,350 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include "SoftwareRenderer.h"
+
+namespace
+{
+  const int GLYPH_WIDTH = 5;
+  const int GLYPH_HEIGHT = 7;
+  const int GLYPH_ADVANCE = 6;			// glyph + 1 column of spacing
+  const int GLYPH_LINE_HEIGHT = 8;	// glyph + 1 row of spacing
+
+  // the rows of a 5x7 glyph, top to bottom, bit 4 = leftmost column.
+  //   returns nullptr for characters without a glyph (drawn as a space)
+  const std::uint8_t* findGlyph(char c)
+  {
+    static const std::uint8_t DIGITS[10][GLYPH_HEIGHT] = {
+      { 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E }, { 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E },
+      { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F }, { 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E },
+      { 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 }, { 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E },
+      { 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E }, { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 },
+      { 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E }, { 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C }
+    };
+    static const std::uint8_t LETTERS[26][GLYPH_HEIGHT] = {
+      { 0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 }, { 0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E },	// A B
+      { 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E }, { 0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C },	// C D
+      { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F }, { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10 },	// E F
+      { 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F }, { 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 },	// G H
+      { 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E }, { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C },	// I J
+      { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 }, { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F },	// K L
+      { 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 }, { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 },	// M N
+      { 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E }, { 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 },	// O P
+      { 0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D }, { 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 },	// Q R
+      { 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E }, { 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 },	// S T
+      { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E }, { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04 },	// U V
+      { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A }, { 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11 },	// W X
+      { 0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04 }, { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F }	// Y Z
+    };
+    static const std::uint8_t COLON[GLYPH_HEIGHT] = { 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00 };
+    static const std::uint8_t PERIOD[GLYPH_HEIGHT] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C };
+    static const std::uint8_t MINUS[GLYPH_HEIGHT] = { 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00 };
+    static const std::uint8_t SLASH[GLYPH_HEIGHT] = { 0x01, 0x01, 0x02, 0x04, 0x08, 0x10, 0x10 };
+
+    if(c >= '0' && c <= '9') return DIGITS[c - '0'];
+    if(c >= 'A' && c <= 'Z') return LETTERS[c - 'A'];
+    if(c >= 'a' && c <= 'z') return LETTERS[c - 'a'];
+    switch(c)
+    {
+      case ':': return COLON;
+      case '.': return PERIOD;
+      case '-': return MINUS;
+      case '/': return SLASH;
+      default: return nullptr;
+    }
+  }
+
+  void writeBigEndian32(std::vector<std::uint8_t> &out, std::uint32_t value)
+  {
+    for(int shift = 24; shift >= 0; shift -= 8)
+    {
+      out.push_back(static_cast<std::uint8_t>(value >> shift));
+    }
+  }
+
+  std::uint32_t crc32(const std::uint8_t *data, std::size_t size)
+  {
+    static std::uint32_t table[256] = {};
+    if(table[1] == 0)
+    {
+      for(std::uint32_t n = 0; n < 256; n++)
+      {
+        std::uint32_t c = n;
+        for(int k = 0; k < 8; k++)
+        {
+          c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        table[n] = c;
+      }
+    }
+    std::uint32_t crc = 0xFFFFFFFFu;
+    for(std::size_t i = 0; i < size; i++)
+    {
+      crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+  }
+
+  // append a PNG chunk: [length][type][data][crc of type + data]
+  void writePngChunk(std::vector<std::uint8_t> &out, const char type[4], const std::vector<std::uint8_t> &data)
+  {
+    writeBigEndian32(out, static_cast<std::uint32_t>(data.size()));
+    std::size_t typeStart = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    writeBigEndian32(out, crc32(out.data() + typeStart, out.size() - typeStart));
+  }
+
+  bool writeFile(const std::string &path, const std::vector<std::uint8_t> &bytes)
+  {
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return static_cast<bool>(file);
+  }
+}
+
+// constructor
+//   the size of the frame buffer in pixels
+SoftwareRenderer::SoftwareRenderer(int width, int height)
+:width(width), height(height), pixels(static_cast<std::size_t>(width) * height * 4, 0)
+{
+}
+
+// give a texture id its image (copied): width x height RGBA pixels, row by row
+void SoftwareRenderer::setTexture(DrawTextureId id, const std::uint8_t *rgba, int textureWidth, int textureHeight)
+{
+  Texture &texture = textures[id];
+  texture.width = textureWidth;
+  texture.height = textureHeight;
+  texture.rgba.assign(rgba, rgba + static_cast<std::size_t>(textureWidth) * textureHeight * 4);
+}
+
+// fill the whole frame with a color
+void SoftwareRenderer::clear(DrawColor color)
+{
+  for(std::size_t i = 0; i < pixels.size(); i += 4)
+  {
+    pixels[i] = color.r;
+    pixels[i + 1] = color.g;
+    pixels[i + 2] = color.b;
+    pixels[i + 3] = color.a;
+  }
+}
+
+// draw a draw list (quads, then text runs) over the frame
+void SoftwareRenderer::render(const DrawList &list)
+{
+  for(const DrawQuad &quad : list.getQuads())
+  {
+    drawQuad(quad);
+  }
+  for(const DrawText &text : list.getTexts())
+  {
+    drawText(text);
+  }
+}
+
+// the RGBA color of a pixel (must be within the frame)
+DrawColor SoftwareRenderer::getPixel(int x, int y) const
+{
+  const std::uint8_t *p = &pixels[(static_cast<std::size_t>(y) * width + x) * 4];
+  DrawColor color;
+  color.r = p[0];
+  color.g = p[1];
+  color.b = p[2];
+  color.a = p[3];
+  return color;
+}
+
+int SoftwareRenderer::getWidth() const
+{
+  return width;
+}
+
+int SoftwareRenderer::getHeight() const
+{
+  return height;
+}
+
+const std::vector<std::uint8_t>& SoftwareRenderer::getPixels() const
+{
+  return pixels;
+}
+
+// the frame as a binary PPM (P6, RGB)
+void SoftwareRenderer::encodePPM(std::vector<std::uint8_t> &out) const
+{
+  std::string header = "P6\n" + std::to_string(width) + " " + std::to_string(height) + "\n255\n";
+  out.assign(header.begin(), header.end());
+  out.reserve(out.size() + static_cast<std::size_t>(width) * height * 3);
+  for(std::size_t i = 0; i < pixels.size(); i += 4)
+  {
+    out.insert(out.end(), pixels.begin() + i, pixels.begin() + i + 3);
+  }
+}
+
+// the frame as a PNG (RGBA), with the image data in uncompressed ("stored") deflate blocks
+void SoftwareRenderer::encodePNG(std::vector<std::uint8_t> &out) const
+{
+  static const std::uint8_t SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+  out.assign(SIGNATURE, SIGNATURE + 8);
+
+  std::vector<std::uint8_t> header;
+  writeBigEndian32(header, static_cast<std::uint32_t>(width));
+  writeBigEndian32(header, static_cast<std::uint32_t>(height));
+  header.insert(header.end(), { 8, 6, 0, 0, 0 });	// 8 bits, RGBA, deflate, no filter, no interlace
+  writePngChunk(out, "IHDR", header);
+
+  // the scanlines, each with filter type 0 (none)
+  std::size_t rowSize = static_cast<std::size_t>(width) * 4;
+  std::vector<std::uint8_t> raw;
+  raw.reserve((rowSize + 1) * height);
+  for(int y = 0; y < height; y++)
+  {
+    raw.push_back(0);
+    raw.insert(raw.end(), pixels.begin() + y * rowSize, pixels.begin() + (y + 1) * rowSize);
+  }
+
+  // zlib stream: header, stored blocks of up to 65535 bytes, adler32
+  std::vector<std::uint8_t> zlib = { 0x78, 0x01 };
+  std::size_t offset = 0;
+  do
+  {
+    std::size_t length = std::min<std::size_t>(65535, raw.size() - offset);
+    bool last = offset + length == raw.size();
+    zlib.push_back(last ? 1 : 0);
+    zlib.push_back(static_cast<std::uint8_t>(length));
+    zlib.push_back(static_cast<std::uint8_t>(length >> 8));
+    zlib.push_back(static_cast<std::uint8_t>(~length));
+    zlib.push_back(static_cast<std::uint8_t>(~length >> 8));
+    zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + length);
+    offset += length;
+  } while(offset < raw.size());
+
+  std::uint32_t a = 1, b = 0;
+  for(std::uint8_t byte : raw)
+  {
+    a = (a + byte) % 65521;
+    b = (b + a) % 65521;
+  }
+  writeBigEndian32(zlib, (b << 16) | a);
+  writePngChunk(out, "IDAT", zlib);
+  writePngChunk(out, "IEND", std::vector<std::uint8_t>());
+}
+
+// write the frame to a file. return false if it couldn't be written
+bool SoftwareRenderer::writePPM(const std::string &path) const
+{
+  std::vector<std::uint8_t> bytes;
+  encodePPM(bytes);
+  return writeFile(path, bytes);
+}
+
+bool SoftwareRenderer::writePNG(const std::string &path) const
+{
+  std::vector<std::uint8_t> bytes;
+  encodePNG(bytes);
+  return writeFile(path, bytes);
+}
+
+// draw a quad: pixels whose centers fall inside dest, sampled from the
+//   nearest texel of source (or the quad's color if it has no texture)
+void SoftwareRenderer::drawQuad(const DrawQuad &quad)
+{
+  int left = std::max(0, static_cast<int>(std::lround(quad.dest.left)));
+  int top = std::max(0, static_cast<int>(std::lround(quad.dest.top)));
+  int right = std::min(width, static_cast<int>(std::lround(quad.dest.left + quad.dest.width)));
+  int bottom = std::min(height, static_cast<int>(std::lround(quad.dest.top + quad.dest.height)));
+
+  const Texture &texture = textures[quad.texture];
+  if(quad.texture == TEXTURE_NONE || texture.rgba.empty())
+  {
+    fillRect(left, top, right, bottom, quad.color);
+    return;
+  }
+
+  float uScale = quad.source.width / quad.dest.width;
+  float vScale = quad.source.height / quad.dest.height;
+  for(int y = top; y < bottom; y++)
+  {
+    int v = static_cast<int>(quad.source.top + (y + 0.5f - quad.dest.top) * vScale);
+    v = std::min(std::max(v, 0), texture.height - 1);
+    for(int x = left; x < right; x++)
+    {
+      int u = static_cast<int>(quad.source.left + (x + 0.5f - quad.dest.left) * uScale);
+      u = std::min(std::max(u, 0), texture.width - 1);
+
+      const std::uint8_t *texel = &texture.rgba[(static_cast<std::size_t>(v) * texture.width + u) * 4];
+      DrawColor color;
+      color.r = static_cast<std::uint8_t>(texel[0] * quad.color.r / 255);
+      color.g = static_cast<std::uint8_t>(texel[1] * quad.color.g / 255);
+      color.b = static_cast<std::uint8_t>(texel[2] * quad.color.b / 255);
+      color.a = static_cast<std::uint8_t>(texel[3] * quad.color.a / 255);
+      blendPixel(x, y, color);
+    }
+  }
+}
+
+// draw a text run with the built-in font, each glyph pixel scaled to
+//   characterSize / GLYPH_LINE_HEIGHT pixels
+void SoftwareRenderer::drawText(const DrawText &text)
+{
+  int scale = std::max(1, text.characterSize / GLYPH_LINE_HEIGHT);
+  int penX = static_cast<int>(std::lround(text.x));
+  int penY = static_cast<int>(std::lround(text.y));
+  for(const char *c = text.text; *c != '\0'; c++, penX += GLYPH_ADVANCE * scale)
+  {
+    const std::uint8_t *glyph = findGlyph(*c);
+    if(glyph == nullptr)
+    {
+      continue;
+    }
+    for(int row = 0; row < GLYPH_HEIGHT; row++)
+    {
+      for(int column = 0; column < GLYPH_WIDTH; column++)
+      {
+        if(glyph[row] & (0x10 >> column))
+        {
+          int x = penX + column * scale;
+          int y = penY + row * scale;
+          fillRect(x, y, x + scale, y + scale, text.color);
+        }
+      }
+    }
+  }
+}
+
+// draw a solid pixel-aligned rectangle, clipped to the frame
+void SoftwareRenderer::fillRect(int left, int top, int right, int bottom, DrawColor color)
+{
+  left = std::max(left, 0);
+  top = std::max(top, 0);
+  right = std::min(right, width);
+  bottom = std::min(bottom, height);
+  for(int y = top; y < bottom; y++)
+  {
+    for(int x = left; x < right; x++)
+    {
+      blendPixel(x, y, color);
+    }
+  }
+}
+
+// blend color (straight alpha) over the pixel at x,y (must be within the frame)
+void SoftwareRenderer::blendPixel(int x, int y, DrawColor color)
+{
+  std::uint8_t *p = &pixels[(static_cast<std::size_t>(y) * width + x) * 4];
+  if(color.a == 255)
+  {
+    p[0] = color.r;
+    p[1] = color.g;
+    p[2] = color.b;
+    p[3] = 255;
+    return;
+  }
+  int alpha = color.a;
+  p[0] = static_cast<std::uint8_t>((color.r * alpha + p[0] * (255 - alpha)) / 255);
+  p[1] = static_cast<std::uint8_t>((color.g * alpha + p[1] * (255 - alpha)) / 255);
+  p[2] = static_cast<std::uint8_t>((color.b * alpha + p[2] * (255 - alpha)) / 255);
+  p[3] = static_cast<std::uint8_t>(alpha + p[3] * (255 - alpha) / 255);
+}
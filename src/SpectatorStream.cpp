@@ -0,0 +1,553 @@
+#include <algorithm>
+#include <cstring>
+#include "SpectatorStream.h"
+
+namespace
+{
+  const std::size_t HEADER_SIZE = 5;	// type + frame
+  const std::size_t PACKED_CELLS_SIZE = (SpectatorView::CELL_COUNT + 1) / 2;
+  const std::size_t KEYFRAME_SIZE = HEADER_SIZE + PACKED_CELLS_SIZE + 4 + 1 + 4;
+
+  void writeUint32(SpectatorFrame &out, std::uint32_t value)
+  {
+    for(int i = 0; i < 4; i++)
+    {
+      out.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
+    }
+  }
+
+  std::uint32_t readUint32(const std::uint8_t *data)
+  {
+    std::uint32_t value = 0;
+    for(int i = 0; i < 4; i++)
+    {
+      value |= static_cast<std::uint32_t>(data[i]) << (8 * i);
+    }
+    return value;
+  }
+
+  // remove a row of cells the same way Gameboard::removeRow() does
+  void removeCellRow(std::uint8_t cells[], int rowIndex)
+  {
+    for(int y = rowIndex; y > 0; y--)
+    {
+      std::memcpy(cells + y * Gameboard::MAX_X, cells + (y - 1) * Gameboard::MAX_X, Gameboard::MAX_X);
+    }
+    std::memset(cells, 0, Gameboard::MAX_X);
+  }
+}
+
+// SpectatorView ==================================================
+
+// capture the visible state of an engine (captureCells() + capturePieces())
+void SpectatorView::capture(const TetrisEngine &engine)
+{
+  captureCells(engine.getBoard());
+  capturePieces(engine);
+}
+
+// capture every board cell
+void SpectatorView::captureCells(const Gameboard &board)
+{
+  for(int y = 0; y < Gameboard::MAX_Y; y++)
+  {
+    for(int x = 0; x < Gameboard::MAX_X; x++)
+    {
+      cells[y * Gameboard::MAX_X + x] = static_cast<std::uint8_t>(board.getContent(x, y) + 1);
+    }
+  }
+}
+
+// capture the falling & next pieces, and the score
+void SpectatorView::capturePieces(const TetrisEngine &engine)
+{
+  const GridTetromino &piece = engine.getCurrentShape();
+  shape = static_cast<std::uint8_t>(piece.getShape());
+  rotation = static_cast<std::uint8_t>(piece.getRotation());
+  x = piece.getGridLoc().getX();
+  y = piece.getGridLoc().getY();
+  nextShape = static_cast<std::uint8_t>(engine.getNextShape().getShape());
+  score = engine.getScore();
+}
+
+// apply one change from a Gameboard's change journal to the cells
+void SpectatorView::applyChange(const BoardChange &change)
+{
+  switch(change.type)
+  {
+    case BoardChange::CELL_SET: cells[change.y * Gameboard::MAX_X + change.x] = static_cast<std::uint8_t>(change.content + 1); break;
+    case BoardChange::ROW_REMOVED: removeCellRow(cells, change.y); break;
+    case BoardChange::BOARD_EMPTIED: std::memset(cells, 0, sizeof(cells)); break;
+  }
+}
+
+// the board content at x,y (Gameboard::EMPTY_BLOCK or a TetColor)
+int SpectatorView::getContent(int x, int y) const
+{
+  return cells[y * Gameboard::MAX_X + x] - 1;
+}
+
+// rebuild the falling piece (for drawing)
+GridTetromino SpectatorView::getCurrentShape() const
+{
+  GridTetromino piece;
+  piece.setShape(TetShape(shape));
+  for(int i = 0; i < rotation; i++)
+  {
+    piece.rotateClockwise();
+  }
+  piece.setGridLoc(x, y);
+  return piece;
+}
+
+// SpectatorEncoder ===============================================
+
+// constructor
+//   keyframeInterval: frames between keyframes (the first frame is always one)
+SpectatorEncoder::SpectatorEncoder(int keyframeInterval)
+:keyframeInterval(keyframeInterval)
+{
+}
+
+// encode the current state of a game as the next frame
+SpectatorFramePtr SpectatorEncoder::encode(const TetrisEngine &engine)
+{
+  const Gameboard &board = engine.getBoard();
+
+  // the journal holds exactly one step() of changes: if we saw the step before
+  // it, apply the journal instead of scanning the board
+  bool useJournal = haveEncoded && engine.getFrame() == lastEngineFrame + 1 && !board.haveChangesOverflowed();
+  if(useJournal)
+  {
+    for(int i = 0; i < board.getChangeCount(); i++)
+    {
+      current.applyChange(board.getChange(i));
+    }
+  }
+  else
+  {
+    current.captureCells(board);
+  }
+  current.capturePieces(engine);
+  current.frame = previous.frame + 1;
+  haveEncoded = true;
+  lastEngineFrame = engine.getFrame();
+
+  std::shared_ptr<SpectatorFrame> out = std::make_shared<SpectatorFrame>();
+  out->reserve(KEYFRAME_SIZE);
+
+  bool keyframe = keyframeRequested || framesSinceKeyframe >= keyframeInterval;
+  if(!keyframe && !(useJournal ? writeJournalDelta(board, *out) : writeDelta(*out)))
+  {
+    keyframe = true;	// the delta would be bigger than a keyframe
+  }
+  if(keyframe)
+  {
+    out->clear();
+    writeKeyframe(*out);
+    framesSinceKeyframe = 0;
+    keyframeRequested = false;
+  }
+  framesSinceKeyframe++;
+
+  previous = current;
+  return out;
+}
+
+// make the next encode() a keyframe
+void SpectatorEncoder::requestKeyframe()
+{
+  keyframeRequested = true;
+}
+
+// write a full keyframe of the current view
+void SpectatorEncoder::writeKeyframe(SpectatorFrame &out) const
+{
+  out.push_back(KEYFRAME);
+  writeUint32(out, current.frame);
+  for(int i = 0; i < SpectatorView::CELL_COUNT; i += 2)
+  {
+    std::uint8_t high = (i + 1 < SpectatorView::CELL_COUNT) ? current.cells[i + 1] : 0;
+    out.push_back(static_cast<std::uint8_t>(current.cells[i] | (high << 4)));
+  }
+  out.push_back(current.shape);
+  out.push_back(current.rotation);
+  out.push_back(static_cast<std::uint8_t>(static_cast<std::int8_t>(current.x)));
+  out.push_back(static_cast<std::uint8_t>(static_cast<std::int8_t>(current.y)));
+  out.push_back(current.nextShape);
+  writeUint32(out, static_cast<std::uint32_t>(current.score));
+}
+
+// write the ops that turn 'previous' into 'current'.
+//   return false if a keyframe would be smaller.
+bool SpectatorEncoder::writeDelta(SpectatorFrame &out) const
+{
+  out.push_back(DELTA);
+  writeUint32(out, current.frame);
+
+  // rows: only worth sending if they save more cell updates than they cost
+  int removedRows[MAX_ROWS_REMOVED];
+  int removedCount = guessRemovedRows(removedRows);
+  std::uint8_t shifted[SpectatorView::CELL_COUNT];
+  std::memcpy(shifted, previous.cells, sizeof(shifted));
+  for(int i = 0; i < removedCount; i++)
+  {
+    removeCellRow(shifted, removedRows[i]);
+  }
+
+  int plainChanges = 0;
+  int shiftedChanges = 0;
+  for(int i = 0; i < SpectatorView::CELL_COUNT; i++)
+  {
+    plainChanges += previous.cells[i] != current.cells[i] ? 1 : 0;
+    shiftedChanges += shifted[i] != current.cells[i] ? 1 : 0;
+  }
+
+  const std::uint8_t *base = previous.cells;
+  int changes = plainChanges;
+  if(removedCount > 0 && 2 + removedCount + 2 * shiftedChanges < 2 * plainChanges)
+  {
+    out.push_back(OP_ROWS_REMOVED);
+    out.push_back(static_cast<std::uint8_t>(removedCount));
+    for(int i = 0; i < removedCount; i++)
+    {
+      out.push_back(static_cast<std::uint8_t>(removedRows[i]));
+    }
+    base = shifted;
+    changes = shiftedChanges;
+  }
+
+  if(HEADER_SIZE + 2 + 2 * changes > KEYFRAME_SIZE)
+  {
+    return false;
+  }
+  if(changes > 0)
+  {
+    out.push_back(OP_CELLS);
+    out.push_back(static_cast<std::uint8_t>(changes));
+    for(int i = 0; i < SpectatorView::CELL_COUNT; i++)
+    {
+      if(base[i] != current.cells[i])
+      {
+        out.push_back(static_cast<std::uint8_t>(i));
+        out.push_back(current.cells[i]);
+      }
+    }
+  }
+
+  writePieceOps(out);
+
+  return out.size() <= KEYFRAME_SIZE;
+}
+
+// write the ops that turn 'previous' into 'current', from the board's
+//   change journal (which must hold exactly the changes since 'previous').
+//   Runs of cell sets & row removals become one op each, in journal order.
+//   return false if a keyframe would be smaller.
+bool SpectatorEncoder::writeJournalDelta(const Gameboard &board, SpectatorFrame &out) const
+{
+  out.push_back(DELTA);
+  writeUint32(out, current.frame);
+
+  int count = board.getChangeCount();
+  for(int i = 0; i < count; )
+  {
+    BoardChange::Type type = board.getChange(i).type;
+    if(type == BoardChange::BOARD_EMPTIED)
+    {
+      out.push_back(OP_EMPTY);
+      i++;
+      continue;
+    }
+
+    int run = 1;
+    while(i + run < count && board.getChange(i + run).type == type && run < 255)
+    {
+      run++;
+    }
+    out.push_back(type == BoardChange::CELL_SET ? OP_CELLS : OP_ROWS_REMOVED);
+    out.push_back(static_cast<std::uint8_t>(run));
+    for(int n = 0; n < run; n++, i++)
+    {
+      const BoardChange &change = board.getChange(i);
+      if(type == BoardChange::CELL_SET)
+      {
+        out.push_back(static_cast<std::uint8_t>(change.y * Gameboard::MAX_X + change.x));
+        out.push_back(static_cast<std::uint8_t>(change.content + 1));
+      }
+      else
+      {
+        out.push_back(static_cast<std::uint8_t>(change.y));
+      }
+    }
+  }
+
+  writePieceOps(out);
+  return out.size() <= KEYFRAME_SIZE;
+}
+
+// write the OP_PIECE, OP_NEXT & OP_SCORE ops for whatever changed
+void SpectatorEncoder::writePieceOps(SpectatorFrame &out) const
+{
+  // the active piece: only what changed, positions as offsets from the last frame
+  std::uint8_t flags = 0;
+  flags |= current.shape != previous.shape ? PIECE_SHAPE : 0;
+  flags |= current.rotation != previous.rotation ? PIECE_ROTATION : 0;
+  flags |= current.x != previous.x ? PIECE_X : 0;
+  flags |= current.y != previous.y ? PIECE_Y : 0;
+  if(flags)
+  {
+    out.push_back(OP_PIECE);
+    out.push_back(flags);
+    if(flags & PIECE_SHAPE) out.push_back(current.shape);
+    if(flags & PIECE_ROTATION) out.push_back(current.rotation);
+    if(flags & PIECE_X) out.push_back(static_cast<std::uint8_t>(static_cast<std::int8_t>(current.x - previous.x)));
+    if(flags & PIECE_Y) out.push_back(static_cast<std::uint8_t>(static_cast<std::int8_t>(current.y - previous.y)));
+  }
+
+  if(current.nextShape != previous.nextShape)
+  {
+    out.push_back(OP_NEXT);
+    out.push_back(current.nextShape);
+  }
+  if(current.score != previous.score)
+  {
+    out.push_back(OP_SCORE);
+    writeUint32(out, static_cast<std::uint32_t>(current.score));
+  }
+}
+
+// guess which rows of 'previous' were removed to reach 'current'
+//   (locking only adds cells, clearing removes whole rows)
+//   Walk both boards bottom up: a previous row that the current row can't have
+//   grown from must have been removed.  A wrong guess only costs bytes - any
+//   remaining difference is still sent as cells.
+int SpectatorEncoder::guessRemovedRows(int removedRows[MAX_ROWS_REMOVED]) const
+{
+  int count = 0;
+  int y = Gameboard::MAX_Y - 1;
+  for(int p = Gameboard::MAX_Y - 1; p >= 0 && y >= 0; p--)
+  {
+    bool grewFrom = true;
+    for(int x = 0; x < Gameboard::MAX_X && grewFrom; x++)
+    {
+      std::uint8_t before = previous.cells[p * Gameboard::MAX_X + x];
+      grewFrom = before == 0 || before == current.cells[y * Gameboard::MAX_X + x];
+    }
+
+    if(grewFrom)
+    {
+      y--;
+    }
+    else if(count < MAX_ROWS_REMOVED)
+    {
+      removedRows[count++] = p;
+    }
+    else
+    {
+      return 0;	// not a row clear (eg: the game was reset)
+    }
+  }
+
+  // removeRows() wants them top to bottom
+  std::reverse(removedRows, removedRows + count);
+  return count;
+}
+
+// SpectatorDecoder ===============================================
+
+// apply one frame to the view.
+//   return false if the frame is malformed, or is a delta and no keyframe
+//   has been seen yet (the frame is then ignored).
+bool SpectatorDecoder::apply(const SpectatorFrame &frame)
+{
+  if(frame.size() < HEADER_SIZE)
+  {
+    return false;
+  }
+  const std::uint8_t *data = frame.data();
+  std::size_t size = frame.size();
+
+  if(data[0] == SpectatorEncoder::KEYFRAME)
+  {
+    if(size != KEYFRAME_SIZE)
+    {
+      return false;
+    }
+    const std::uint8_t *p = data + HEADER_SIZE;
+    for(int i = 0; i < SpectatorView::CELL_COUNT; i++)
+    {
+      view.cells[i] = (i % 2 == 0) ? (p[i / 2] & 0x0F) : (p[i / 2] >> 4);
+    }
+    p += PACKED_CELLS_SIZE;
+    view.shape = p[0];
+    view.rotation = p[1];
+    view.x = static_cast<std::int8_t>(p[2]);
+    view.y = static_cast<std::int8_t>(p[3]);
+    view.nextShape = p[4];
+    view.score = static_cast<std::int32_t>(readUint32(p + 5));
+    view.frame = readUint32(data + 1);
+    keyframeSeen = true;
+    return true;
+  }
+
+  if(data[0] != SpectatorEncoder::DELTA || !keyframeSeen)
+  {
+    return false;
+  }
+
+  // decode into a copy, so a malformed frame leaves the view untouched
+  SpectatorView next = view;
+  next.frame = readUint32(data + 1);
+  std::size_t i = HEADER_SIZE;
+  while(i < size)
+  {
+    std::uint8_t op = data[i++];
+    if(op == SpectatorEncoder::OP_ROWS_REMOVED || op == SpectatorEncoder::OP_CELLS)
+    {
+      if(i >= size)
+      {
+        return false;
+      }
+      std::size_t count = data[i++];
+      std::size_t entrySize = (op == SpectatorEncoder::OP_CELLS) ? 2 : 1;
+      if(i + count * entrySize > size)
+      {
+        return false;
+      }
+      for(std::size_t n = 0; n < count; n++, i += entrySize)
+      {
+        if(op == SpectatorEncoder::OP_CELLS)
+        {
+          if(data[i] >= SpectatorView::CELL_COUNT)
+          {
+            return false;
+          }
+          next.cells[data[i]] = data[i + 1];
+        }
+        else
+        {
+          if(data[i] >= Gameboard::MAX_Y)
+          {
+            return false;
+          }
+          removeCellRow(next.cells, data[i]);
+        }
+      }
+    }
+    else if(op == SpectatorEncoder::OP_PIECE)
+    {
+      if(i >= size)
+      {
+        return false;
+      }
+      std::uint8_t flags = data[i++];
+      int fields = ((flags & SpectatorEncoder::PIECE_SHAPE) ? 1 : 0) + ((flags & SpectatorEncoder::PIECE_ROTATION) ? 1 : 0)
+                 + ((flags & SpectatorEncoder::PIECE_X) ? 1 : 0) + ((flags & SpectatorEncoder::PIECE_Y) ? 1 : 0);
+      if(i + fields > size)
+      {
+        return false;
+      }
+      if(flags & SpectatorEncoder::PIECE_SHAPE) next.shape = data[i++];
+      if(flags & SpectatorEncoder::PIECE_ROTATION) next.rotation = data[i++];
+      if(flags & SpectatorEncoder::PIECE_X) next.x += static_cast<std::int8_t>(data[i++]);
+      if(flags & SpectatorEncoder::PIECE_Y) next.y += static_cast<std::int8_t>(data[i++]);
+    }
+    else if(op == SpectatorEncoder::OP_EMPTY)
+    {
+      std::memset(next.cells, 0, sizeof(next.cells));
+    }
+    else if(op == SpectatorEncoder::OP_NEXT && i < size)
+    {
+      next.nextShape = data[i++];
+    }
+    else if(op == SpectatorEncoder::OP_SCORE && i + 4 <= size)
+    {
+      next.score = static_cast<std::int32_t>(readUint32(data + i));
+      i += 4;
+    }
+    else
+    {
+      return false;
+    }
+  }
+
+  view = next;
+  return true;
+}
+
+bool SpectatorDecoder::hasKeyframe() const
+{
+  return keyframeSeen;
+}
+
+const SpectatorView& SpectatorDecoder::getView() const
+{
+  return view;
+}
+
+// SpectatorBroadcaster ===========================================
+
+// constructor
+//   keyframeInterval: frames between keyframes
+SpectatorBroadcaster::SpectatorBroadcaster(int keyframeInterval)
+:encoder(keyframeInterval)
+{
+}
+
+// encode this frame of the game once and queue it for every subscriber
+SpectatorFramePtr SpectatorBroadcaster::publish(const TetrisEngine &engine)
+{
+  SpectatorFramePtr frame = encoder.encode(engine);
+  if((*frame)[0] == SpectatorEncoder::KEYFRAME)
+  {
+    lastKeyframe = frame;
+    deltasSinceKeyframe.clear();
+  }
+  else
+  {
+    deltasSinceKeyframe.push_back(frame);
+  }
+
+  for(auto &queue : queues)
+  {
+    queue.second.push_back(frame);
+  }
+  return frame;
+}
+
+// add a subscriber, queueing the latest keyframe & the deltas since it.
+//   return the subscriber's id
+int SpectatorBroadcaster::subscribe()
+{
+  int id = nextId++;
+  std::vector<SpectatorFramePtr> &queue = queues[id];
+  if(lastKeyframe)
+  {
+    queue.push_back(lastKeyframe);
+    queue.insert(queue.end(), deltasSinceKeyframe.begin(), deltasSinceKeyframe.end());
+  }
+  return id;
+}
+
+void SpectatorBroadcaster::unsubscribe(int id)
+{
+  queues.erase(id);
+}
+
+// move the frames queued for a subscriber to the end of 'out'
+void SpectatorBroadcaster::takeFrames(int id, std::vector<SpectatorFramePtr> &out)
+{
+  auto found = queues.find(id);
+  if(found == queues.end())
+  {
+    return;
+  }
+  out.insert(out.end(), found->second.begin(), found->second.end());
+  found->second.clear();
+}
+
+int SpectatorBroadcaster::getSubscriberCount() const
+{
+  return static_cast<int>(queues.size());
+}
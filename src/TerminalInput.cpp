@@ -0,0 +1,143 @@
+#include "TerminalInput.h"
+#ifdef _WIN32
+#include <conio.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+// constructor: switch the terminal to raw, non-blocking input
+TerminalInput::TerminalInput()
+{
+#ifdef _WIN32
+  HANDLE input = GetStdHandle(STD_INPUT_HANDLE);
+  HANDLE output = GetStdHandle(STD_OUTPUT_HANDLE);
+  DWORD inputMode, outputMode;
+  if(GetConsoleMode(input, &inputMode) && GetConsoleMode(output, &outputMode))
+  {
+    savedInputMode = inputMode;
+    savedOutputMode = outputMode;
+    SetConsoleMode(input, inputMode & ~(ENABLE_LINE_INPUT | ENABLE_ECHO_INPUT));
+    SetConsoleMode(output, outputMode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+    raw = true;
+  }
+#else
+  if(isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &savedState) == 0)
+  {
+    struct termios rawState = savedState;
+    rawState.c_lflag &= ~(ICANON | ECHO | ISIG);	// key by key, no echo, Ctrl-C is a key
+    rawState.c_iflag &= ~(IXON | ICRNL);
+    rawState.c_cc[VMIN] = 0;		// read() returns at once, even with nothing to read
+    rawState.c_cc[VTIME] = 0;
+    raw = tcsetattr(STDIN_FILENO, TCSAFLUSH, &rawState) == 0;
+  }
+#endif
+}
+
+// destructor: give the terminal back as it was
+TerminalInput::~TerminalInput()
+{
+  if(!raw)
+  {
+    return;
+  }
+#ifdef _WIN32
+  SetConsoleMode(GetStdHandle(STD_INPUT_HANDLE), savedInputMode);
+  SetConsoleMode(GetStdHandle(STD_OUTPUT_HANDLE), savedOutputMode);
+#else
+  tcsetattr(STDIN_FILENO, TCSAFLUSH, &savedState);
+#endif
+}
+
+// did the terminal switch to raw mode? (false: not a terminal)
+bool TerminalInput::isRaw() const
+{
+  return raw;
+}
+
+// read the keys pressed since the last call (never blocks)
+//   return how many were put in keys (at most MAX_KEYS)
+int TerminalInput::readKeys(TerminalKey keys[MAX_KEYS])
+{
+  char bytes[64];
+  int count = 0;
+#ifdef _WIN32
+  while(count < static_cast<int>(sizeof(bytes)) && _kbhit())
+  {
+    bytes[count++] = static_cast<char>(_getch());
+  }
+#else
+  if(raw)
+  {
+    ssize_t bytesRead = read(STDIN_FILENO, bytes, sizeof(bytes));
+    count = bytesRead > 0 ? static_cast<int>(bytesRead) : 0;
+  }
+#endif
+  return parseKeys(pending, bytes, count, keys, MAX_KEYS);
+}
+
+// turn bytes read from the terminal into keys.
+//   pending holds bytes of an incomplete escape sequence between calls.
+//   return how many keys were put in keys (at most maxKeys)
+int TerminalInput::parseKeys(std::string &pending, const char *bytes, int count, TerminalKey keys[], int maxKeys)
+{
+  pending.append(bytes, count);
+
+  int keyCount = 0;
+  std::size_t i = 0;
+  while(i < pending.size() && keyCount < maxKeys)
+  {
+    unsigned char c = static_cast<unsigned char>(pending[i]);
+    TerminalKey key = KEY_NONE;
+    std::size_t length = 1;
+
+    if(c == 0x1B || c == 0 || c == 224)
+    {
+      // ESC [ A..D (POSIX) or 0/224 + scan code (Windows)
+      bool posix = c == 0x1B;
+      std::size_t needed = posix ? 3 : 2;
+      if(pending.size() - i < needed)
+      {
+        if(posix && pending.size() - i == 2 && pending[i + 1] != '[')
+        {
+          i++;		// a lone ESC followed by something else: drop the ESC
+          continue;
+        }
+        break;		// wait for the rest of the sequence
+      }
+      if(posix && pending[i + 1] != '[')
+      {
+        i++;
+        continue;
+      }
+      length = needed;
+      const char codes[2][4] = { { 72, 80, 77, 75 }, { 'A', 'B', 'C', 'D' } };	// up, down, right, left
+      const TerminalKey arrows[4] = { KEY_UP, KEY_DOWN, KEY_RIGHT, KEY_LEFT };
+      for(int arrow = 0; arrow < 4; arrow++)
+      {
+        if(pending[i + needed - 1] == codes[posix ? 1 : 0][arrow])
+        {
+          key = arrows[arrow];
+        }
+      }
+    }
+    else
+    {
+      switch(c)
+      {
+        case ' ': key = KEY_SPACE; break;
+        case 'r': case 'R': key = KEY_ROTATE; break;
+        case 'q': case 'Q': case 3: key = KEY_QUIT; break;	// 3 = Ctrl-C
+        default: break;
+      }
+    }
+
+    if(key != KEY_NONE)
+    {
+      keys[keyCount++] = key;
+    }
+    i += length;
+  }
+  pending.erase(0, i);
+  return keyCount;
+}
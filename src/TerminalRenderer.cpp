@@ -0,0 +1,186 @@
+#include <cstdio>
+#include "TerminalRenderer.h"
+
+namespace
+{
+  // the board's top left on the screen (inside its border), in characters
+  const int BOARD_LEFT = 2;
+  const int BOARD_TOP = 3;
+  const int NEXT_LEFT = BOARD_LEFT + Gameboard::MAX_X * 2 + 6;	// the next shape's origin
+  const int NEXT_TOP = BOARD_TOP + 3;								//   (its blocks reach 1 left & 1 up)
+
+  // SGR (select graphic rendition) sequence for each CellColor, then each TetColor
+  const char *COLOR_SEQUENCES[] = {
+    "\x1b[0m",				// COLOR_DEFAULT
+    "\x1b[0;100m",			// COLOR_BORDER (grey)
+    "\x1b[0;41m",			// RED
+    "\x1b[0;48;5;208m",	// ORANGE (256 color)
+    "\x1b[0;43m",			// YELLOW
+    "\x1b[0;42m",			// GREEN
+    "\x1b[0;46m",			// BLUE_LIGHT
+    "\x1b[0;44m",			// BLUE_DARK
+    "\x1b[0;45m"				// PURPLE
+  };
+}
+
+// constructor
+TerminalRenderer::TerminalRenderer()
+{
+}
+
+// draw a game into the next screen: score, board, falling & next shapes
+void TerminalRenderer::compose(const TetrisEngine &engine)
+{
+  for(int y = 0; y < HEIGHT; y++)
+  {
+    for(int x = 0; x < WIDTH; x++)
+    {
+      next[y][x] = Cell();
+    }
+  }
+
+  char score[32];
+  std::snprintf(score, sizeof(score), "Score: %d", engine.getScore());
+  putText(BOARD_LEFT, 1, score);
+  putText(NEXT_LEFT - 2, NEXT_TOP - 3, "Next:");
+
+  // the border
+  for(int y = BOARD_TOP - 1; y <= BOARD_TOP + Gameboard::MAX_Y; y++)
+  {
+    putBlock(BOARD_LEFT - 2, y, COLOR_BORDER);
+    putBlock(BOARD_LEFT + Gameboard::MAX_X * 2, y, COLOR_BORDER);
+  }
+  for(int x = 0; x < Gameboard::MAX_X; x++)
+  {
+    putBlock(BOARD_LEFT + x * 2, BOARD_TOP - 1, COLOR_BORDER);
+    putBlock(BOARD_LEFT + x * 2, BOARD_TOP + Gameboard::MAX_Y, COLOR_BORDER);
+  }
+
+  // the locked blocks
+  const Gameboard &board = engine.getBoard();
+  for(int y = 0; y < Gameboard::MAX_Y; y++)
+  {
+    for(int x = 0; x < Gameboard::MAX_X; x++)
+    {
+      int content = board.getContent(x, y);
+      if(content != Gameboard::EMPTY_BLOCK)
+      {
+        putBlock(BOARD_LEFT + x * 2, BOARD_TOP + y, static_cast<std::uint8_t>(COLOR_TETROMINO + content));
+      }
+    }
+  }
+
+  // the falling shape (only the part inside the board) and the next shape
+  const GridTetromino &current = engine.getCurrentShape();
+  for(const Point &p : current.getBlockLocsMappedToGrid())
+  {
+    if(p.getY() >= 0)
+    {
+      putBlock(BOARD_LEFT + p.getX() * 2, BOARD_TOP + p.getY(), static_cast<std::uint8_t>(COLOR_TETROMINO + current.getColor()));
+    }
+  }
+  const GridTetromino &nextShape = engine.getNextShape();
+  for(const Point &p : nextShape.getBlockLocsMappedToGrid())
+  {
+    putBlock(NEXT_LEFT + p.getX() * 2, NEXT_TOP + p.getY(), static_cast<std::uint8_t>(COLOR_TETROMINO + nextShape.getColor()));
+  }
+}
+
+// append the escape sequences that turn the shown screen into the next
+//   screen to out (nothing if they are the same), and remember it as shown
+void TerminalRenderer::writeUpdate(std::string &out)
+{
+  int lastColor = -1;		// unknown
+  int cursorX = -1;
+  int cursorY = -1;
+  if(!shownValid)
+  {
+    out += "\x1b[?25l\x1b[0m\x1b[2J";	// hide the cursor & clear
+    lastColor = COLOR_DEFAULT;
+    for(int y = 0; y < HEIGHT; y++)
+    {
+      for(int x = 0; x < WIDTH; x++)
+      {
+        shown[y][x] = Cell();	// what the clear left
+      }
+    }
+    shownValid = true;
+  }
+
+  for(int y = 0; y < HEIGHT; y++)
+  {
+    for(int x = 0; x < WIDTH; x++)
+    {
+      const Cell &cell = next[y][x];
+      if(!(cell != shown[y][x]))
+      {
+        continue;
+      }
+      if(x != cursorX || y != cursorY)
+      {
+        char move[16];
+        std::snprintf(move, sizeof(move), "\x1b[%d;%dH", y + 1, x + 1);
+        out += move;
+      }
+      if(cell.color != lastColor)
+      {
+        out += COLOR_SEQUENCES[cell.color];
+        lastColor = cell.color;
+      }
+      out += cell.character;
+      cursorX = x + 1;
+      cursorY = y;
+      shown[y][x] = cell;
+    }
+  }
+
+  // leave the terminal with its default colors
+  if(lastColor > COLOR_DEFAULT)
+  {
+    out += COLOR_SEQUENCES[COLOR_DEFAULT];
+  }
+}
+
+// make the next writeUpdate() clear the terminal & redraw everything
+//   (eg: after the terminal was resized or written to by something else)
+void TerminalRenderer::invalidate()
+{
+  shownValid = false;
+}
+
+// the escape sequences that give the terminal back as we found it
+//   (default colors, cursor shown, below the game)
+std::string TerminalRenderer::getRestoreSequence()
+{
+  return "\x1b[0m\x1b[?25h\x1b[" + std::to_string(HEIGHT + 1) + ";1H\n";
+}
+
+// draw text into the next screen (default colors, clipped to the screen)
+void TerminalRenderer::putText(int x, int y, const char *text)
+{
+  for(; *text != '\0' && x < WIDTH; text++, x++)
+  {
+    if(x >= 0 && y >= 0 && y < HEIGHT)
+    {
+      next[y][x].character = *text;
+      next[y][x].color = COLOR_DEFAULT;
+    }
+  }
+}
+
+// draw a board-sized block (2 characters) into the next screen
+void TerminalRenderer::putBlock(int x, int y, std::uint8_t color)
+{
+  if(y < 0 || y >= HEIGHT)
+  {
+    return;
+  }
+  for(int i = x; i < x + 2; i++)
+  {
+    if(i >= 0 && i < WIDTH)
+    {
+      next[y][i].character = ' ';
+      next[y][i].color = color;
+    }
+  }
+}
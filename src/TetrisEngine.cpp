@@ -0,0 +1,630 @@
+#include <algorithm>
+#include <cstring>
+#include "Profiler.h"
+#include "TetrisEngine.h"
+
+namespace
+{
+  // add a value to an FNV-1a hash, a byte at a time (low byte first)
+  void hashValue(std::uint64_t &hash, std::uint64_t value, int bytes)
+  {
+    for(int i = 0; i < bytes; i++, value >>= 8)
+    {
+      hash ^= value & 0xFF;
+      hash *= 0x100000001B3ull;
+    }
+  }
+
+  void hashDouble(std::uint64_t &hash, double value)
+  {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    hashValue(hash, bits, 8);
+  }
+}
+
+TetrisEngine::TetrisEngine(std::uint32_t seed)
+{
+  // xorshift32 gets stuck on 0, so nudge a zero seed
+  rngState = (seed != 0) ? seed : 0x9E3779B9u;
+
+  reset();
+}
+
+// reset everything for a new game (use existing functions)
+//  - set the score to 0
+//  - call determineSecondsPerTick() to determine the tick rate.
+//  - clear the gameboard,
+//  - pick & spawn next shape
+//  - pick next shape again (for the "on-deck" shape)
+void TetrisEngine::reset()
+{
+  score = 0;
+  pendingGarbage = 0;
+  determineSecondsPerTick();
+
+  board.empty();
+
+  pickNextShape();
+  spawnNextShape();
+
+  pickNextShape();
+}
+
+// handle a single button press (rotate, left, right, down, drop)
+void TetrisEngine::onButtonPressed(InputButton button)
+{
+  switch(button)
+  {
+    case BUTTON_ROTATE: if(attemptRotate(currentShape)) events |= GAME_EVENT_ROTATED; break; // Rotate
+    case BUTTON_LEFT: attemptMove(currentShape, -1, 0); break; // Move left
+    case BUTTON_RIGHT: attemptMove(currentShape, 1, 0); break; // Move right
+    case BUTTON_DOWN: if(!attemptMove(currentShape, 0, 1)) lock(currentShape); break; // Move down and lock if no further movement is possible
+    case BUTTON_DROP: drop(currentShape); lock(currentShape); break; // Drop and lock
+  };
+}
+
+// called every game loop to handle ticks & tetromino placement (locking)
+void TetrisEngine::processGameLoop(double secondsSinceLastLoop)
+{
+  PROFILE_SCOPE("processGameLoop");
+  secondsSinceLastTick += secondsSinceLastLoop;
+  if(secondsSinceLastTick >= secondsPerTick)
+  {
+    tick();
+    secondsSinceLastTick = 0.0;
+  }
+}
+
+// advance the game by exactly one simulation frame (SECONDS_PER_FRAME).
+//   - the board's change journal & the events are cleared, so afterwards
+//     they hold exactly what this frame changed & what happened in it
+//   - buttons in heldButtons that were not held last frame are pressed
+//   - buttons held longer auto-repeat (see AutoRepeatSettings)
+//   - then processGameLoop() runs for one frame
+void TetrisEngine::step(InputMask heldButtons)
+{
+  PROFILE_SCOPE("step");
+  board.clearChanges();
+  if(boardChangesInvalidated)
+  {
+    // consumers haven't seen the invalidation yet, keep it for this frame
+    board.invalidateChanges();
+    boardChangesInvalidated = false;
+  }
+  events = 0;
+  clearedRows = 0;
+
+  heldButtons &= ALL_BUTTONS;
+  InputMask pressed = heldButtons & ~previousButtons;
+  previousButtons = heldButtons;
+
+  // press in a fixed order so re-simulation always matches
+  for(int bit = 1; bit <= BUTTON_DROP; bit <<= 1)
+  {
+    if(pressed & bit)
+    {
+      onButtonPressed(InputButton(bit));
+    }
+  }
+  autoRepeat(heldButtons, pressed);
+
+  processGameLoop(SECONDS_PER_FRAME);
+  frame++;
+}
+
+// the auto-repeat used by step() (the values are clamped to their minimums)
+void TetrisEngine::setAutoRepeat(const AutoRepeatSettings &settings)
+{
+  autoRepeatSettings = settings;
+  // a delay of 0 would repeat on the frame of the press itself
+  autoRepeatSettings.delayFrames = std::max(1, settings.delayFrames);
+  autoRepeatSettings.repeatFrames = std::max(0, settings.repeatFrames);
+  autoRepeatSettings.softDropFrames = std::max(1, settings.softDropFrames);
+}
+
+const AutoRepeatSettings& TetrisEngine::getAutoRepeat() const
+{
+  return autoRepeatSettings;
+}
+
+// A tick() forces the currentShape to move (if there were no tick,
+// the currentShape would float in position forever). This should
+// call attemptMove() on the currentShape.  If not successful, lock()
+// the currentShape (it can move no further), and record the fact that a
+// shape was placed (using shapePlacedSinceLastGameLoop)
+void TetrisEngine::tick()
+{
+  PROFILE_SCOPE("tick");
+  if(!attemptMove(currentShape, 0, 1))
+  {
+    lock(currentShape);
+    shapePlacedSinceLastGameLoop = true;
+  }
+  if(shapePlacedSinceLastGameLoop)
+  {
+    if(!spawnNextShape())
+    {
+      events |= GAME_EVENT_GAME_OVER;
+      reset();
+    }
+    else
+    {
+      pickNextShape();
+
+      int completedRows = board.removeCompletedRows();
+      score += completedRows * 2.25;
+      if(completedRows > 0)
+      {
+        events |= GAME_EVENT_ROWS_CLEARED;
+        clearedRows += completedRows;
+      }
+      else if(pendingGarbage > 0 && !raiseGarbage())
+      {
+        events |= GAME_EVENT_GAME_OVER;
+        reset();
+      }
+
+      determineSecondsPerTick();
+    }
+
+    shapePlacedSinceLastGameLoop = false;
+  }
+}
+
+const Gameboard& TetrisEngine::getBoard() const
+{
+  return board;
+}
+
+const GridTetromino& TetrisEngine::getCurrentShape() const
+{
+  return currentShape;
+}
+
+const GridTetromino& TetrisEngine::getNextShape() const
+{
+  return nextShape;
+}
+
+int TetrisEngine::getScore() const
+{
+  return score;
+}
+
+std::uint32_t TetrisEngine::getFrame() const
+{
+  return frame;
+}
+
+// the number of shapes spawned since construction (the current shape's number)
+std::uint32_t TetrisEngine::getShapeCount() const
+{
+  return shapeCount;
+}
+
+// the shape last locked onto the board (where it was locked)
+const GridTetromino& TetrisEngine::getLastLocked() const
+{
+  return lastLocked;
+}
+
+// how far the time to the next tick has gone (0 just after a tick, 1 when the next is due),
+//   secondsAhead after the last processGameLoop() (for drawing between simulation frames)
+double TetrisEngine::getTickProgress(double secondsAhead) const
+{
+  return std::min(1.0, (secondsSinceLastTick + secondsAhead) / secondsPerTick);
+}
+
+// could the currentShape fall one more row? (false: the next tick locks it)
+bool TetrisEngine::canCurrentShapeFall() const
+{
+  GridTetromino fallen = currentShape;
+  fallen.move(0, 1);
+  return isPositionLegal(fallen);
+}
+
+// the GameEvents since the last clearEvents() (so for step() users: in the last step())
+GameEventMask TetrisEngine::getEvents() const
+{
+  return events;
+}
+
+// the rows cleared since the last clearEvents() (with GAME_EVENT_ROWS_CLEARED)
+int TetrisEngine::getClearedRows() const
+{
+  return clearedRows;
+}
+
+// forget the events (event style users: once per loop, after reading them)
+void TetrisEngine::clearEvents()
+{
+  clearedRows = 0;
+  events = 0;
+}
+
+// queue garbage rows (eg: sent by an opponent): they rise from the bottom,
+//   with a hole at holeX, the next time a shape locks without clearing a
+//   row (rows past MAX_PENDING_GARBAGE are dropped).  If the falling shape
+//   no longer fits once they have risen, the game is over.
+void TetrisEngine::queueGarbage(int rows, int holeX)
+{
+  for(int i = 0; i < rows && pendingGarbage < MAX_PENDING_GARBAGE; i++)
+  {
+    garbageHoles[pendingGarbage++] = static_cast<std::int8_t>(holeX);
+  }
+}
+
+// the garbage rows waiting to rise
+int TetrisEngine::getPendingGarbage() const
+{
+  return pendingGarbage;
+}
+
+// clear the board's change journal (event style users: once per loop,
+//   after everything that reads the journal has run)
+void TetrisEngine::clearBoardChanges()
+{
+  board.clearChanges();
+}
+
+// save the game's state, or restore a saved one (the board's change
+//   journal is invalidated: it no longer describes the board)
+//   Board contents must be in -1 to 14 (EMPTY_BLOCK & the colors are)
+EngineSnapshot TetrisEngine::saveSnapshot() const
+{
+  static_assert(sizeof(EngineSnapshot::garbageHoles) == sizeof(garbageHoles), "EngineSnapshot can't hold the garbage");
+  EngineSnapshot snapshot;
+  for(int y = 0, cell = 0; y < Gameboard::MAX_Y; y++)
+  {
+    for(int x = 0; x < Gameboard::MAX_X; x++, cell++)
+    {
+      std::uint8_t nibble = static_cast<std::uint8_t>(board.getContent(x, y) + 1) & 0x0F;
+      snapshot.cells[cell / 2] |= (cell % 2 == 0) ? nibble : static_cast<std::uint8_t>(nibble << 4);
+    }
+  }
+  snapshot.currentShape = static_cast<std::uint8_t>(currentShape.getShape());
+  snapshot.currentRotation = static_cast<std::uint8_t>(currentShape.getRotation());
+  snapshot.currentX = static_cast<std::int8_t>(currentShape.getGridLoc().getX());
+  snapshot.currentY = static_cast<std::int8_t>(currentShape.getGridLoc().getY());
+  snapshot.nextShape = static_cast<std::uint8_t>(nextShape.getShape());
+  snapshot.lastLockedShape = static_cast<std::uint8_t>(lastLocked.getShape());
+  snapshot.lastLockedRotation = static_cast<std::uint8_t>(lastLocked.getRotation());
+  snapshot.lastLockedX = static_cast<std::int8_t>(lastLocked.getGridLoc().getX());
+  snapshot.lastLockedY = static_cast<std::int8_t>(lastLocked.getGridLoc().getY());
+  snapshot.score = score;
+  snapshot.rngState = rngState;
+  snapshot.frame = frame;
+  snapshot.shapeCount = shapeCount;
+  snapshot.secondsPerTick = secondsPerTick;
+  snapshot.secondsSinceLastTick = secondsSinceLastTick;
+  snapshot.shiftHeldFrames = shiftHeldFrames;
+  snapshot.downHeldFrames = downHeldFrames;
+  snapshot.previousButtons = previousButtons;
+  snapshot.shiftButton = shiftButton;
+  snapshot.events = events;
+  snapshot.clearedRows = static_cast<std::uint8_t>(clearedRows);
+  snapshot.shapePlaced = shapePlacedSinceLastGameLoop;
+  snapshot.pendingGarbage = static_cast<std::uint8_t>(pendingGarbage);
+  std::copy(garbageHoles, garbageHoles + MAX_PENDING_GARBAGE, snapshot.garbageHoles);
+  return snapshot;
+}
+
+void TetrisEngine::restoreSnapshot(const EngineSnapshot &snapshot)
+{
+  for(int y = 0, cell = 0; y < Gameboard::MAX_Y; y++)
+  {
+    for(int x = 0; x < Gameboard::MAX_X; x++, cell++)
+    {
+      int nibble = (cell % 2 == 0) ? (snapshot.cells[cell / 2] & 0x0F) : (snapshot.cells[cell / 2] >> 4);
+      board.setContent(x, y, nibble - 1);
+    }
+  }
+  restoreShape(currentShape, snapshot.currentShape, snapshot.currentRotation, snapshot.currentX, snapshot.currentY);
+  restoreShape(nextShape, snapshot.nextShape, 0, 0, 0);
+  restoreShape(lastLocked, snapshot.lastLockedShape, snapshot.lastLockedRotation, snapshot.lastLockedX, snapshot.lastLockedY);
+  score = snapshot.score;
+  rngState = snapshot.rngState;
+  frame = snapshot.frame;
+  shapeCount = snapshot.shapeCount;
+  secondsPerTick = snapshot.secondsPerTick;
+  secondsSinceLastTick = snapshot.secondsSinceLastTick;
+  shiftHeldFrames = snapshot.shiftHeldFrames;
+  downHeldFrames = snapshot.downHeldFrames;
+  previousButtons = snapshot.previousButtons;
+  shiftButton = snapshot.shiftButton;
+  events = snapshot.events;
+  clearedRows = snapshot.clearedRows;
+  shapePlacedSinceLastGameLoop = snapshot.shapePlaced;
+  pendingGarbage = snapshot.pendingGarbage;
+  std::copy(snapshot.garbageHoles, snapshot.garbageHoles + MAX_PENDING_GARBAGE, garbageHoles);
+  invalidateBoardChanges();
+}
+
+// a 64-bit hash of the game's state (everything a snapshot holds)
+//   call it after each step() to compare games tick by tick
+//   (field by field, so the snapshot's padding isn't hashed)
+std::uint64_t TetrisEngine::getStateHash() const
+{
+  EngineSnapshot snapshot = saveSnapshot();
+  std::uint64_t hash = 0xCBF29CE484222325ull;
+  for(std::uint8_t cells : snapshot.cells)
+  {
+    hashValue(hash, cells, 1);
+  }
+  hashValue(hash, snapshot.currentShape, 1);
+  hashValue(hash, snapshot.currentRotation, 1);
+  hashValue(hash, static_cast<std::uint8_t>(snapshot.currentX), 1);
+  hashValue(hash, static_cast<std::uint8_t>(snapshot.currentY), 1);
+  hashValue(hash, snapshot.nextShape, 1);
+  hashValue(hash, snapshot.lastLockedShape, 1);
+  hashValue(hash, snapshot.lastLockedRotation, 1);
+  hashValue(hash, static_cast<std::uint8_t>(snapshot.lastLockedX), 1);
+  hashValue(hash, static_cast<std::uint8_t>(snapshot.lastLockedY), 1);
+  hashValue(hash, static_cast<std::uint32_t>(snapshot.score), 4);
+  hashValue(hash, snapshot.rngState, 4);
+  hashValue(hash, snapshot.frame, 4);
+  hashValue(hash, snapshot.shapeCount, 4);
+  hashDouble(hash, snapshot.secondsPerTick);
+  hashDouble(hash, snapshot.secondsSinceLastTick);
+  hashValue(hash, snapshot.shiftHeldFrames, 4);
+  hashValue(hash, snapshot.downHeldFrames, 4);
+  hashValue(hash, snapshot.previousButtons, sizeof(InputMask));
+  hashValue(hash, snapshot.shiftButton, sizeof(InputMask));
+  hashValue(hash, snapshot.events, sizeof(GameEventMask));
+  hashValue(hash, snapshot.clearedRows, 1);
+  hashValue(hash, snapshot.shapePlaced ? 1 : 0, 1);
+  hashValue(hash, snapshot.pendingGarbage, 1);
+  for(int i = 0; i < snapshot.pendingGarbage; i++)	// (the holes past them are left overs)
+  {
+    hashValue(hash, static_cast<std::uint8_t>(snapshot.garbageHoles[i]), 1);
+  }
+  return hash;
+}
+
+// a busy, repeatable set of buttons for game index to hold on a frame
+//   (mostly moving & rotating, a new set every 8 frames)
+InputMask TetrisEngine::autoplayButtons(int index, int frame)
+{
+  std::uint32_t h = static_cast<std::uint32_t>(frame / 8 + index * 7919) * 2654435761u;
+  h ^= h >> 15;
+  h *= 2246822519u;
+  h ^= h >> 13;
+  return static_cast<InputMask>(h & ALL_BUTTONS);
+}
+
+// mark the board's change journal as overflowed, so its consumers rescan
+//   (kept through the next step(), so consumers reading after it see it too)
+void TetrisEngine::invalidateBoardChanges()
+{
+  board.invalidateChanges();
+  boardChangesInvalidated = true;
+}
+
+// set a shape from a snapshot's fields (see restoreSnapshot())
+void TetrisEngine::restoreShape(GridTetromino &shape, std::uint8_t type, std::uint8_t rotation, int x, int y)
+{
+  shape.setShape(TetShape(type));
+  for(int i = 0; i < rotation; i++)
+  {
+    shape.rotateClockwise();
+  }
+  shape.setGridLoc(x, y);
+}
+
+// return the next value of the (xorshift32) shape generator
+std::uint32_t TetrisEngine::nextRandom()
+{
+  rngState ^= rngState << 13;
+  rngState ^= rngState >> 17;
+  rngState ^= rngState << 5;
+  return rngState;
+}
+
+// assign nextShape.setShape a new random shape
+void TetrisEngine::pickNextShape()
+{
+  nextShape.setShape(TetShape(nextRandom() % static_cast<std::uint32_t>(TetShape::COUNT)));
+}
+
+// copy the nextShape into the currentShape (through assignment)
+//   position the currentShape to its spawn location.
+//	 - return true/false based on isPositionLegal()
+bool TetrisEngine::spawnNextShape()
+{
+  currentShape = nextShape;
+  currentShape.setGridLoc(board.getSpawnLoc());
+  shapeCount++;
+
+  return isPositionLegal(currentShape);
+}
+
+// Test if a rotation is legal on the tetromino and if so, rotate it.
+//  To do this:
+//	 1) create a (local) temporary copy of the tetromino
+//	 2) rotate it (shape.rotateClockwise())
+//	 3) test if temp rotation was legal (isPositionLegal()),
+//      if so - rotate the original tetromino.
+//	 4) return true/false to indicate successful movement
+bool TetrisEngine::attemptRotate(GridTetromino &shape)
+{
+  GridTetromino tShape = shape;
+  tShape.rotateClockwise();
+
+  if(isPositionLegal(tShape))
+  {
+    shape.rotateClockwise();
+    return true;
+  }
+  return false;
+}
+
+// test if a move is legal on the tetromino, if so, move it.
+//  To do this:
+//	 1) create a (local) temporary copy of the tetromino
+//	 2) move it (temp.move())
+//	 3) test if temp move was legal (isPositionLegal(),
+//      if so - move the original.
+//	 4) return true/false to indicate successful movement
+bool TetrisEngine::attemptMove(GridTetromino &shape, int x, int y)
+{
+  GridTetromino tShape = shape;
+  tShape.move(x, y);
+  if(isPositionLegal(tShape))
+  {
+    shape.move(x, y);
+    return true;
+  }
+
+  return false;
+}
+
+// drops the tetromino vertically as far as it can
+//   legally go.  Use attemptMove(). This can be done in 1 line.
+void TetrisEngine::drop(GridTetromino &shape)
+{
+  while(attemptMove(shape, 0, 1)) { }
+}
+
+// copy the contents (color) of the tetromino's mapped block locs to the grid.
+//	 1) get current blockshape locs via tetromino.getBlockLocsMappedToGrid()
+//	 2) copy the content (color) to the grid (via gameboard.setContent())
+//   blocks still above the top of the board (when topping out) are not copied.
+//   GAME_EVENT_LOCKED happens if the board changed (not when a shape locked
+//   by DOWN / DROP is locked again by the next tick).
+void TetrisEngine::lock(const GridTetromino &shape)
+{
+  BlockLocs points = shape.getBlockLocsMappedToGrid();
+  bool changed = false;
+  for(Point p : points)
+  {
+    if(p.getY() >= 0 && board.getContent(p) != static_cast<int>(shape.getColor()))
+    {
+      board.setContent(p, static_cast<int>(shape.getColor()));
+      changed = true;
+    }
+  }
+  if(changed)
+  {
+    events |= GAME_EVENT_LOCKED;
+    lastLocked = shape;
+  }
+}
+
+// return true if shape is within borders (isShapeWithinBorders())
+//	 and the shape's mapped board locs are empty.
+//   Make use of Gameboard's areLocsEmpty() and pass it the shape's mapped locs.
+bool TetrisEngine::isPositionLegal(const GridTetromino &shape) const
+{
+  PROFILE_SCOPE("isPositionLegal");
+  if(isShapeWithinBorders(shape))
+  {
+    return board.areLocsEmpty(shape.getBlockLocsMappedToGrid());
+  }
+
+  return false;
+}
+
+// return true if the shape is within the left, right, and lower border of
+//	 the grid, but *NOT* the top border. (return false otherwise)
+//   * Ignore the upper border because we want shapes to be able to drop
+//     in from the top of the gameboard.
+//   All of a shape's blocks must be inside these 3 borders to return true
+bool TetrisEngine::isShapeWithinBorders(const GridTetromino &shape) const
+{
+  BlockLocs points = shape.getBlockLocsMappedToGrid();
+
+  for(Point p : points)
+  {
+    // valid Y point
+    if(p.getY() >= board.MAX_Y)
+    {
+      return false;
+    }
+    // valid X point
+    if(p.getX() >= board.MAX_X || p.getX() < 0)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// repeat the held buttons that are due this step() (after the presses)
+//   - the shift follows the most recently pressed of LEFT / RIGHT; releasing
+//     it hands over to the other one if that's still held (which charges
+//     its delay again)
+void TetrisEngine::autoRepeat(InputMask heldButtons, InputMask pressed)
+{
+  const InputMask shiftButtons = BUTTON_LEFT | BUTTON_RIGHT;
+  if(pressed & shiftButtons)
+  {
+    // (both at once: RIGHT was pressed last, see step())
+    shiftButton = (pressed & BUTTON_RIGHT) ? BUTTON_RIGHT : BUTTON_LEFT;
+    shiftHeldFrames = 0;
+  }
+  else if(shiftButton != 0 && (heldButtons & shiftButton))
+  {
+    shiftHeldFrames++;
+  }
+  else
+  {
+    shiftButton = heldButtons & shiftButtons;	// the other one, or none
+    shiftHeldFrames = 0;
+  }
+
+  const std::uint32_t delay = autoRepeatSettings.delayFrames;
+  const std::uint32_t interval = autoRepeatSettings.repeatFrames;
+  if(shiftButton != 0 && shiftHeldFrames >= delay)
+  {
+    int x = (shiftButton == BUTTON_LEFT) ? -1 : 1;
+    if(interval == 0)
+    {
+      while(attemptMove(currentShape, x, 0)) { }
+    }
+    else if((shiftHeldFrames - delay) % interval == 0)
+    {
+      attemptMove(currentShape, x, 0);
+    }
+  }
+
+  // soft drop: no delay, just a steady rate
+  if(!(heldButtons & BUTTON_DOWN) || (pressed & BUTTON_DOWN))
+  {
+    downHeldFrames = 0;
+  }
+  else if(++downHeldFrames % static_cast<std::uint32_t>(autoRepeatSettings.softDropFrames) == 0)
+  {
+    onButtonPressed(BUTTON_DOWN);
+  }
+}
+
+// raise the pending garbage rows (see queueGarbage())
+//   return false if that topped the board out (blocks were pushed off the
+//   top, or the falling shape no longer fits)
+bool TetrisEngine::raiseGarbage()
+{
+  // each run of rows with the same hole rises at once (the oldest ends up highest)
+  bool keptEverything = true;
+  for(int first = 0; first < pendingGarbage; )
+  {
+    int last = first;
+    while(last + 1 < pendingGarbage && garbageHoles[last + 1] == garbageHoles[first])
+    {
+      last++;
+    }
+    keptEverything = board.raiseRows(last - first + 1, GARBAGE_COLOR, garbageHoles[first]) && keptEverything;
+    first = last + 1;
+  }
+  pendingGarbage = 0;
+  return keptEverything && isPositionLegal(currentShape);
+}
+
+// set secsPerTick
+//   - basic: use MAX_SECS_PER_TICK
+//   - advanced: base it on score (higher score results in lower secsPerTick)
+void TetrisEngine::determineSecondsPerTick()
+{
+
+}
@@ -1,296 +1,369 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include "Profiler.h"
 #include "TetrisGame.h"
 
-TetrisGame::TetrisGame(sf::RenderWindow &window, sf::Sprite &blockSprite, Point gameboardOffset, Point nextShapeOffset)
-:gameboardOffset(gameboardOffset), nextShapeOffset(nextShapeOffset), window(window), blockSprite(blockSprite)
+TetrisGame::TetrisGame(sf::RenderWindow &window, sf::Sprite &blockSprite, Point gameboardOffset, Point nextShapeOffset,
+  ResourceCache &resources)
+:engine(static_cast<std::uint32_t>(rand())), gameboardOffset(gameboardOffset), view(gameboardOffset, nextShapeOffset, Point(54, 54)),
+ blockSprite(blockSprite), window(window)
 {
-  // setup our font for drawing the score
-  if(!scoreFont.loadFromFile("assets/fonts/RedOctober.ttf"))
+  // the board layer: one texture the size of the board
+  boardLayerCreated = boardLayer.create(Gameboard::MAX_X * BLOCK_WIDTH, Gameboard::MAX_Y * BLOCK_HEIGHT);
+  if(boardLayerCreated)
   {
-    // assert(false && "Missing font: RedOctober.ttf");
+    boardLayerSprite.setTexture(boardLayer.getTexture());
+    boardLayerSprite.setPosition(static_cast<float>(gameboardOffset.getX()), static_cast<float>(gameboardOffset.getY()));
   }
-  scoreText.setFont(scoreFont);
-  scoreText.setCharacterSize(24);
-  scoreText.setFillColor(sf::Color::White);
-  scoreText.setPosition(54, 54);
 
-  updateScoreDisplay();
+  // setup our font for drawing the score (the cache reports it if it's missing)
+  scoreFont = resources.getFont("assets/fonts/RedOctober.ttf");
+  renderer.setFont(scoreFont.get());
+  renderer.setTexture(TEXTURE_TILES, blockSprite.getTexture());
 
-  reset();
+  // size the lists & the batch for a full board up front, so frames don't allocate
+  drawList.reserve(GameView::MAX_GAME_QUADS, GameView::MAX_GAME_TEXTS);
+  boardList.reserve(GameView::MAX_GAME_QUADS, 0);
+  renderer.reserve(GameView::MAX_GAME_QUADS);
 }
 
 // Draw anything to do with the game,
 //   includes the board, currentShape, nextShape, score
-//   called every game loop
-void TetrisGame::draw()
+//   called every rendered frame.
+//   secondsAhead: how long after the last step() this frame is
+//   shown (the falling shape is drawn where it would be by then)
+void TetrisGame::draw(double secondsAhead)
 {
-  window.draw(scoreText);
-  drawTetromino(currentShape, gameboardOffset);
-  drawTetromino(nextShape, nextShapeOffset);
-  drawGameboard();
+  // changes from earlier steps of this frame are gone from the journal: redo it all
+  if(boardChangesMissed)
+  {
+    shaderBoard.invalidate();
+    boardLayerDirty = true;
+    boardChangesMissed = false;
+  }
+
+  // the locked blocks (only re-uploaded/rebuilt when the board changed)
+  lastDrawCalls = 0;
+  if(useShaderBoard)
+  {
+    shaderBoard.update(engine.getBoard());
+    shaderBoard.draw(window, gameboardOffset);
+    lastDrawCalls++;
+  }
+  else
+  {
+    updateBoardLayer();
+    lastDrawCalls += drawBoardLayer();
+  }
+
+  // the falling & next shapes (one batch) and the score
+  //   (after the coach's ghost & grade, if it's coaching)
+  drawList.clear();
+  if(coaching)
+  {
+    coach.pollAdvice(advice);
+    graded = coach.pollGrade(grade) || graded;
+    if(advice.found && advice.shapeNumber == engine.getShapeCount())	// (not the shape before's)
+    {
+      view.addGhost(drawList, advice.ghost);
+    }
+    if(graded)
+    {
+      view.addCoachGrade(drawList, grade);
+    }
+    view.addFinesse(drawList, finesse);
+  }
+  view.addPieces(drawList, engine, GameView::getFallOffset(engine, secondsAhead));
+  lastDrawCalls += renderer.render(drawList, window);
+
+  // which frame time travel is showing, over the board
+  if(timeTravelling)
+  {
+    char line[DrawText::MAX_LENGTH + 1];
+    std::snprintf(line, sizeof(line), "TIME TRAVEL  frame %u  (-%d of %d)", engine.getFrame(), travelAge, history.size() - 1);
+    travelLines.assign(1, line);
+    overlayList.clear();
+    GameView::addOverlay(overlayList, gameboardOffset, travelLines);
+    lastDrawCalls += renderer.render(overlayList, window);
+  }
+
+  // this frame's board changes have been seen
+  engine.clearBoardChanges();
+}
+
+// draw a debug overlay (lines of text, eg: statistics) over the top left
+//   of the window, in the score font.  Call it after draw().
+void TetrisGame::drawOverlay(const std::vector<std::string> &lines)
+{
+  overlayList.clear();
+  GameView::addOverlay(overlayList, Point(8, 8), lines);
+  renderer.render(overlayList, window);
 }
 
 // Event and game loop processing
-// handles keypress events (up, left, right, down, space)
+// handles window keypress events that aren't gameplay:
+//   F2 toggles the shader board render path
+//   F5 toggles coaching
+//   F7 toggles time travel, where Left / Right step a frame back / forward,
+//   and Down / Up a second
+// (the gameplay keys are read by the InputThread, see onInputEvent())
 void TetrisGame::onKeyPressed(sf::Event event)
 {
   switch(event.key.code)
   {
-    case sf::Keyboard::R: attemptRotate(currentShape); break; // Rotate
-    case sf::Keyboard::Left: attemptMove(currentShape, -1, 0); break; // Move left
-    case sf::Keyboard::Right: attemptMove(currentShape, 1, 0); break; // Move right
-    case sf::Keyboard::Down: if(!attemptMove(currentShape, 0, 1)) lock(currentShape); break; // Move down and lock if no further movement is possible
-    case sf::Keyboard::Space: drop(currentShape); lock(currentShape); break; // Drop and lock
+    case sf::Keyboard::F2: setShaderBoardRendering(!useShaderBoard); break; // switch board render path
+    case sf::Keyboard::F5: setCoaching(!coaching); break; // start/stop coaching
+    case sf::Keyboard::F7: setTimeTravel(!timeTravelling); break; // pause & rewind / resume
+    default: break;
   };
+
+  if(timeTravelling)
+  {
+    switch(event.key.code)
+    {
+      case sf::Keyboard::Left: travel(-1); break;
+      case sf::Keyboard::Right: travel(1); break;
+      case sf::Keyboard::Down: travel(-TetrisEngine::FRAMES_PER_SECOND); break;
+      case sf::Keyboard::Up: travel(TetrisEngine::FRAMES_PER_SECOND); break;
+      default: break;
+    };
+  }
 }
 
-// called every game loop to handle ticks & tetromino placement (locking)
-void TetrisGame::processGameLoop(float secondsSinceLastLoop)
+// handle a button press/release from the InputThread
+//   (call it before the step() the event happened in)
+void TetrisGame::onInputEvent(const InputEvent &event)
 {
-  secondsSinceLastTick += secondsSinceLastLoop;
-  if(secondsSinceLastTick >= secondsPerTick)
+  if(event.pressed)
   {
-    tick();
-    secondsSinceLastTick = 0.0;
+    heldButtons |= event.button;
+    tappedButtons |= event.button;
+  }
+  else
+  {
+    heldButtons &= ~event.button;
   }
 }
 
-// A tick() forces the currentShape to move (if there were no tick,
-// the currentShape would float in position forever). This should
-// call attemptMove() on the currentShape.  If not successful, lock()
-// the currentShape (it can move no further), and record the fact that a
-// shape was placed (using shapePlacedSinceLastGameLoop)
-void TetrisGame::tick()
+// hold exactly these buttons from now on (for scripted or bot players, instead
+//   of onInputEvent())
+void TetrisGame::setHeldButtons(InputMask buttons)
 {
-  if(!attemptMove(currentShape, 0, 1))
+  heldButtons = buttons;
+}
+
+// advance the game one fixed simulation step (TetrisEngine::SECONDS_PER_FRAME)
+//   with the buttons held (see TetrisEngine::step(), which also auto-repeats them)
+//   a button pressed & released since the last step is held for this one
+void TetrisGame::step()
+{
+  // paused (the buttons are still tracked, for when it resumes)
+  if(timeTravelling)
   {
-    lock(currentShape);
-    shapePlacedSinceLastGameLoop = true;
+    tappedButtons = 0;
+    return;
   }
-  if(shapePlacedSinceLastGameLoop)
+
+  // step() clears the journal, so note if the last step's changes weren't drawn
+  const Gameboard &board = engine.getBoard();
+  if(board.getChangeCount() > 0 || board.haveChangesOverflowed())
   {
-    if(!spawnNextShape())
-    {
-      reset();
-    }
-    else
-    {
-      pickNextShape();
+    boardChangesMissed = true;
+  }
 
-      int completedRows = board.removeCompletedRows();
-      score += completedRows * 2.25;
-      updateScoreDisplay();
+  InputMask buttons = heldButtons | tappedButtons;
+  engine.step(buttons);
+  tappedButtons = 0;
+  history.record(engine);
+  finesse.observe(engine, buttons);
 
-      determineSecondsPerTick();
-    }
+  if(coaching)
+  {
+    coach.observe(engine);
+  }
 
-    shapePlacedSinceLastGameLoop = false;
+  if(audio != nullptr)
+  {
+    audio->playEventEffects(engine.getEvents());
   }
 }
 
-// reset everything for a new game (use existing functions)
-//  - set the score to 0 and call updateScoreDisplay()
-//  - call determineSecondsPerTick() to determine the tick rate.
-//  - clear the gameboard,
-//  - pick & spawn next shape
-//  - pick next shape again (for the "on-deck" shape)
-void TetrisGame::reset()
+// force a tick on the engine (see TetrisEngine::tick())
+void TetrisGame::tick()
 {
-  score = 0;
-  updateScoreDisplay();
-  determineSecondsPerTick();
-
-  board.empty();
-
-  pickNextShape();
-  spawnNextShape();
-
-  pickNextShape();
+  engine.tick();
 }
 
-// assign nextShape.setShape a new random shape
-void TetrisGame::pickNextShape()
+// the gameplay state of this game
+const TetrisEngine& TetrisGame::getEngine() const
 {
-  nextShape.setShape(Tetromino::getRandomShape());
+  return engine;
 }
 
-// copy the nextShape into the currentShape (through assignment)
-//   position the currentShape to its spawn location.
-//	 - return true/false based on isPositionLegal()
-bool TetrisGame::spawnNextShape()
+TetrisEngine& TetrisGame::getEngine()
 {
-  currentShape = nextShape;
-  currentShape.setGridLoc(board.getSpawnLoc());
-
-  return isPositionLegal(currentShape);
+  return engine;
 }
 
-// Test if a rotation is legal on the tetromino and if so, rotate it.
-//  To do this:
-//	 1) create a (local) temporary copy of the tetromino
-//	 2) rotate it (shape.rotateClockwise())
-//	 3) test if temp rotation was legal (isPositionLegal()),
-//      if so - rotate the original tetromino.
-//	 4) return true/false to indicate successful movement
-bool TetrisGame::attemptRotate(GridTetromino &shape)
+// how held buttons auto-repeat (see AutoRepeatSettings)
+void TetrisGame::setAutoRepeat(const AutoRepeatSettings &settings)
 {
-  GridTetromino tShape = shape;
-  tShape.rotateClockwise();
+  engine.setAutoRepeat(settings);
+}
 
-  if(isPositionLegal(tShape))
-  {
-    shape.rotateClockwise();
-    return true;
-  }
-  return false;
+// play the game's sound effects on audio (nullptr: silent)
+void TetrisGame::setAudio(AudioSystem *newAudio)
+{
+  audio = newAudio;
 }
 
-// test if a move is legal on the tetromino, if so, move it.
-//  To do this:
-//	 1) create a (local) temporary copy of the tetromino
-//	 2) move it (temp.move())
-//	 3) test if temp move was legal (isPositionLegal(),
-//      if so - move the original.
-//	 4) return true/false to indicate successful movement
-bool TetrisGame::attemptMove(GridTetromino &shape, int x, int y)
+// draw the locked blocks with the ShaderBoardRenderer (one quad) instead of
+//   the cached board layer.
+//   return false (and keep the board layer) if shaders aren't available
+bool TetrisGame::setShaderBoardRendering(bool enabled)
 {
-  GridTetromino tShape = shape;
-  tShape.move(x, y);
-  if(isPositionLegal(tShape))
+  if(enabled && !shaderBoard.isCreated())
   {
-    shape.move(x, y);
-    return true;
+    const sf::Texture *tiles = blockSprite.getTexture();
+    if(tiles == nullptr || !shaderBoard.create(*tiles, BLOCK_WIDTH, BLOCK_HEIGHT))
+    {
+      useShaderBoard = false;
+      return false;
+    }
   }
 
-  return false;
+  // the path we switch to missed the changes drawn by the other one
+  shaderBoard.invalidate();
+  boardLayerDirty = true;
+  useShaderBoard = enabled;
+  return true;
 }
 
-// drops the tetromino vertically as far as it can
-//   legally go.  Use attemptMove(). This can be done in 1 line.
-void TetrisGame::drop(GridTetromino &shape)
+// the number of draw calls the last draw() made
+int TetrisGame::getLastDrawCalls() const
 {
-  int i = 1;
-  while(attemptMove(shape, 0, 1)) { i++; }
+  return lastDrawCalls;
 }
 
-// copy the contents (color) of the tetromino's mapped block locs to the grid.
-//	 1) get current blockshape locs via tetromino.getBlockLocsMappedToGrid()
-//	 2) copy the content (color) to the grid (via gameboard.setContent())
-void TetrisGame::lock(const GridTetromino &shape)
+// coach the player (see Coach): show where the falling shape should go as
+//   a ghost, and grade each shape locked (and its finesse, see
+//   FinesseTracker).  The search runs on the coach's own thread (started &
+//   stopped here).
+void TetrisGame::setCoaching(bool enabled)
 {
-  std::vector<Point> points = shape.getBlockLocsMappedToGrid();
-  for(Point p : points)
+  coaching = enabled;
+  advice.found = false;
+  graded = false;
+  if(enabled)
+  {
+    coach.start();
+    coach.observe(engine);	// (advise on the shape that's falling now)
+  }
+  else
   {
-    board.setContent(p, static_cast<int>(shape.getColor()));
+    coach.stop();
   }
 }
 
-// Graphics methods ==============================================
-
-// Draw a tetris block sprite on the canvas
-// The block position is specified in terms of 2 offsets:
-//    1) the top left (of the gameboard in pixels)
-//    2) an x & y offset into the gameboard - in blocks (not pixels)
-//       meaning they need to be multiplied by BLOCK_WIDTH and BLOCK_HEIGHT
-//       to get the pixel offset.
-//	 1) set the block color using blockSprite.setTextureRect()
-//   2) set the block location using blockSprite.setPosition()
-//	 3) draw the block using window.draw()
-//   For details/instructions on these 3 operations see:
-//       www.sfml-dev.org/tutorials/2.5/graphics-sprite.php
-//       use member variables: window and blockSprite (assigned in constructor)
-void TetrisGame::drawBlock(const Point &topLeft, int xOffset, int yOffset, TetColor color)
+bool TetrisGame::isCoaching() const
 {
-  int tetColorTextureOffset = static_cast<int>(color);
-  blockSprite.setTextureRect(sf::IntRect(BLOCK_WIDTH * tetColorTextureOffset, 0, BLOCK_WIDTH, BLOCK_HEIGHT));
-  blockSprite.setPosition((xOffset * BLOCK_WIDTH) + topLeft.getX(),  (yOffset * BLOCK_HEIGHT + topLeft.getY()));
-
-  window.draw(blockSprite);
+  return coaching;
 }
 
-// Draw the gameboard blocks on the window
-//   Iterate through each row & col, use drawBlock() to
-//   draw a block if it isn't empty.
-void TetrisGame::drawGameboard()
+// time travel (for debugging): pause the game, to step back & forth through
+//   the frames in its history (each one restored into the engine as it's
+//   shown).  Leaving it resumes the game from the frame shown, and forgets
+//   the frames after it.  step() does nothing while it's on.
+void TetrisGame::setTimeTravel(bool enabled)
 {
-  for(int y = 0; y < board.MAX_Y; y++)
+  if(enabled == timeTravelling)
+  {
+    return;
+  }
+  if(enabled)
   {
-    for(int x = 0; x < board.MAX_X; x++)
+    // (the frame showing now, if it's not recorded yet: eg: nothing has stepped)
+    if(history.size() == 0)
     {
-      if(board.getContent(x, y) != Gameboard::EMPTY_BLOCK)
-      {
-        drawBlock(gameboardOffset, x, y, TetColor(board.getContent(x, y)));
-      }
+      history.record(engine);
     }
+    travelAge = 0;
   }
-}
-
-// Draw a tetromino on the window
-//	 Iterate through each mapped loc & drawBlock() for each.
-//   The topLeft determines a 'base point' from which to calculate block offsets
-//      If the Tetromino is on the gameboard: use gameboardOffset
-void TetrisGame::drawTetromino(const GridTetromino &tetromino, const Point &topLeft)
-{
-  std::vector<Point> points = tetromino.getBlockLocsMappedToGrid();
-  for(Point p : points)
+  else
   {
-    drawBlock(topLeft, p.getX(), p.getY(), tetromino.getColor());
+    history.dropNewest(travelAge);
+    travelAge = 0;
+    if(coaching)
+    {
+      coach.observe(engine);	// (the shape falling now may not be the one it advised on)
+    }
   }
+  timeTravelling = enabled;
 }
 
-// update the score display
-// form a string "score: ##" to display the current score
-// user scoreText.setString() to display it.
-void TetrisGame::updateScoreDisplay()
+bool TetrisGame::isTimeTravelling() const
 {
-  std::string scoreString = "Score: " + std::to_string(score);
-  scoreText.setString(scoreString);
+  return timeTravelling;
 }
 
-// State & gameplay/logic methods ================================
-
-// return true if shape is within borders (isShapeWithinBorders())
-//	 and the shape's mapped board locs are empty.
-//   Make use of Gameboard's areLocsEmpty() and pass it the shape's mapped locs.
-bool TetrisGame::isPositionLegal(const GridTetromino &shape) const
+// show the frame frames on from the one shown (negative: back), as far as
+//   the history goes
+void TetrisGame::travel(int frames)
 {
-  if(isShapeWithinBorders(shape))
+  if(!timeTravelling)
   {
-    return board.areLocsEmpty(shape.getBlockLocsMappedToGrid());
+    return;
+  }
+  int age = std::max(0, std::min(travelAge - frames, history.size() - 1));
+  if(age != travelAge)
+  {
+    travelAge = age;
+    engine.restoreSnapshot(history.get(age));
   }
-
-  return false;
 }
 
-// return true if the shape is within the left, right, and lower border of
-//	 the grid, but *NOT* the top border. (return false otherwise)
-//   * Ignore the upper border because we want shapes to be able to drop
-//     in from the top of the gameboard.
-//   All of a shape's blocks must be inside these 3 borders to return true
-bool TetrisGame::isShapeWithinBorders(const GridTetromino &shape) const
-{
-  std::vector<Point> points = shape.getBlockLocsMappedToGrid();
+// Graphics methods ==============================================
 
-  for(Point p : points)
+// Rebuild the board layer (if the board changed since it was last built)
+//   The locked blocks only change when a shape locks or rows are removed,
+//   which the board's change journal tells us about.  So they are drawn
+//   into boardLayer once per change, rather than walked every frame.
+//   The blocks are listed in boardList by the GameView.
+void TetrisGame::updateBoardLayer()
+{
+  PROFILE_SCOPE("updateBoardLayer");
+  const Gameboard &board = engine.getBoard();
+  if(board.getChangeCount() > 0 || board.haveChangesOverflowed())
   {
-    // valid Y point
-    if(p.getY() >= board.MAX_Y)
-    {
-      return false;
-    }
-    // valid X point
-    if(p.getX() >= board.MAX_X || p.getX() < 0)
-    {
-      return false;
-    }
+    boardLayerDirty = true;
   }
+  if(!boardLayerDirty)
+  {
+    return;
+  }
+  boardLayerDirty = false;
 
-  return true;
+  boardList.clear();
+  view.addBoard(boardList, board, boardLayerCreated ? Point(0, 0) : gameboardOffset);
+  if(boardLayerCreated)
+  {
+    boardLayer.clear(sf::Color::Transparent);
+    renderer.render(boardList, boardLayer);
+    boardLayer.display();
+  }
 }
 
-// set secsPerTick
-//   - basic: use MAX_SECS_PER_TICK
-//   - advanced: base it on score (higher score results in lower secsPerTick)
-void TetrisGame::determineSecondsPerTick()
+// Draw the board layer on the window
+//   (draws boardList directly if the RenderTexture couldn't be created)
+//   return the number of draw calls it took
+int TetrisGame::drawBoardLayer()
 {
+  if(boardLayerCreated)
+  {
+    window.draw(boardLayerSprite);
+    return 1;
+  }
+  return renderer.render(boardList, window);
+}
 
-}
\ No newline at end of file
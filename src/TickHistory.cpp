@@ -0,0 +1,55 @@
+#include <algorithm>
+#include "TickHistory.h"
+
+// constructor
+//   capacity: the most snapshots kept (at least 1)
+TickHistory::TickHistory(int capacity)
+:snapshots(std::max(1, capacity))
+{
+}
+
+// save the engine's state as the newest snapshot (call it after each step())
+//   the oldest is dropped when the history is full
+void TickHistory::record(const TetrisEngine &engine)
+{
+  newest = (newest + 1) % getCapacity();
+  snapshots[newest] = engine.saveSnapshot();
+  count = std::min(count + 1, getCapacity());
+}
+
+// the snapshots kept, and the most there can be
+int TickHistory::size() const
+{
+  return count;
+}
+
+int TickHistory::getCapacity() const
+{
+  return static_cast<int>(snapshots.size());
+}
+
+// a snapshot by age: 0 is the newest, size() - 1 the oldest
+const EngineSnapshot& TickHistory::get(int age) const
+{
+  int index = (newest - age) % getCapacity();
+  return snapshots[index < 0 ? index + getCapacity() : index];
+}
+
+// drop the newest count snapshots (eg: resuming from an older one)
+void TickHistory::dropNewest(int dropped)
+{
+  dropped = std::max(0, std::min(dropped, count));
+  count -= dropped;
+  newest = (newest - dropped) % getCapacity();
+  if(newest < 0)
+  {
+    newest += getCapacity();
+  }
+}
+
+// drop them all
+void TickHistory::clear()
+{
+  newest = -1;
+  count = 0;
+}
@@ -0,0 +1,122 @@
+#include <algorithm>
+#include "WorkerPool.h"
+
+// constructor
+//   start threadCount - 1 workers (the thread calling run() is the other one)
+//   threadCount 0 means one per hardware thread; 1 runs every task on the caller
+WorkerPool::WorkerPool(int threadCount)
+{
+  if(threadCount <= 0)
+  {
+    threadCount = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+  }
+  for(int i = 1; i < threadCount; i++)
+  {
+    workers.push_back(std::thread(&WorkerPool::work, this));
+  }
+}
+
+// destructor: stop & join the workers
+WorkerPool::~WorkerPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  batchStarted.notify_all();
+  for(std::thread &worker : workers)
+  {
+    worker.join();
+  }
+}
+
+// run task(0) ... task(count - 1) on the pool, returning when all have finished
+void WorkerPool::run(int count, const std::function<void(int)> &newTask)
+{
+  if(count <= 0)
+  {
+    return;
+  }
+  if(workers.empty())
+  {
+    for(int i = 0; i < count; i++)
+    {
+      newTask(i);
+    }
+    return;
+  }
+
+  {
+    // (a worker that joined the last batch late must leave it before the
+    //   counter is reset, or it could claim one of our tasks for that batch)
+    std::unique_lock<std::mutex> lock(mutex);
+    batchDone.wait(lock, [this]() { return busyWorkers == 0; });
+    task = &newTask;
+    taskCount = count;
+    unfinishedTasks = count;
+    nextTask.store(0, std::memory_order_relaxed);
+    batch++;
+  }
+  batchStarted.notify_all();
+
+  runTasks(newTask, count);
+
+  std::unique_lock<std::mutex> lock(mutex);
+  batchDone.wait(lock, [this]() { return unfinishedTasks == 0; });
+  task = nullptr;
+}
+
+// the threads that run tasks (the workers & the caller)
+int WorkerPool::getThreadCount() const
+{
+  return static_cast<int>(workers.size()) + 1;
+}
+
+// a worker thread: run each batch's tasks until the pool is destroyed
+void WorkerPool::work()
+{
+  std::uint64_t joinedBatch = 0;
+  std::unique_lock<std::mutex> lock(mutex);
+  while(true)
+  {
+    batchStarted.wait(lock, [&]() { return stopping || (batch != joinedBatch && task != nullptr); });
+    if(stopping)
+    {
+      return;
+    }
+    joinedBatch = batch;
+    busyWorkers++;
+    const std::function<void(int)> &batchTask = *task;
+    int count = taskCount;
+    lock.unlock();
+
+    runTasks(batchTask, count);
+
+    lock.lock();
+    busyWorkers--;
+    if(busyWorkers == 0)
+    {
+      batchDone.notify_all();
+    }
+  }
+}
+
+// claim & run the current batch's tasks until there are none left
+void WorkerPool::runTasks(const std::function<void(int)> &batchTask, int count)
+{
+  int finished = 0;
+  for(int i = nextTask.fetch_add(1, std::memory_order_relaxed); i < count; i = nextTask.fetch_add(1, std::memory_order_relaxed))
+  {
+    batchTask(i);
+    finished++;
+  }
+  if(finished > 0)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    unfinishedTasks -= finished;
+    if(unfinishedTasks == 0)
+    {
+      batchDone.notify_all();
+    }
+  }
+}
@@ -0,0 +1,85 @@
+#include <SFML/Graphics/Image.hpp>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "AssetArchive.h"
+
+// Asset packer: packs asset files into one AssetArchive, which the game maps
+// at startup instead of opening & decoding each file (see AssetArchive.h).
+//   usage: assetpack <archive> <asset files...>
+// Each asset is stored under the path it was given (eg: assets/images/tiles.png),
+// which is the path the game asks the ResourceCache for.  Images (.png, .jpg,
+// .bmp) are decoded to RGBA pixels here, so the game doesn't decode them; the
+// rest are stored as they are.
+
+namespace
+{
+	bool isImage(const std::string &path)
+	{
+		std::string::size_type dot = path.find_last_of('.');
+		std::string extension = dot == std::string::npos ? "" : path.substr(dot + 1);
+		return extension == "png" || extension == "jpg" || extension == "jpeg" || extension == "bmp";
+	}
+
+	// add one file to the archive. return false if it couldn't be read
+	bool pack(AssetArchiveWriter &writer, const std::string &path)
+	{
+		if (isImage(path))
+		{
+			sf::Image image;
+			if (!image.loadFromFile(path))
+			{
+				return false;
+			}
+			sf::Vector2u size = image.getSize();
+			writer.add(path, image.getPixelsPtr(), static_cast<std::size_t>(size.x) * size.y * 4, ASSET_RGBA, size.x, size.y);
+			return true;
+		}
+
+		std::ifstream in(path, std::ios::binary);
+		if (!in)
+		{
+			return false;
+		}
+		std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		writer.add(path, bytes.data(), bytes.size());
+		return true;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 3)
+	{
+		std::cerr << "usage: assetpack <archive> <asset files...>\n";
+		return 2;
+	}
+
+	AssetArchiveWriter writer;
+	for (int i = 2; i < argc; i++)
+	{
+		if (!pack(writer, argv[i]))
+		{
+			std::cerr << "Could not read " << argv[i] << "\n";
+			return 1;
+		}
+	}
+	if (!writer.write(argv[1]))
+	{
+		std::cerr << "Could not write " << argv[1] << "\n";
+		return 1;
+	}
+
+	// check it reads back
+	AssetArchive archive;
+	if (!archive.open(argv[1]))
+	{
+		std::cerr << "Could not read back " << argv[1] << "\n";
+		return 1;
+	}
+	std::cout << "packed " << archive.getNames().size() << " assets into " << argv[1]
+		<< " (" << archive.getSize() / 1024 << " KB)\n";
+	return 0;
+}
@@ -0,0 +1,236 @@
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdlib.h>
+#include "GameView.h"
+#include "SoftwareRenderer.h"
+#include "TetrisEngine.h"
+
+// Desync detector: plays the same replay (a seed & a repeatable input script,
+// with garbage sent now and then) two ways, hashes the engine's state after
+// every step (TetrisEngine::getStateHash()) and reports the first frame the
+// hashes differ, with both boards side by side.
+//   usage: desync threads [frames=3600] [seed=1]   two engines on two threads
+//          desync render [frames=3600] [seed=1]    headless vs drawn every frame
+//          desync log <file> [frames=3600] [seed=1]  write this build's hashes
+//          desync compare <fileA> <fileB>          compare two builds' logs
+// Logging the same replay from two builds of the engine (eg: before & after
+// optimizing Gameboard) and comparing the logs proves they play the same.
+// Exits with 1 if the games desynced.
+
+namespace
+{
+	const int GARBAGE_EVERY = 600;	// frames between the garbage the script sends
+
+	// one step's result
+	struct Tick
+	{
+		std::uint64_t hash = 0;
+		EngineSnapshot snapshot;
+	};
+
+	// play the replay, hashing every step (drawing every frame as the game
+	//   does, if rendered: GameView reads the engine & the journal is cleared)
+	void play(std::uint32_t seed, int frames, bool rendered, std::vector<Tick> &ticks)
+	{
+		SoftwareRenderer renderer(rendered ? 640 : 1, rendered ? 800 : 1);
+		const GameView view(Point(54, 125), Point(490, 210), Point(54, 54));
+		DrawList list;
+
+		TetrisEngine engine(seed);
+		ticks.resize(frames);
+		for (int frame = 0; frame < frames; frame++)
+		{
+			if (frame % GARBAGE_EVERY == GARBAGE_EVERY - 1)
+			{
+				engine.queueGarbage(1 + frame / GARBAGE_EVERY % 3, frame / GARBAGE_EVERY % Gameboard::MAX_X);
+			}
+			engine.step(TetrisEngine::autoplayButtons(0, frame));
+			if (rendered)
+			{
+				list.clear();
+				view.addGame(list, engine);
+				renderer.clear(DrawColor());
+				renderer.render(list);
+				engine.clearBoardChanges();
+			}
+			ticks[frame].hash = engine.getStateHash();
+			ticks[frame].snapshot = engine.saveSnapshot();
+		}
+	}
+
+	// a cell of a snapshot's board (content + 1, 0: empty)
+	int cellOf(const EngineSnapshot &snapshot, int x, int y)
+	{
+		int cell = y * Gameboard::MAX_X + x;
+		return (cell % 2 == 0) ? (snapshot.cells[cell / 2] & 0x0F) : (snapshot.cells[cell / 2] >> 4);
+	}
+
+	// a board row as text: '.' empty, a color's letter (a-o), '@' the falling shape
+	std::string rowText(const EngineSnapshot &snapshot, int y)
+	{
+		TetrisEngine engine(1);
+		engine.restoreSnapshot(snapshot);
+		std::string row;
+		for (int x = 0; x < Gameboard::MAX_X; x++)
+		{
+			int cell = cellOf(snapshot, x, y);
+			row += (cell == 0) ? '.' : static_cast<char>('a' + cell - 1);
+		}
+		for (const Point &p : engine.getCurrentShape().getBlockLocsMappedToGrid())
+		{
+			if (p.getY() == y && p.getX() >= 0 && p.getX() < Gameboard::MAX_X)
+			{
+				row[p.getX()] = '@';
+			}
+		}
+		return row;
+	}
+
+	// print both boards side by side, the cells that differ marked in a third
+	void printBoards(const EngineSnapshot &a, const EngineSnapshot &b, const std::string &nameA, const std::string &nameB)
+	{
+		std::printf("  %-12s %-12s diff\n", nameA.c_str(), nameB.c_str());
+		for (int y = 0; y < Gameboard::MAX_Y; y++)
+		{
+			std::string rowA = rowText(a, y);
+			std::string rowB = rowText(b, y);
+			std::string diff;
+			for (int x = 0; x < Gameboard::MAX_X; x++)
+			{
+				diff += (rowA[x] == rowB[x]) ? ' ' : '*';
+			}
+			std::printf("  %-12s %-12s %s\n", rowA.c_str(), rowB.c_str(), diff.c_str());
+		}
+		std::printf("  shape %d rot %d at %d,%d   shape %d rot %d at %d,%d\n", a.currentShape, a.currentRotation,
+			a.currentX, a.currentY, b.currentShape, b.currentRotation, b.currentX, b.currentY);
+	}
+
+	// report the first frame two runs' hashes differ. return false if they did
+	bool compare(const std::vector<Tick> &a, const std::vector<Tick> &b, const std::string &nameA, const std::string &nameB)
+	{
+		std::size_t frames = std::min(a.size(), b.size());
+		for (std::size_t frame = 0; frame < frames; frame++)
+		{
+			if (a[frame].hash == b[frame].hash)
+			{
+				continue;
+			}
+			std::printf("DESYNC at frame %zu: %s %016" PRIx64 ", %s %016" PRIx64 "\n", frame + 1, nameA.c_str(), a[frame].hash,
+				nameB.c_str(), b[frame].hash);
+			if (frame > 0)
+			{
+				std::printf("(the frame before matched: %016" PRIx64 ")\n", a[frame - 1].hash);
+			}
+			printBoards(a[frame].snapshot, b[frame].snapshot, nameA, nameB);
+			return false;
+		}
+		if (a.size() != b.size())
+		{
+			std::printf("%zu frames matched, but one run has %zu and the other %zu\n", frames, a.size(), b.size());
+			return false;
+		}
+		std::printf("%zu frames matched (last hash %016" PRIx64 ")\n", frames, frames > 0 ? a.back().hash : 0);
+		return true;
+	}
+
+	// a log: a line a frame of hash, board cells (hex) & the falling shape
+	bool writeLog(const std::string &path, const std::vector<Tick> &ticks)
+	{
+		std::ofstream out(path);
+		for (const Tick &tick : ticks)
+		{
+			char line[2 * EngineSnapshot::CELL_BYTES + 64];
+			int length = std::snprintf(line, sizeof(line), "%016" PRIx64 " ", tick.hash);
+			for (std::uint8_t cells : tick.snapshot.cells)
+			{
+				length += std::snprintf(line + length, sizeof(line) - length, "%02x", cells);
+			}
+			std::snprintf(line + length, sizeof(line) - length, " %d %d %d %d", tick.snapshot.currentShape,
+				tick.snapshot.currentRotation, tick.snapshot.currentX, tick.snapshot.currentY);
+			out << line << "\n";
+		}
+		return static_cast<bool>(out);
+	}
+
+	bool readLog(const std::string &path, std::vector<Tick> &ticks)
+	{
+		std::ifstream in(path);
+		std::string hash, cells;
+		int shape, rotation, x, y;
+		while (in >> hash >> cells >> shape >> rotation >> x >> y)
+		{
+			if (cells.size() != 2 * EngineSnapshot::CELL_BYTES)
+			{
+				return false;
+			}
+			Tick tick;
+			tick.hash = std::strtoull(hash.c_str(), nullptr, 16);
+			for (int i = 0; i < EngineSnapshot::CELL_BYTES; i++)
+			{
+				tick.snapshot.cells[i] = static_cast<std::uint8_t>(std::stoul(cells.substr(2 * i, 2), nullptr, 16));
+			}
+			tick.snapshot.currentShape = static_cast<std::uint8_t>(shape);
+			tick.snapshot.currentRotation = static_cast<std::uint8_t>(rotation);
+			tick.snapshot.currentX = static_cast<std::int8_t>(x);
+			tick.snapshot.currentY = static_cast<std::int8_t>(y);
+			ticks.push_back(tick);
+		}
+		return in.eof();
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	std::string mode = argc > 1 ? argv[1] : "";
+	std::vector<Tick> a, b;
+
+	if (mode == "compare" && argc > 3)
+	{
+		if (!readLog(argv[2], a) || !readLog(argv[3], b))
+		{
+			std::cerr << "Could not read " << argv[2] << " and " << argv[3] << "\n";
+			return 1;
+		}
+		return compare(a, b, "A", "B") ? 0 : 1;
+	}
+
+	int argFrames = (mode == "log") ? 3 : 2;
+	int frames = argc > argFrames ? std::max(1, atoi(argv[argFrames])) : 3600;
+	std::uint32_t seed = argc > argFrames + 1 ? static_cast<std::uint32_t>(atoi(argv[argFrames + 1])) : 1;
+
+	if (mode == "threads")
+	{
+		std::thread other([&]() { play(seed, frames, false, b); });
+		play(seed, frames, false, a);
+		other.join();
+		return compare(a, b, "main", "thread") ? 0 : 1;
+	}
+	if (mode == "render")
+	{
+		play(seed, frames, false, a);
+		play(seed, frames, true, b);
+		return compare(a, b, "headless", "rendered") ? 0 : 1;
+	}
+	if (mode == "log" && argc > 2)
+	{
+		play(seed, frames, false, a);
+		if (!writeLog(argv[2], a))
+		{
+			std::cerr << "Could not write " << argv[2] << "\n";
+			return 1;
+		}
+		std::printf("%d frames logged to %s (last hash %016" PRIx64 ")\n", frames, argv[2], a.back().hash);
+		return 0;
+	}
+
+	std::cerr << "usage: desync threads|render [frames] [seed]\n"
+		"       desync log <file> [frames] [seed]\n"
+		"       desync compare <fileA> <fileB>\n";
+	return 1;
+}
@@ -0,0 +1,91 @@
+#include <SFML/Graphics/Image.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <stdlib.h>
+#include "GameView.h"
+#include "SoftwareRenderer.h"
+#include "TetrisEngine.h"
+
+// Headless frame export: plays a game with a repeatable input script and writes
+// frames drawn by the SoftwareRenderer (no display or GPU needed).
+//   usage: framedump [frames=600] [every=10] [outDir=frames] [ppm|png] [seed=1]
+// Prints how long drawing a frame took on average (the draw list + rasterizing,
+// not the file writing), which is a reproducible measure of render cost.
+
+namespace
+{
+	// give the renderer an image from disk. return false if it couldn't be loaded
+	bool loadTexture(SoftwareRenderer &renderer, DrawTextureId id, const std::string &path)
+	{
+		sf::Image image;
+		if (!image.loadFromFile(path))
+		{
+			return false;
+		}
+		renderer.setTexture(id, image.getPixelsPtr(), image.getSize().x, image.getSize().y);
+		return true;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	int frameCount = argc > 1 ? atoi(argv[1]) : 600;
+	int every = argc > 2 ? std::max(1, atoi(argv[2])) : 10;
+	std::string outDir = argc > 3 ? argv[3] : "frames";
+	bool png = argc > 4 && std::string(argv[4]) == "png";
+	std::uint32_t seed = argc > 5 ? static_cast<std::uint32_t>(atoi(argv[5])) : 1;
+
+	// the same window size & layout as the game (see main.cpp)
+	SoftwareRenderer renderer(640, 800);
+	if (!loadTexture(renderer, TEXTURE_TILES, "assets/images/tiles.png") ||
+		!loadTexture(renderer, TEXTURE_BACKGROUND, "assets/images/background.png"))
+	{
+		std::cerr << "Could not load the images in assets/images\n";
+		return 1;
+	}
+	const GameView view(Point(54, 125), Point(490, 210), Point(54, 54));
+
+	DrawRect screen;
+	screen.width = 640;
+	screen.height = 800;
+	DrawColor white;
+
+	TetrisEngine engine(seed);
+	DrawList list;
+	double drawSeconds = 0;
+	int framesDrawn = 0;
+	for (int frame = 0; frame < frameCount; frame++)
+	{
+		engine.step(TetrisEngine::autoplayButtons(0, frame));
+		if (frame % every != 0)
+		{
+			continue;
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		list.clear();
+		list.addTexturedQuad(TEXTURE_BACKGROUND, screen, screen);
+		view.addGame(list, engine);
+		renderer.clear(white);
+		renderer.render(list);
+		drawSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		framesDrawn++;
+
+		char name[32];
+		std::snprintf(name, sizeof(name), "/frame_%05d.%s", frame, png ? "png" : "ppm");
+		bool written = png ? renderer.writePNG(outDir + name) : renderer.writePPM(outDir + name);
+		if (!written)
+		{
+			std::cerr << "Could not write " << outDir << name << " (does the directory exist?)\n";
+			return 1;
+		}
+	}
+
+	std::cout << framesDrawn << " frames written to " << outDir << ", "
+		<< (framesDrawn > 0 ? drawSeconds * 1000 / framesDrawn : 0) << "ms to draw each ("
+		<< list.countBatches() << " batches in the last)\n";
+	return 0;
+}
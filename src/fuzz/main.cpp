@@ -0,0 +1,283 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include "BitBoard.h"
+#include "Gameboard.h"
+#include "GridTetromino.h"
+#include "PlacementSearch.h"
+
+// Differential fuzzer: plays random sequences of board operations on the
+// reference Gameboard and the optimized BitBoard, and checks after every one
+// that they agree (the results, and every cell & row mask of the boards).
+// An input's bytes are read as operations: setContent, areLocsEmpty,
+// removeCompletedRows, empty, raiseRows, and a falling piece's
+// spawn / move / rotate / drop (checked with the engine's rule, then locked).
+//   usage: fuzz [seconds=10] [seed=1]       random inputs for a while
+//          fuzz <file> ...                  run saved inputs (eg: a crash)
+// Prints the operations checked per second.  A disagreement is printed, the
+// input is saved as fuzz-crash.bin, and the fuzzer aborts.
+//
+// Built with -DFUZZ_LIBFUZZER (make fuzz-libfuzzer, clang only) there's no
+// main(): libFuzzer calls LLVMFuzzerTestOneInput() with its own inputs.
+
+namespace
+{
+	const std::size_t MAX_INPUT_BYTES = 1024;	// the random inputs' size limit
+
+	// the input being run (saved if the boards disagree)
+	const std::uint8_t *inputData = nullptr;
+	std::size_t inputSize = 0;
+	std::uint64_t operations = 0;			// checked so far (in every input)
+	std::uint64_t inputOperations = 0;	// operations before the input being run
+
+	// an input's bytes, read in order (0s once it runs out)
+	class ByteReader
+	{
+	public:
+		ByteReader(const std::uint8_t *data, std::size_t size) : data(data), size(size) {}
+		bool isDone() const { return next >= size; }
+		int read() { return next < size ? data[next++] : 0; }
+		// a value in [low, high]
+		int read(int low, int high) { return low + read() % (high - low + 1); }
+	private:
+		const std::uint8_t *data;
+		std::size_t size;
+		std::size_t next = 0;
+	};
+
+	// report a disagreement & stop (abort, so libFuzzer saves the input too)
+	void fail(const char *what)
+	{
+		std::fprintf(stderr, "MISMATCH in %s, operation %llu of the input\n", what,
+			static_cast<unsigned long long>(operations - inputOperations));
+		std::ofstream out("fuzz-crash.bin", std::ios::binary);
+		out.write(reinterpret_cast<const char *>(inputData), static_cast<std::streamsize>(inputSize));
+		out.close();	// (abort() doesn't flush it)
+		std::fprintf(stderr, "the input was saved as fuzz-crash.bin (%zu bytes)\n", inputSize);
+		std::abort();
+	}
+
+	void check(bool same, const char *what)
+	{
+		if (!same)
+		{
+			fail(what);
+		}
+	}
+
+	// every cell & row mask the same?
+	bool isSameBoard(const Gameboard &reference, const BitBoard &optimized)
+	{
+		for (int y = 0; y < Gameboard::MAX_Y; y++)
+		{
+			if (reference.getRowMask(y) != optimized.getRowMask(y))
+			{
+				return false;
+			}
+			for (int x = 0; x < Gameboard::MAX_X; x++)
+			{
+				if (reference.getContent(x, y) != optimized.getContent(x, y))
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	// a board content: EMPTY_BLOCK or a color (empty a quarter of the time)
+	int readContent(ByteReader &in)
+	{
+		int content = in.read();
+		return (content % 4 == 0) ? Gameboard::EMPTY_BLOCK : content % 8;
+	}
+
+	// lock the piece where it is on both boards (as the engine does)
+	void lock(Gameboard &reference, BitBoard &optimized, const GridTetromino &piece)
+	{
+		for (const Point &p : piece.getBlockLocsMappedToGrid())
+		{
+			if (p.getY() >= 0)
+			{
+				reference.setContent(p.getX(), p.getY(), static_cast<int>(piece.getColor()));
+				optimized.setContent(p.getX(), p.getY(), static_cast<int>(piece.getColor()));
+			}
+		}
+	}
+}
+
+// run one input (libFuzzer's entry point)
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t *data, std::size_t size)
+{
+	inputData = data;
+	inputSize = size;
+	inputOperations = operations;
+	ByteReader in(data, size);
+	Gameboard reference;
+	BitBoard optimized;
+	GridTetromino piece;
+	piece.setGridLoc(reference.getSpawnLoc());
+
+	while (!in.isDone())
+	{
+		operations++;
+		switch (in.read() % 10)
+		{
+			case 0:	// setContent
+			case 1:
+			{
+				int x = in.read(0, Gameboard::MAX_X - 1);
+				int y = in.read(0, Gameboard::MAX_Y - 1);
+				int content = readContent(in);
+				reference.setContent(x, y, content);
+				optimized.setContent(x, y, content);
+				break;
+			}
+			case 2:	// fill most of a row (so rows get completed)
+			{
+				int y = in.read(0, Gameboard::MAX_Y - 1);
+				int holeX = in.read(0, Gameboard::MAX_X + 5);	// (often no hole)
+				for (int x = 0; x < Gameboard::MAX_X; x++)
+				{
+					int content = (x == holeX) ? Gameboard::EMPTY_BLOCK : x % 7;
+					reference.setContent(x, y, content);
+					optimized.setContent(x, y, content);
+				}
+				break;
+			}
+			case 3:	// areLocsEmpty (the points may be off the grid)
+			{
+				BlockLocs locs;
+				int count = in.read(0, static_cast<int>(BlockLocs::MAX_BLOCKS));
+				for (int i = 0; i < count; i++)
+				{
+					locs.push_back(Point(in.read(-3, Gameboard::MAX_X + 2), in.read(-3, Gameboard::MAX_Y + 2)));
+				}
+				check(reference.areLocsEmpty(locs) == optimized.areLocsEmpty(locs), "areLocsEmpty");
+				break;
+			}
+			case 4:	// removeCompletedRows
+				check(reference.removeCompletedRows() == optimized.removeCompletedRows(), "removeCompletedRows");
+				break;
+			case 5:	// empty (now and then: boards should fill up)
+				if (in.read() < 16)
+				{
+					reference.empty();
+					optimized.empty();
+				}
+				break;
+			case 6:	// raiseRows (garbage)
+			{
+				int count = in.read(0, 4);
+				int content = readContent(in);
+				int holeX = in.read(-1, Gameboard::MAX_X);
+				check(reference.raiseRows(count, content, holeX) == optimized.raiseRows(count, content, holeX), "raiseRows");
+				break;
+			}
+			case 7:	// spawn a piece, anywhere near the board
+				piece.setShape(TetShape(in.read() % TetShape::COUNT));
+				piece.setGridLoc(in.read(-3, Gameboard::MAX_X + 2), in.read(-3, Gameboard::MAX_Y + 2));
+				break;
+			case 8:	// move or rotate the piece, if it's legal
+			{
+				GridTetromino moved = piece;
+				int move = in.read() % 4;
+				if (move == 3)
+				{
+					moved.rotateClockwise();
+				}
+				else
+				{
+					moved.move(move - 1, move == 1 ? 1 : 0);	// left, down, right
+				}
+				bool legal = PlacementSearch::isLegal(reference, moved);
+				check(legal == optimized.fits(moved.getBlockLocsMappedToGrid()), "fits (move/rotate)");
+				check(reference.areLocsEmpty(moved.getBlockLocsMappedToGrid()) == optimized.areLocsEmpty(moved.getBlockLocsMappedToGrid()),
+					"areLocsEmpty (move/rotate)");
+				if (legal)
+				{
+					piece = moved;
+				}
+				break;
+			}
+			case 9:	// drop the piece, lock it & clear rows (if it's somewhere legal)
+			{
+				bool legal = PlacementSearch::isLegal(reference, piece);
+				check(legal == optimized.fits(piece.getBlockLocsMappedToGrid()), "fits (drop)");
+				if (!legal)
+				{
+					break;
+				}
+				GridTetromino lower = piece;
+				lower.move(0, 1);
+				while (optimized.fits(lower.getBlockLocsMappedToGrid()))
+				{
+					check(PlacementSearch::isLegal(reference, lower), "fits (falling)");
+					piece = lower;
+					lower.move(0, 1);
+				}
+				check(!PlacementSearch::isLegal(reference, lower), "fits (landed)");
+				lock(reference, optimized, piece);
+				check(reference.removeCompletedRows() == optimized.removeCompletedRows(), "removeCompletedRows (drop)");
+				piece.setGridLoc(reference.getSpawnLoc());
+				break;
+			}
+		}
+		check(isSameBoard(reference, optimized), "the boards");
+	}
+	return 0;
+}
+
+#ifndef FUZZ_LIBFUZZER
+int main(int argc, char *argv[])
+{
+	// saved inputs
+	if (argc > 1 && std::atof(argv[1]) == 0)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			std::ifstream file(argv[i], std::ios::binary);
+			std::vector<std::uint8_t> input((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+			LLVMFuzzerTestOneInput(input.data(), input.size());
+		}
+		std::cout << argc - 1 << " inputs run, " << operations << " operations checked: no mismatches\n";
+		return 0;
+	}
+
+	// random inputs, until the time is up
+	double seconds = argc > 1 ? std::atof(argv[1]) : 10;
+	std::uint32_t rngState = argc > 2 ? static_cast<std::uint32_t>(std::atoi(argv[2])) : 1;
+	rngState = (rngState != 0) ? rngState : 1;	// (xorshift32 gets stuck on 0)
+	std::vector<std::uint8_t> input(MAX_INPUT_BYTES);
+	std::uint64_t inputs = 0;
+	auto start = std::chrono::steady_clock::now();
+	double elapsed = 0;
+	while (elapsed < seconds)
+	{
+		for (int batch = 0; batch < 64; batch++, inputs++)
+		{
+			rngState ^= rngState << 13;
+			rngState ^= rngState >> 17;
+			rngState ^= rngState << 5;
+			std::size_t size = 1 + rngState % MAX_INPUT_BYTES;
+			for (std::size_t i = 0; i < size; i++)
+			{
+				rngState ^= rngState << 13;
+				rngState ^= rngState >> 17;
+				rngState ^= rngState << 5;
+				input[i] = static_cast<std::uint8_t>(rngState >> 24);
+			}
+			LLVMFuzzerTestOneInput(input.data(), size);
+		}
+		elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+	std::cout << inputs << " inputs, " << operations << " operations checked in " << elapsed << "s ("
+		<< static_cast<std::uint64_t>(operations / elapsed) << " operations/s): no mismatches\n";
+	return 0;
+}
+#endif
@@ -0,0 +1,202 @@
+#include <SFML/Network.hpp>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <stdlib.h>
+#include "GameRoom.h"
+#include "GameServer.h"
+#include "ServerProtocol.h"
+
+// Load test for the GameServer: spawns thousands of simulated players over loopback.
+//   usage: loadtest [players=2000] [seconds=10] [basePort=54000] [workers=0] [host]
+//   With no host, a GameServer is started in this process so its load can be measured.
+//
+// Every player joins room (playerIndex / 2), then sends its held buttons every
+// frame at 60Hz, following the frame numbers in the server's MSG_STATE messages.
+
+namespace
+{
+	const int PLAYERS_PER_SOCKET = 64;		// simulated players sharing one client socket
+
+	struct SimulatedPlayer
+	{
+		sf::Uint32 roomId;
+		sf::Uint32 token = 0;
+		bool joined = false;
+		sf::Uint32 frame = 0;		// the frame this player sends input for next
+	};
+}
+
+int main(int argc, char *argv[])
+{
+	std::size_t playerCount = argc > 1 ? atoi(argv[1]) : 2000;
+	float seconds = argc > 2 ? static_cast<float>(atof(argv[2])) : 10.0f;
+	unsigned short basePort = argc > 3 ? static_cast<unsigned short>(atoi(argv[3])) : 54000;
+	int workerCount = argc > 4 ? atoi(argv[4]) : 0;
+	sf::IpAddress host = argc > 5 ? sf::IpAddress(argv[5]) : sf::IpAddress::LocalHost;
+
+	// start an in-process server unless a remote host was given
+	std::unique_ptr<GameServer> server;
+	if (argc <= 5)
+	{
+		server.reset(new GameServer(basePort, workerCount));
+		if (!server->start())
+		{
+			std::cerr << "Could not start the server on port " << basePort << "\n";
+			return 1;
+		}
+		workerCount = server->getWorkerCount();
+	}
+	if (workerCount <= 0)
+	{
+		std::cerr << "The worker count of a remote server must be given\n";
+		return 1;
+	}
+
+	// set up the players & their sockets
+	std::vector<SimulatedPlayer> players(playerCount);
+	std::vector<std::unique_ptr<sf::UdpSocket>> sockets((playerCount + PLAYERS_PER_SOCKET - 1) / PLAYERS_PER_SOCKET);
+	for (auto &socket : sockets)
+	{
+		socket.reset(new sf::UdpSocket());
+		socket->bind(sf::Socket::AnyPort);
+		socket->setBlocking(false);
+	}
+	for (std::size_t i = 0; i < playerCount; i++)
+	{
+		players[i].roomId = static_cast<sf::Uint32>(i / GameRoom::PLAYER_COUNT);
+	}
+
+	sf::Uint64 statesReceived = 0;
+	sf::Uint64 rejectsReceived = 0;
+	sf::Packet packet;
+	sf::IpAddress sender;
+	unsigned short senderPort;
+
+	// drain every socket, handling JOINED / STATE / REJECT replies
+	auto receiveAll = [&]()
+	{
+		for (std::size_t s = 0; s < sockets.size(); s++)
+		{
+			while (sockets[s]->receive(packet, sender, senderPort) == sf::Socket::Done)
+			{
+				sf::Uint8 type;
+				packet >> type;
+				if (type == MSG_JOINED)
+				{
+					sf::Uint32 roomId, token, nonce;
+					sf::Uint8 slot;
+					if (packet >> roomId >> token >> slot >> nonce && nonce < playerCount)
+					{
+						players[nonce].token = token;
+						players[nonce].joined = true;
+					}
+				}
+				else if (type == MSG_STATE)
+				{
+					sf::Uint32 roomId, frame;
+					if (packet >> roomId >> frame)
+					{
+						// follow the server's clock for both players of the room
+						for (std::size_t i = roomId * GameRoom::PLAYER_COUNT; i < (roomId + 1) * GameRoom::PLAYER_COUNT && i < playerCount; i++)
+						{
+							players[i].frame = frame;
+						}
+					}
+					statesReceived++;
+				}
+				else if (type == MSG_REJECT)
+				{
+					rejectsReceived++;
+				}
+			}
+		}
+	};
+
+	auto sendTo = [&](std::size_t i, sf::Packet &message)
+	{
+		unsigned short port = static_cast<unsigned short>(basePort + players[i].roomId % workerCount);
+		sockets[i / PLAYERS_PER_SOCKET]->send(message, host, port);
+	};
+
+	// join phase: (re-)send joins until everyone is in a room
+	sf::Clock clock;
+	std::size_t joinedCount = 0;
+	while (joinedCount < playerCount && clock.getElapsedTime() < sf::seconds(10))
+	{
+		for (std::size_t i = 0; i < playerCount; i++)
+		{
+			if (!players[i].joined)
+			{
+				sf::Packet join;
+				join << sf::Uint8(MSG_JOIN) << players[i].roomId << sf::Uint32(i);
+				sendTo(i, join);
+			}
+		}
+		sf::sleep(sf::milliseconds(200));
+		receiveAll();
+
+		joinedCount = 0;
+		for (const SimulatedPlayer &player : players)
+		{
+			joinedCount += player.joined ? 1 : 0;
+		}
+	}
+	std::cout << joinedCount << "/" << playerCount << " players joined in "
+		<< clock.getElapsedTime().asSeconds() << "s\n";
+
+	// play phase: send every player's buttons at 60Hz
+	ServerStats before = server ? server->getStats() : ServerStats();
+	const sf::Time frameTime = sf::seconds(static_cast<float>(TetrisEngine::SECONDS_PER_FRAME));
+	sf::Uint64 inputsSent = 0;
+	clock.restart();
+	sf::Time nextFrame = sf::Time::Zero;
+	while (clock.getElapsedTime() < sf::seconds(seconds))
+	{
+		for (std::size_t i = 0; i < playerCount; i++)
+		{
+			if (players[i].joined)
+			{
+				sf::Packet input;
+				input << sf::Uint8(MSG_INPUT) << players[i].token << players[i].frame << sf::Uint8(TetrisEngine::autoplayButtons(static_cast<int>(i), static_cast<int>(players[i].frame)));
+				sendTo(i, input);
+				players[i].frame++;
+				inputsSent++;
+			}
+		}
+		receiveAll();
+
+		nextFrame += frameTime;
+		sf::Time now = clock.getElapsedTime();
+		if (nextFrame > now)
+		{
+			sf::sleep(nextFrame - now);
+		}
+	}
+	float elapsed = clock.getElapsedTime().asSeconds();
+
+	std::cout << inputsSent << " inputs sent, " << statesReceived << " states & "
+		<< rejectsReceived << " rejects received in " << elapsed << "s\n";
+
+	if (server)
+	{
+		ServerStats after = server->getStats();
+		server->stop();
+
+		double roomFrames = static_cast<double>(after.roomFramesStepped - before.roomFramesStepped);
+		double busy = (after.busySeconds - before.busySeconds) / (elapsed * workerCount);
+		double roomsPerWorker = static_cast<double>(after.rooms) / workerCount;
+		double capacity = busy > 0 ? roomsPerWorker / busy : 0.0;
+
+		std::cout << after.rooms << " rooms on " << workerCount << " workers stepped at "
+			<< roomFrames / elapsed / after.rooms << " Hz, "
+			<< after.inputsAccepted - before.inputsAccepted << " inputs accepted, "
+			<< after.inputsRejected - before.inputsRejected << " rejected\n";
+		std::cout << "workers " << static_cast<int>(busy * 100) << "% busy: ~" << static_cast<int>(capacity)
+			<< " rooms per core at 60Hz (target " << GameServer::TARGET_ROOMS_PER_CORE << ")\n";
+
+		return capacity >= GameServer::TARGET_ROOMS_PER_CORE ? 0 : 2;
+	}
+	return 0;
+}
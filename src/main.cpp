@@ -1,89 +1,494 @@
 #include <SFML/Graphics.hpp>
+#include <algorithm>
 #include <iostream>
+#include <cstdio>
+#include <fstream>
+#include "AllocationCounter.h"
+#include "AssetArchive.h"
+#include "AudioSystem.h"
+#include "BattleRoyale.h"
+#include "FrameScheduler.h"
+#include "GameView.h"
+#include "InputThread.h"
+#include "LatencyHistogram.h"
+#include "MinimapAtlas.h"
+#include "Profiler.h"
+#include "ResourceCache.h"
+#include "SfmlDrawListRenderer.h"
+#include "SessionHost.h"
 #include "TetrisGame.h"
 #include "TestSuite.h"
 
 #include <stdlib.h>
+#include <string>
 #include <time.h>
 
-int main()
+// the time on the clock, in seconds (the InputEvent timestamps use the same)
+static double secondsOn(const sf::Clock &clock)
+{
+	return clock.getElapsedTime().asMicroseconds() / 1e6;
+}
+
+// show a splash screen (a progress bar) until resources has finished preloading
+//   return false if the window was closed meanwhile
+static bool showSplashScreen(sf::RenderWindow &window, ResourceCache &resources)
+{
+	const sf::Vector2f barSize{ 400, 24 };
+	const sf::Vector2f barPosition{ (window.getSize().x - barSize.x) / 2, (window.getSize().y - barSize.y) / 2 };
+	sf::RectangleShape frame(barSize);
+	frame.setPosition(barPosition);
+	frame.setFillColor(sf::Color::Transparent);
+	frame.setOutlineColor(sf::Color::White);
+	frame.setOutlineThickness(2);
+	sf::RectangleShape bar;
+	bar.setPosition(barPosition);
+	bar.setFillColor(sf::Color::White);
+
+	while (resources.isPreloading())
+	{
+		sf::Event event;
+		while (window.pollEvent(event))
+		{
+			if (event.type == sf::Event::Closed)
+			{
+				window.close();
+				return false;
+			}
+		}
+		bar.setSize({ barSize.x * resources.getPreloadProgress(), barSize.y });
+		window.clear(sf::Color::Black);
+		window.draw(frame);
+		window.draw(bar);
+		window.display();
+	}
+	resources.waitForPreload();
+	return true;
+}
+
+// the battle royale's panel, right of the game: its status, then every
+//   player's minimap (MINIMAP_COLUMNS to a row, each pixel MINIMAP_SCALE pixels)
+static const int ROYALE_PANEL_WIDTH = 360;
+static const int MINIMAP_COLUMNS = 10;
+static const int MINIMAP_SCALE = 3;
+
+// redraw the royale's minimaps on atlas (the human's target in red), and
+//   add them & the human's status to list at topLeft
+static void addRoyalePanel(DrawList &list, const Point &topLeft, const BattleRoyale &royale, MinimapAtlas &atlas)
+{
+	const int human = BattleRoyale::HUMAN;
+	for (int player = 0; player < royale.getPlayerCount(); player++)
+	{
+		MinimapMark mark = !royale.isAlive(player) ? MINIMAP_KNOCKED_OUT
+			: (player == royale.getTarget(human) ? MINIMAP_TARGET : MINIMAP_PLAYING);
+		atlas.update(player, royale.getEngine(player).getBoard(), mark);
+	}
+
+	char lines[4][DrawText::MAX_LENGTH + 1];
+	std::snprintf(lines[0], sizeof(lines[0]), "%d of %d left", royale.getAliveCount(), royale.getPlayerCount());
+	if (royale.getPlacement(human) == 1)
+	{
+		std::snprintf(lines[1], sizeof(lines[1]), "you won!");
+	}
+	else if (royale.isAlive(human))
+	{
+		std::snprintf(lines[1], sizeof(lines[1]), "target: player %d", royale.getTarget(human));
+	}
+	else
+	{
+		std::snprintf(lines[1], sizeof(lines[1]), "placed #%d", royale.getPlacement(human));
+	}
+	std::snprintf(lines[2], sizeof(lines[2]), "knockouts: %d", royale.getKnockouts(human));
+	std::snprintf(lines[3], sizeof(lines[3]), "incoming: %d rows", royale.getEngine(human).getPendingGarbage());
+	const DrawColor white{ 255, 255, 255, 255 };
+	for (int i = 0; i < 4; i++)
+	{
+		list.addText(static_cast<float>(topLeft.getX()), static_cast<float>(topLeft.getY() + i * 28), 20, white, lines[i]);
+	}
+
+	DrawRect dest;
+	dest.left = static_cast<float>(topLeft.getX());
+	dest.top = static_cast<float>(topLeft.getY() + 130);
+	dest.width = static_cast<float>(atlas.getWidth() * MINIMAP_SCALE);
+	dest.height = static_cast<float>(atlas.getHeight() * MINIMAP_SCALE);
+	GameView::addMinimaps(list, dest, atlas);
+}
+
+// the packed assets (make pack), used instead of assets/ when they're there
+static const char *const DEFAULT_ASSET_ARCHIVE = "assets.pak";
+
+// usage: main [--uncapped] [--latency-report file] [--trace file] [--count-allocations]
+//   [--assets archive] [--games count] [--royale [bots]] [--coach]
+//   the game renders at the display's refresh rate (vsync), or as fast as it
+//   can with --uncapped.  Either way it is simulated at a fixed 60 steps/second.
+//   The input-to-photon latency histograms are written to the latency report
+//   file on exit (F3 shows them on screen).
+//   Profiling builds (make profile) write a Chrome trace of the frames' phases
+//   to the trace file on exit (F4 shows the phase times on screen).
+//   --count-allocations adds the heap allocations per frame, by phase, to the
+//   console report (a steady-state frame should make none).
+//   --assets maps another asset archive than assets.pak.
+//   --games runs that many games side by side in the window: the keyboard plays
+//   the first, and the rest autoplay (see SessionHost).
+//   --royale plays a battle royale against that many bots (99 by default),
+//   with their minimaps beside the game (see BattleRoyale).
+//   --coach shows where each shape should go and grades where it went (see
+//   Coach; F5 toggles it).
+int main(int argc, char *argv[])
 {	
+	bool uncapped = false;
+	std::string latencyReportPath;
+	std::string tracePath;
+	bool countAllocations = false;
+	std::string assetArchivePath = DEFAULT_ASSET_ARCHIVE;
+	int gameCount = 1;
+	int royaleBots = 0;
+	bool coaching = false;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--uncapped")
+		{
+			uncapped = true;
+		}
+		else if (arg == "--latency-report" && i + 1 < argc)
+		{
+			latencyReportPath = argv[++i];
+		}
+		else if (arg == "--trace" && i + 1 < argc)
+		{
+			tracePath = argv[++i];
+		}
+		else if (arg == "--count-allocations")
+		{
+			countAllocations = true;
+		}
+		else if (arg == "--assets" && i + 1 < argc)
+		{
+			assetArchivePath = argv[++i];
+		}
+		else if (arg == "--games" && i + 1 < argc)
+		{
+			gameCount = std::max(1, atoi(argv[++i]));
+		}
+		else if (arg == "--coach")
+		{
+			coaching = true;
+		}
+		else if (arg == "--royale")
+		{
+			royaleBots = 99;
+			if (i + 1 < argc && argv[i + 1][0] != '-')
+			{
+				royaleBots = std::max(1, atoi(argv[++i]));
+			}
+		}
+	}
+
 	// seeding rand
 	srand(time(NULL));
 
 	// run some sanity tests on our classes to ensure they're working as expected.
 	TestSuite::runTestSuite();
 
-	sf::Sprite blockSprite;			// the tetromino block sprite
-	sf::Texture blockTexture;		// the tetromino block texture
-	sf::Sprite backgroundSprite;	// the background sprite
-	sf::Texture backgroundTexture;	// the background texture
+	// create the game window
+	//   (one game's size, or smaller games in a grid that fits the screen;
+	//   a battle royale is one game, with its panel beside it)
+	if (royaleBots > 0)
+	{
+		gameCount = 1;
+	}
+	const sf::VideoMode desktop = sf::VideoMode::getDesktopMode();
+	const sf::Vector2u windowSize = royaleBots > 0
+		? sf::Vector2u(SessionHost::GAME_WIDTH + ROYALE_PANEL_WIDTH, SessionHost::GAME_HEIGHT)
+		: SessionHost::getWindowSize(gameCount, sf::Vector2u(desktop.width * 9 / 10, desktop.height * 9 / 10));
+	sf::RenderWindow window(sf::VideoMode(windowSize.x, windowSize.y), "Tetris Game Window");	
+	
+	window.setVerticalSyncEnabled(!uncapped);	// render at the display's rate (unless uncapped)
 
-	// load images
-	backgroundTexture.loadFromFile("assets/images/background.png");// load the background sprite
-	backgroundSprite.setTexture(backgroundTexture);
+	// load the assets (once: every game shares them) in the background, behind a splash screen
+	//   (from the packed archive, if there is one: make pack)
+	ResourceCache resources;
+	std::shared_ptr<AssetArchive> archive = std::make_shared<AssetArchive>();
+	if (archive->open(assetArchivePath))
+	{
+		resources.setArchive(archive);
+	}
+	else if (assetArchivePath != DEFAULT_ASSET_ARCHIVE)
+	{
+		std::cout << "couldn't open the asset archive " << assetArchivePath << ", loading assets/ instead\n";
+	}
+	resources.preload({ "assets/images/background.png", "assets/images/tiles.png", "assets/fonts/RedOctober.ttf",
+		"assets/sfx/blockDrop.ogg", "assets/sfx/blockRotate.ogg", "assets/sfx/levelUp.ogg", "assets/sfx/gameOver.ogg" });
+	if (!showSplashScreen(window, resources))
+	{
+		return 0;	// closed while loading
+	}
 
-	blockTexture.loadFromFile("assets/images/tiles.png");	// load the tetris block sprite
-	blockSprite.setTexture(blockTexture);	
+	sf::Sprite blockSprite;			// the tetromino block sprite
+	sf::Sprite backgroundSprite;	// the background sprite
 
-	// create the game window
-	sf::RenderWindow window(sf::VideoMode(640, 800), "Tetris Game Window");	
-	
-	window.setFramerateLimit(30);				// set a max framerate of 30 FPS
+	// the textures (the cache keeps them alive)
+	std::shared_ptr<const sf::Texture> backgroundTexture = resources.getTexture("assets/images/background.png");
+	if (backgroundTexture != nullptr)
+	{
+		backgroundSprite.setTexture(*backgroundTexture);
+	}
+	std::shared_ptr<const sf::Texture> blockTexture = resources.getTexture("assets/images/tiles.png");
+	if (blockTexture != nullptr)
+	{
+		blockSprite.setTexture(*blockTexture);
+	}
 
 	const Point gameboardOffset{ 54, 125 };		// the pixel offset of the top left of the gameboard 
 	const Point nextShapeOffset{ 490, 210 };	// the pixel offset of the next shape Tetromino
 
-	// set up a tetris game
-	TetrisGame game(window, blockSprite, gameboardOffset, nextShapeOffset);
+	// set up the tetris games: the keyboard plays the first, the rest autoplay
+	//   (they all step in parallel, on the pool)
+	WorkerPool pool;
+	const float gameArea = static_cast<float>(SessionHost::GAME_WIDTH) / windowSize.x;
+	SessionHost host(window, blockSprite, backgroundSprite, gameboardOffset, nextShapeOffset, resources, pool, gameCount,
+		sf::FloatRect(0, 0, royaleBots > 0 ? gameArea : 1, 1));
+	for (int i = 1; i < host.getGameCount(); i++)
+	{
+		host.setAutoplay(i, true);
+	}
+	TetrisGame &game = host.getGame(0);
+	game.setCoaching(coaching);
+
+	// the battle royale (if there is one): the bots step on the pool too, and
+	//   every minimap is one texture (updated each frame), drawn in one call
+	std::unique_ptr<BattleRoyale> royale;
+	std::unique_ptr<MinimapAtlas> minimaps;
+	sf::Texture minimapTexture;
+	DrawList royaleList;
+	SfmlDrawListRenderer royaleRenderer;
+	std::shared_ptr<const sf::Font> royaleFont = resources.getFont("assets/fonts/RedOctober.ttf");
+	if (royaleBots > 0)
+	{
+		royale.reset(new BattleRoyale(&game.getEngine(), royaleBots, static_cast<std::uint32_t>(rand()), pool));
+		minimaps.reset(new MinimapAtlas(royale->getPlayerCount(), MINIMAP_COLUMNS));
+		minimapTexture.create(minimaps->getWidth(), minimaps->getHeight());
+		royaleRenderer.setTexture(TEXTURE_MINIMAPS, &minimapTexture);
+		royaleRenderer.setFont(royaleFont.get());
+	}
+
+	// get every sound up front, and play them on the audio thread
+	AudioSystem audio;
+	if (!audio.load(resources, "assets/sfx"))
+	{
+		std::cout << "some sounds in assets/sfx couldn't be loaded\n";
+	}
+	audio.start();
+	audio.playMusic();
+	game.setAudio(&audio);
 
-	// set up a clock so we can determine seconds per game loop
+	for (const std::string &failure : resources.getFailures())
+	{
+		std::cout << "missing asset: " << failure << "\n";
+	}
+
+	// set up a clock & a scheduler to run the game in fixed steps, however fast we render
 	sf::Clock clock;		
+	FrameScheduler scheduler;
+	sf::Clock reportClock;	// for reporting the frame times every few seconds
+
+	// read the keyboard on its own thread, timestamped on the same clock
+	InputThread input(clock);
+	input.start();
+	InputThread::Queue &inputEvents = input.getQueue();
+
+	// time each press from the input thread to the screen
+	LatencyTracker latency;
+	bool showLatency = false;
+	std::vector<std::string> latencyLines;
+
+#ifdef TETRIS_PROFILE
+	// where the frame time goes (the PROFILE_SCOPE()s)
+	Profiler &profiler = Profiler::global();
+	bool showProfile = false;
+	std::vector<std::string> profileLines;
+#endif
 
 	// create an event for handling userInput from the GUI (graphical user interface)
 	sf::Event guiEvent;	
 
+	// count the allocations from here on (the setup above allocates, as it should)
+	AllocationCounter::reset();
+	AllocationCounter::setEnabled(countAllocations);
+
 	// the main game loop
 	while (window.isOpen())
 	{
-		// handle any window or keyboard events that have occured since the last game loop
-		while (window.pollEvent(guiEvent))
+		// handle any window events that have occured since the last game loop
 		{
-			if (guiEvent.type == sf::Event::Closed)	// handle close button clicked
+			PROFILE_SCOPE("poll events");
+			AllocationScope allocationScope("poll events");
+			while (window.pollEvent(guiEvent))
 			{
-				window.close();
+				if (guiEvent.type == sf::Event::Closed)	// handle close button clicked
+				{
+					window.close();
+				}
+				else if (guiEvent.type == sf::Event::GainedFocus || guiEvent.type == sf::Event::LostFocus)
+				{
+					input.setFocused(guiEvent.type == sf::Event::GainedFocus);	// only read the keys while we have focus
+				}
+				else if (guiEvent.type == sf::Event::KeyPressed && guiEvent.key.code == sf::Keyboard::F3)
+				{
+					showLatency = !showLatency;	// toggle the latency overlay
+				}
+#ifdef TETRIS_PROFILE
+				else if (guiEvent.type == sf::Event::KeyPressed && guiEvent.key.code == sf::Keyboard::F4)
+				{
+					showProfile = !showProfile;	// toggle the profiler overlay
+				}
+#endif
+				else if (guiEvent.type == sf::Event::KeyPressed) // handle (non gameplay) key press
+				{
+					game.onKeyPressed(guiEvent);	
+				}
+			}
+		}
+
+		// how many fixed steps the time since the last frame pays for
+		int steps = scheduler.beginFrame(secondsOn(clock));
+
+		// run them, applying each input event on the step it happened in
+		// (events after the last step wait for the next frame's steps)
+		{
+			PROFILE_SCOPE("simulate");
+			AllocationScope allocationScope("simulate");
+			double stepEnd = scheduler.getSimulatedTime() - (steps - 1) * scheduler.getStepSeconds();
+			for (int step = 0; step < steps; step++, stepEnd += scheduler.getStepSeconds())
+			{
+				while (inputEvents.front() != nullptr && inputEvents.front()->time <= stepEnd)
+				{
+					const InputEvent &event = *inputEvents.front();
+					game.onInputEvent(event);
+					if (event.pressed)
+					{
+						latency.onApplied(event.time, secondsOn(clock));
+					}
+					inputEvents.popFront();
+				}
+				host.step();	// handle tetris game logic in here (every game's).
+				if (royale != nullptr)
+				{
+					royale->setPaused(game.isTimeTravelling());	// (the human's game is paused: so is the match)
+					royale->step();	// the bots, knockouts & garbage
+				}
+			}
+		}
+
+		// Draw the game to the screen (the falling shape where it is by now, between steps)
+		{
+			PROFILE_SCOPE("draw");
+			AllocationScope allocationScope("draw");
+			window.clear(sf::Color::White);	// clear the entire window
+			host.draw(scheduler.getAlpha() * scheduler.getStepSeconds());	// draw the games & their backgrounds (onto the window)
+			if (royale != nullptr)
+			{
+				royaleList.clear();
+				DrawRect panel;
+				panel.left = SessionHost::GAME_WIDTH;
+				panel.width = ROYALE_PANEL_WIDTH;
+				panel.height = SessionHost::GAME_HEIGHT;
+				royaleList.addRect(panel, DrawColor{ 16, 16, 24, 255 });
+				addRoyalePanel(royaleList, Point(SessionHost::GAME_WIDTH + 15, 20), *royale, *minimaps);
+				minimapTexture.update(minimaps->getPixels());
+				royaleRenderer.render(royaleList, window);
+			}
+			if (showLatency)
+			{
+				latencyLines.clear();
+				latencyLines.push_back("latency (ms)     p50    p99    max");
+				const LatencyHistogram *stages[] = { &latency.getInputToApply(), &latency.getApplyToPresent(), &latency.getInputToPresent() };
+				const char *stageNames[] = { "input-apply", "apply-present", "input-present" };
+				for (int i = 0; i < 3; i++)
+				{
+					char line[DrawText::MAX_LENGTH + 1];
+					std::snprintf(line, sizeof(line), "%-14s %6.1f %6.1f %6.1f", stageNames[i], stages[i]->getPercentileSeconds(0.50) * 1000,
+						stages[i]->getPercentileSeconds(0.99) * 1000, stages[i]->getMaxSeconds() * 1000);
+					latencyLines.push_back(line);
+				}
+				game.drawOverlay(latencyLines);
 			}
-			else if (guiEvent.type == sf::Event::KeyPressed) // handle key press
+#ifdef TETRIS_PROFILE
+			if (showProfile)
 			{
-				game.onKeyPressed(guiEvent);	
+				profiler.getPhaseLines(profileLines);
+				profileLines.insert(profileLines.begin(), "phase (ms/frame)        mean     max");
+				game.drawOverlay(profileLines);
 			}
+#endif
 		}
+		{
+			PROFILE_SCOPE("display");
+			AllocationScope allocationScope("display");
+			window.display();				// re-display the entire window
+		}
+		latency.onPresented(secondsOn(clock));	// the presses applied so far are on screen
 
-		// how long since the last loop (fraction of a second)		
-		float elapsedTime = clock.getElapsedTime().asSeconds();
-		clock.restart();		
+#ifdef TETRIS_PROFILE
+		// this frame's samples (from every thread)
+		profiler.collect();
+		profiler.endFrame();
+#endif
 
-		// handle any window or keyboard events that have occured since the last game loop
-		sf::Event event;
-		while (window.pollEvent(event))
+		// report the frame pacing every 5 seconds
+		if (reportClock.getElapsedTime().asSeconds() >= 5)
 		{
-			if (event.type == sf::Event::Closed)
+			FrameStats stats = scheduler.getStats();
+			std::cout << stats.frames / reportClock.restart().asSeconds() << " fps, frame time "
+				<< stats.meanFrameSeconds * 1000 << "ms +/- " << stats.jitterSeconds * 1000 << "ms jitter (max "
+				<< stats.maxFrameSeconds * 1000 << "ms), " << stats.droppedSteps << " steps dropped\n"
+				<< latency.getInputToPresent().getSummary("input to present latency") << "\n";
+			if (host.getGameCount() > 1)
 			{
-				window.close();
+				std::cout << host.getGameCount() << " games stepped in " << host.getLastStepSeconds() * 1000 << "ms on "
+					<< pool.getThreadCount() << " threads\n";
 			}
-			else if (event.type == sf::Event::KeyPressed)
+			if (countAllocations && stats.frames > 0)
 			{
-				game.onKeyPressed(event);	// handle key press
+				const char *names[AllocationCounter::MAX_SUBSYSTEMS];
+				std::uint64_t counts[AllocationCounter::MAX_SUBSYSTEMS];
+				int subsystems = AllocationCounter::getSubsystemCounts(names, counts, AllocationCounter::MAX_SUBSYSTEMS);
+				std::cout << static_cast<double>(AllocationCounter::getCount()) / stats.frames << " allocations/frame";
+				for (int i = 0; i < subsystems; i++)
+				{
+					std::cout << (i == 0 ? " (" : ", ") << names[i] << " " << static_cast<double>(counts[i]) / stats.frames;
+				}
+				std::cout << (subsystems > 0 ? ")\n" : "\n");
+				AllocationCounter::reset();
 			}
+			scheduler.resetStats();
 		}
+	}
 
-		game.processGameLoop(elapsedTime);	// handle tetris game logic in here.
+#ifdef TETRIS_PROFILE
+	// dump the trace
+	if (!tracePath.empty())
+	{
+		std::ofstream trace(tracePath);
+		profiler.writeChromeTrace(trace);
+		std::cout << profiler.getTraceSize() << " samples traced (" << profiler.getDroppedSamples() << " dropped)\n";
+	}
+#else
+	if (!tracePath.empty())
+	{
+		std::cout << "no trace written: this isn't a profiling build (make profile)\n";
+	}
+#endif
 
-		// Draw the game to the screen
-		window.clear(sf::Color::White);	// clear the entire window
-		window.draw(backgroundSprite);	// draw the background (onto the window)
-		game.draw();					// draw the game (onto the window)
-		window.display();				// re-display the entire window
+	// dump the latency histograms
+	if (!latencyReportPath.empty())
+	{
+		std::ofstream report(latencyReportPath);
+		latency.writeReport(report);
+		if (!report)
+		{
+			std::cout << "couldn't write the latency report to " << latencyReportPath << "\n";
+		}
 	}
 	
 	return 0;
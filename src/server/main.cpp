@@ -0,0 +1,34 @@
+#include <SFML/System.hpp>
+#include <iostream>
+#include <stdlib.h>
+#include "GameServer.h"
+
+// Headless authoritative game server.
+//   usage: server [basePort=54000] [workers=0 (one per hardware thread)]
+int main(int argc, char *argv[])
+{
+	unsigned short basePort = argc > 1 ? static_cast<unsigned short>(atoi(argv[1])) : 54000;
+	int workerCount = argc > 2 ? atoi(argv[2]) : 0;
+
+	GameServer server(basePort, workerCount);
+	if (!server.start())
+	{
+		std::cerr << "Could not bind ports " << basePort << "-" << basePort + server.getWorkerCount() - 1 << "\n";
+		return 1;
+	}
+	std::cout << "Serving on ports " << basePort << "-" << basePort + server.getWorkerCount() - 1
+		<< " with " << server.getWorkerCount() << " workers\n";
+
+	// report load every 5 seconds
+	while (true)
+	{
+		sf::sleep(sf::seconds(5));
+		ServerStats stats = server.getStats();
+		double busy = stats.elapsedSeconds > 0 ? stats.busySeconds / (stats.elapsedSeconds * server.getWorkerCount()) : 0.0;
+		std::cout << stats.rooms << " rooms, " << stats.players << " players, "
+			<< stats.inputsAccepted << " inputs accepted, " << stats.inputsRejected << " rejected, "
+			<< static_cast<int>(busy * 100) << "% busy\n";
+	}
+
+	return 0;
+}
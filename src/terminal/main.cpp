@@ -0,0 +1,79 @@
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <time.h>
+#include "TerminalInput.h"
+#include "TerminalRenderer.h"
+#include "TetrisEngine.h"
+
+// Text-mode frontend: plays a game in the terminal (eg: over SSH).
+//   usage: terminal
+//   keys: arrows move (up rotates), r rotates, space drops, q quits
+// The game runs at TetrisEngine::FRAMES_PER_SECOND; each frame only the
+// characters that changed are sent to the terminal.
+
+int main()
+{
+	TerminalInput input;
+	if (!input.isRaw())
+	{
+		std::cerr << "stdin is not a terminal: the keyboard can't be read\n";
+		return 1;
+	}
+
+	TetrisEngine engine(static_cast<std::uint32_t>(time(NULL)));
+	TerminalRenderer renderer;
+	std::string update;
+	std::size_t bytesSent = 0;
+	long frames = 0;
+
+	const auto frameTime = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+		std::chrono::duration<double>(TetrisEngine::SECONDS_PER_FRAME));
+	auto nextFrame = std::chrono::steady_clock::now();
+	bool running = true;
+	while (running)
+	{
+		// handle the keys pressed since the last frame
+		TerminalKey keys[TerminalInput::MAX_KEYS];
+		int keyCount = input.readKeys(keys);
+		for (int i = 0; i < keyCount; i++)
+		{
+			switch (keys[i])
+			{
+			case KEY_LEFT: engine.onButtonPressed(BUTTON_LEFT); break;
+			case KEY_RIGHT: engine.onButtonPressed(BUTTON_RIGHT); break;
+			case KEY_DOWN: engine.onButtonPressed(BUTTON_DOWN); break;
+			case KEY_UP: case KEY_ROTATE: engine.onButtonPressed(BUTTON_ROTATE); break;
+			case KEY_SPACE: engine.onButtonPressed(BUTTON_DROP); break;
+			case KEY_QUIT: running = false; break;
+			default: break;
+			}
+		}
+
+		engine.processGameLoop(static_cast<float>(TetrisEngine::SECONDS_PER_FRAME));
+		engine.clearBoardChanges();
+
+		// send only what changed
+		renderer.compose(engine);
+		update.clear();
+		renderer.writeUpdate(update);
+		if (!update.empty())
+		{
+			std::fwrite(update.data(), 1, update.size(), stdout);
+			std::fflush(stdout);
+		}
+		bytesSent += update.size();
+		frames++;
+
+		nextFrame += frameTime;
+		std::this_thread::sleep_until(nextFrame);
+	}
+
+	std::string restore = TerminalRenderer::getRestoreSequence();
+	std::fwrite(restore.data(), 1, restore.size(), stdout);
+	std::cout << "Score: " << engine.getScore() << " (" << frames << " frames, "
+		<< (frames > 0 ? static_cast<double>(bytesSent) / frames : 0) << " bytes per frame sent)\n";
+	return 0;
+}
@@ -28,6 +28,7 @@ void Tetromino::setShape(TetShape shape)
 {
     this->shape = shape;                                          // set shape
     this->color = static_cast<TetColor>(static_cast<int>(shape)); // set color
+    this->rotation = 0;                                           // spawn orientation
     // clear old blockLocks
     blockLocs.clear();
 
@@ -90,6 +91,12 @@ void Tetromino::rotateClockwise()
         blockLocs[i].swapXY();
         blockLocs[i].multiplyY(-1);
     }
+    rotation = (rotation + 1) % 4;
+}
+
+int Tetromino::getRotation() const
+{
+    return rotation;
 }
 
 void Tetromino::printToConsole() const